@@ -0,0 +1,12 @@
+#include "bench.hpp"
+
+void AddOrgraphBenchmarks( ds::bench::runner& runner );
+void AddVector2dBenchmarks( ds::bench::runner& runner );
+
+int main( int argc, char **argv )
+{
+    ds::bench::runner runner( argc, argv );
+    AddOrgraphBenchmarks( runner );
+    AddVector2dBenchmarks( runner );
+    return runner.run();
+}
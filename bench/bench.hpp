@@ -0,0 +1,468 @@
+/**
+ * Small benchmark harness.
+ */
+#pragma once
+
+/****************************************************************************************/
+
+/**
+ * Benchmark is function f( state& ) with timed loop:
+ *      runner.add( "vector2d/iterate/n:1024", []( ds::bench::state& st )
+ *                  {
+ *                      ... setup is not timed ...
+ *                      while ( st.keep_running() )
+ *                      {
+ *                          ... timed work ...
+ *                      }
+ *                      st.set_items_processed( st.iterations() * items_of_one_iteration );
+ *                  } );
+ * Work which should not be timed inside the loop (e.g. rebuilding graph) goes
+ * between st.pause_timing() and st.resume_timing(). Results which compiler
+ * could throw away are passed to do_not_optimize().
+ *
+ * Number of iterations grows until run takes at least --min-time, then run
+ * is repeated --repetitions times, median time of iteration is reported.
+ *
+ * Options of runner:
+ *      --filter=TEXT       - runs only benchmarks whose names contain TEXT;
+ *      --min-time=SECONDS  - minimal time of run, 0.2 by default;
+ *      --repetitions=N     - runs of every benchmark, 3 by default;
+ *      --json=FILE         - writes results as JSON to FILE ("-" is stdout);
+ *      --baseline=FILE     - compares with JSON of earlier run;
+ *      --threshold=PERCENT - run() returns 1 if some benchmark is slower than
+ *                            baseline by more than PERCENT, 10 by default.
+ * It is enough for tracking regressions: keep JSON of release, run new build with
+ * --baseline and look at exit code.
+ */
+
+/****************************************************************************************/
+
+#include <vector>
+#include <string>
+#include <map>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <fstream>
+#include <ctime>
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/****************************************************************************************/
+
+namespace ds
+{
+    namespace bench
+    {
+        /********************************************************************************/
+        
+        /**
+         * Keeps value, so computation of it is not removed by optimizer.
+         */
+        template <typename T>
+        inline void do_not_optimize( T& value )
+        {
+#if defined( __GNUC__ ) || defined( __clang__ )
+            asm volatile( "" : : "r,m"( value ) : "memory" );
+#else
+            volatile auto copy = value;
+            (void)copy;
+#endif
+        }
+        
+        template <typename T>
+        inline void do_not_optimize( const T& value )
+        {
+#if defined( __GNUC__ ) || defined( __clang__ )
+            asm volatile( "" : : "r,m"( value ) : "memory" );
+#else
+            volatile auto copy = value;
+            (void)copy;
+#endif
+        }
+        
+        /********************************************************************************/
+        
+        class state
+        {
+            using clock = std::chrono::steady_clock;
+            
+            int64_t m_iterations;
+            int64_t m_done    = 0;
+            bool    m_started = false;
+            bool    m_paused  = false;
+            int64_t m_items   = 0;
+            
+            clock::time_point m_start;
+            clock::duration   m_elapsed = clock::duration::zero();
+        
+        public:
+            explicit state( int64_t iterations ) : m_iterations( iterations ) {}
+            
+            /**
+             * Condition of timed loop: starts timer on first call, stops it after last iteration.
+             */
+            bool keep_running()
+            {
+                if ( !m_started )
+                {
+                    m_started = true;
+                    m_start = clock::now();
+                }
+                if ( m_done < m_iterations )
+                {
+                    m_done++;
+                    return true;
+                }
+                if ( !m_paused )
+                {
+                    m_elapsed += clock::now() - m_start;
+                    m_paused = true;
+                }
+                return false;
+            }
+            
+            void pause_timing()
+            {
+                if ( !m_paused )
+                {
+                    m_elapsed += clock::now() - m_start;
+                    m_paused = true;
+                }
+                return;
+            }
+            
+            void resume_timing()
+            {
+                if ( m_paused )
+                {
+                    m_paused = false;
+                    m_start = clock::now();
+                }
+                return;
+            }
+            
+            int64_t iterations() const
+            {
+                return m_iterations;
+            }
+            
+            /**
+             * Items (nodes, edges, cells) processed by whole run, gives items per second.
+             */
+            void set_items_processed( int64_t items )
+            {
+                m_items = items;
+                return;
+            }
+            
+            int64_t items_processed() const
+            {
+                return m_items;
+            }
+            
+            double elapsed_seconds() const
+            {
+                return std::chrono::duration<double>( m_elapsed ).count();
+            }
+        };
+        
+        /********************************************************************************/
+        
+        struct result
+        {
+            std::string name;
+            int64_t     iterations           = 0;
+            int32_t     repetitions          = 0;
+            double      ns_per_iteration     = 0.0; // median of repetitions
+            double      min_ns_per_iteration = 0.0;
+            double      items_per_second     = 0.0;
+        };
+        
+        /********************************************************************************/
+        
+        class runner
+        {
+            struct benchmark
+            {
+                std::string                   name;
+                std::function<void( state& )> func;
+            };
+            
+            std::vector<benchmark> m_benchmarks;
+            
+            std::string m_filter;
+            double      m_min_time    = 0.2;
+            int32_t     m_repetitions = 3;
+            std::string m_json_path;
+            std::string m_baseline_path;
+            double      m_threshold   = 10.0;
+            
+            static bool ParseOption( const char *arg, const char *option, std::string& value )
+            {
+                const size_t len = strlen( option );
+                if ( 0 != strncmp( arg, option, len ) || '=' != arg[len] )
+                {
+                    return false;
+                }
+                value = arg + len + 1;
+                return true;
+            }
+            
+            static std::string Escape( const std::string& text )
+            {
+                std::string out;
+                for ( char c : text )
+                {
+                    if ( '"' == c || '\\' == c )
+                    {
+                        out += '\\';
+                    }
+                    out += c;
+                }
+                return out;
+            }
+            
+            /**
+             * Runs benchmark with growing number of iterations until it takes min time.
+             */
+            result Measure( const benchmark& cur_benchmark ) const
+            {
+                const int64_t max_iterations = 1000000000;
+                int64_t iterations = 1;
+                std::vector<double> ns_per_iteration;
+                int64_t items = 0;
+                for ( ;; )
+                {
+                    state st( iterations );
+                    cur_benchmark.func( st );
+                    const double elapsed = st.elapsed_seconds();
+                    if ( elapsed >= m_min_time || iterations >= max_iterations )
+                    {
+                        ns_per_iteration.push_back( elapsed * 1e9 / (double)iterations );
+                        items = st.items_processed();
+                        break;
+                    }
+                    // aim a bit above min time, but don't grow more than 10 times at once
+                    const double multiplier = ( elapsed > 0.0 ) ? m_min_time * 1.4 / elapsed : 10.0;
+                    const int64_t next = (int64_t)( (double)iterations * std::min( multiplier, 10.0 ) );
+                    iterations = std::min( max_iterations, std::max( iterations + 1, next ) );
+                }
+                
+                for ( int32_t i = 1; i < m_repetitions; i++ )
+                {
+                    state st( iterations );
+                    cur_benchmark.func( st );
+                    ns_per_iteration.push_back( st.elapsed_seconds() * 1e9 / (double)iterations );
+                }
+                
+                result out;
+                out.name = cur_benchmark.name;
+                out.iterations = iterations;
+                out.repetitions = (int32_t)ns_per_iteration.size();
+                std::sort( ns_per_iteration.begin(), ns_per_iteration.end() );
+                out.ns_per_iteration = ns_per_iteration[ ns_per_iteration.size() / 2 ];
+                out.min_ns_per_iteration = ns_per_iteration.front();
+                if ( items > 0 && out.ns_per_iteration > 0.0 )
+                {
+                    out.items_per_second = (double)items / (double)iterations * 1e9 / out.ns_per_iteration;
+                }
+                return out;
+            }
+            
+            /**
+             * Reads ns_per_iteration by names from JSON written by WriteJson,
+             * it has one benchmark per line.
+             */
+            std::map<std::string,double> ReadBaseline() const
+            {
+                std::map<std::string,double> out;
+                std::ifstream in( m_baseline_path );
+                if ( !in )
+                {
+                    fprintf( stderr, "Can't read baseline %s\n", m_baseline_path.c_str() );
+                    return out;
+                }
+                std::string line;
+                while ( std::getline( in, line ) )
+                {
+                    const std::string name_key = "\"name\": \"";
+                    const std::string time_key = "\"ns_per_iteration\": ";
+                    const size_t name_pos = line.find( name_key );
+                    const size_t time_pos = line.find( time_key );
+                    if ( std::string::npos == name_pos || std::string::npos == time_pos )
+                    {
+                        continue;
+                    }
+                    std::string name;
+                    for ( size_t i = name_pos + name_key.size(); i < line.size() && '"' != line[i]; i++ )
+                    {
+                        if ( '\\' == line[i] && i + 1 < line.size() )
+                        {
+                            i++;
+                        }
+                        name += line[i];
+                    }
+                    out[name] = strtod( line.c_str() + time_pos + time_key.size(), nullptr );
+                }
+                return out;
+            }
+            
+            void WriteJson( const std::vector<result>& results ) const
+            {
+                FILE *out_p = ( "-" == m_json_path ) ? stdout : fopen( m_json_path.c_str(), "w" );
+                if ( nullptr == out_p )
+                {
+                    fprintf( stderr, "Can't write %s\n", m_json_path.c_str() );
+                    return;
+                }
+                
+                char date[32] = "";
+                const time_t now = time( nullptr );
+                strftime( date, sizeof( date ), "%Y-%m-%dT%H:%M:%S", localtime( &now ) );
+#ifdef __VERSION__
+                const char *compiler = __VERSION__;
+#else
+                const char *compiler = "unknown";
+#endif
+#ifdef __OPTIMIZE__
+                const char *optimized = "true";
+#else
+                const char *optimized = "false";
+#endif
+                
+                fprintf( out_p, "{\n" );
+                fprintf( out_p, "  \"context\": {\"date\": \"%s\", \"compiler\": \"%s\", \"optimized\": %s, "
+                                "\"min_time\": %g, \"repetitions\": %d},\n",
+                         date, Escape( compiler ).c_str(), optimized, m_min_time, (int)m_repetitions );
+                fprintf( out_p, "  \"benchmarks\": [\n" );
+                for ( size_t i = 0; i < results.size(); i++ )
+                {
+                    const result& cur = results[i];
+                    fprintf( out_p, "    {\"name\": \"%s\", \"iterations\": %lld, \"repetitions\": %d, "
+                                    "\"ns_per_iteration\": %.3f, \"min_ns_per_iteration\": %.3f, "
+                                    "\"items_per_second\": %.1f}%s\n",
+                             Escape( cur.name ).c_str(), (long long)cur.iterations, (int)cur.repetitions,
+                             cur.ns_per_iteration, cur.min_ns_per_iteration, cur.items_per_second,
+                             ( i + 1 < results.size() ) ? "," : "" );
+                }
+                fprintf( out_p, "  ]\n}\n" );
+                
+                if ( stdout != out_p )
+                {
+                    fclose( out_p );
+                }
+                return;
+            }
+        
+        public:
+            runner() = default;
+            
+            /**
+             * Takes options from command line, unknown options are reported and skipped.
+             */
+            runner( int argc, char **argv )
+            {
+                for ( int i = 1; i < argc; i++ )
+                {
+                    std::string value;
+                    if ( ParseOption( argv[i], "--filter", value ) )
+                    {
+                        m_filter = value;
+                    } else if ( ParseOption( argv[i], "--min-time", value ) )
+                    {
+                        m_min_time = atof( value.c_str() );
+                    } else if ( ParseOption( argv[i], "--repetitions", value ) )
+                    {
+                        m_repetitions = std::max( 1, atoi( value.c_str() ) );
+                    } else if ( ParseOption( argv[i], "--json", value ) )
+                    {
+                        m_json_path = value;
+                    } else if ( ParseOption( argv[i], "--baseline", value ) )
+                    {
+                        m_baseline_path = value;
+                    } else if ( ParseOption( argv[i], "--threshold", value ) )
+                    {
+                        m_threshold = atof( value.c_str() );
+                    } else
+                    {
+                        fprintf( stderr, "Unknown option %s\n", argv[i] );
+                    }
+                }
+            }
+            
+            template <typename Tfunc>
+            void add( const std::string& name, Tfunc f )
+            {
+                m_benchmarks.push_back( benchmark{ name, f } );
+                return;
+            }
+            
+            /**
+             * Runs benchmarks, prints table and writes JSON.
+             * Returns: exit code, 1 if there are regressions against baseline.
+             */
+            int run() const
+            {
+                std::map<std::string,double> baseline;
+                if ( !m_baseline_path.empty() )
+                {
+                    baseline = ReadBaseline();
+                }
+                // table goes to stderr if JSON goes to stdout
+                FILE *table_p = ( "-" == m_json_path ) ? stderr : stdout;
+                
+                fprintf( table_p, "%-56s %14s %14s %12s %10s\n", "Benchmark", "ns/iteration", "items/s",
+                         "iterations", "baseline" );
+                std::vector<result> results;
+                int32_t num_regressions = 0;
+                for ( const auto& cur_benchmark : m_benchmarks )
+                {
+                    if ( std::string::npos == cur_benchmark.name.find( m_filter ) )
+                    {
+                        continue;
+                    }
+                    const result cur = Measure( cur_benchmark );
+                    results.push_back( cur );
+                    
+                    std::string diff = "";
+                    auto found = baseline.find( cur.name );
+                    if ( found != baseline.end() && found->second > 0.0 )
+                    {
+                        const double percent = ( cur.ns_per_iteration / found->second - 1.0 ) * 100.0;
+                        char text[32];
+                        snprintf( text, sizeof( text ), "%+.1f%%", percent );
+                        diff = text;
+                        if ( percent > m_threshold )
+                        {
+                            diff += " !";
+                            num_regressions++;
+                        }
+                    }
+                    fprintf( table_p, "%-56s %14.1f %14.4g %12lld %10s\n", cur.name.c_str(), cur.ns_per_iteration,
+                             cur.items_per_second, (long long)cur.iterations, diff.c_str() );
+                    fflush( table_p );
+                }
+                
+                if ( !m_json_path.empty() )
+                {
+                    WriteJson( results );
+                }
+                if ( num_regressions > 0 )
+                {
+                    fprintf( table_p, "%d benchmarks are slower than baseline by more than %g%%\n",
+                             (int)num_regressions, m_threshold );
+                    return 1;
+                }
+                return 0;
+            }
+        };
+        
+        /********************************************************************************/
+    }
+}
+
+/****************************************************************************************/
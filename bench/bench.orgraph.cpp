@@ -0,0 +1,250 @@
+#include <vector>
+#include <string>
+#include <memory>
+#include <utility>
+
+#include <stdint.h>
+
+#include "bench.hpp"
+#include "orgraph.hpp"
+
+/****************************************************************************************/
+
+namespace
+{
+    using edge_list = std::vector< std::pair<int32_t,int32_t> >;
+    
+    /**
+     * Random edges of num_nodes x degree: uniform ends or skewed, where succ ends
+     * crowd at the first nodes, so they are hubs with huge pred degree.
+     */
+    edge_list MakeEdges( int32_t num_nodes, int32_t degree, bool skewed )
+    {
+        edge_list out;
+        out.reserve( (size_t)num_nodes * degree );
+        uint32_t seed = 12345;
+        auto next = [&]()
+                    {
+                        seed = seed * 1103515245 + 12345;
+                        return (double)( seed >> 8 ) / (double)( 1 << 24 );
+                    };
+        for ( int32_t i = 0; i < num_nodes * degree; i++ )
+        {
+            const int32_t from = (int32_t)( next() * num_nodes );
+            const double u = next();
+            const int32_t to = (int32_t)( ( skewed ? u * u * u : u ) * num_nodes );
+            out.emplace_back( from, to );
+        }
+        return out;
+    }
+    
+    template <typename Tstorage>
+    struct graph_fixture
+    {
+        using graph_type = ds::orgraph::orgraph<int,int,Tstorage>;
+        using ref_type   = ds::orgraph::node_ref<int,int,Tstorage>;
+        
+        std::unique_ptr<graph_type> graph_p;
+        std::vector<ref_type>       nodes;
+        
+        void build( int32_t num_nodes, const edge_list *edges_p )
+        {
+            nodes.clear();
+            graph_p.reset( new graph_type() );
+            for ( int32_t i = 0; i < num_nodes; i++ )
+            {
+                nodes.push_back( graph_p->add_node( i ) );
+            }
+            if ( nullptr != edges_p )
+            {
+                int edge_data = 0;
+                for ( const auto& cur_edge : *edges_p )
+                {
+                    graph_p->add_edge( edge_data++, nodes[cur_edge.first], nodes[cur_edge.second] );
+                }
+            }
+            return;
+        }
+        
+        void reset()
+        {
+            nodes.clear();
+            graph_p.reset();
+            return;
+        }
+    };
+    
+    std::string Name( const char *what, const char *storage, const char *extra, int32_t num_nodes, int32_t degree = 0 )
+    {
+        std::string out = std::string( "orgraph/" ) + what + "/" + storage;
+        if ( nullptr != extra )
+        {
+            out += std::string( "/" ) + extra;
+        }
+        out += "/n:" + std::to_string( num_nodes );
+        if ( degree > 0 )
+        {
+            out += "/d:" + std::to_string( degree );
+        }
+        return out;
+    }
+    
+    template <typename Tstorage>
+    void AddStorageBenchmarks( ds::bench::runner& runner, const char *storage )
+    {
+        for ( int32_t num_nodes : { 1000, 10000, 100000 } )
+        {
+            runner.add( Name( "add_node", storage, nullptr, num_nodes ), [=]( ds::bench::state& st )
+                        {
+                            graph_fixture<Tstorage> fixture;
+                            while ( st.keep_running() )
+                            {
+                                fixture.build( num_nodes, nullptr );
+                                st.pause_timing();
+                                fixture.reset();
+                                st.resume_timing();
+                            }
+                            st.set_items_processed( st.iterations() * num_nodes );
+                        } );
+        }
+        
+        for ( int32_t num_nodes : { 1000, 100000 } )
+        {
+            for ( int32_t degree : { 4, 16 } )
+            {
+                for ( bool skewed : { false, true } )
+                {
+                    const char *distribution = skewed ? "skewed" : "uniform";
+                    auto edges_p = std::make_shared<edge_list>( MakeEdges( num_nodes, degree, skewed ) );
+                    
+                    runner.add( Name( "add_edge", storage, distribution, num_nodes, degree ),
+                                [=]( ds::bench::state& st )
+                                {
+                                    graph_fixture<Tstorage> fixture;
+                                    while ( st.keep_running() )
+                                    {
+                                        st.pause_timing();
+                                        fixture.build( num_nodes, nullptr );
+                                        st.resume_timing();
+                                        int edge_data = 0;
+                                        for ( const auto& cur_edge : *edges_p )
+                                        {
+                                            fixture.graph_p->add_edge( edge_data++, fixture.nodes[cur_edge.first],
+                                                                       fixture.nodes[cur_edge.second] );
+                                        }
+                                        st.pause_timing();
+                                        fixture.reset();
+                                        st.resume_timing();
+                                    }
+                                    st.set_items_processed( st.iterations() * (int64_t)edges_p->size() );
+                                } );
+                    
+                    runner.add( Name( "succ_edges", storage, distribution, num_nodes, degree ),
+                                [=]( ds::bench::state& st )
+                                {
+                                    graph_fixture<Tstorage> fixture;
+                                    fixture.build( num_nodes, edges_p.get() );
+                                    while ( st.keep_running() )
+                                    {
+                                        int64_t sum = 0;
+                                        for ( const auto& cur_node : fixture.nodes )
+                                        {
+                                            for ( const auto& cur_edge : cur_node.succ_edges() )
+                                            {
+                                                sum += *cur_edge;
+                                            }
+                                        }
+                                        ds::bench::do_not_optimize( sum );
+                                    }
+                                    st.set_items_processed( st.iterations() * (int64_t)edges_p->size() );
+                                } );
+                    
+                    runner.add( Name( "succ_edges_range", storage, distribution, num_nodes, degree ),
+                                [=]( ds::bench::state& st )
+                                {
+                                    graph_fixture<Tstorage> fixture;
+                                    fixture.build( num_nodes, edges_p.get() );
+                                    while ( st.keep_running() )
+                                    {
+                                        int64_t sum = 0;
+                                        for ( const auto& cur_node : fixture.nodes )
+                                        {
+                                            for ( auto cur_edge : cur_node.succ_edges_range() )
+                                            {
+                                                sum += *cur_edge;
+                                            }
+                                        }
+                                        ds::bench::do_not_optimize( sum );
+                                    }
+                                    st.set_items_processed( st.iterations() * (int64_t)edges_p->size() );
+                                } );
+                    
+                    if ( !skewed )
+                    {
+                        continue;
+                    }
+                    // the first nodes get most of edges of skewed graph
+                    runner.add( Name( "remove_node", storage, "hubs", num_nodes, degree ),
+                                [=]( ds::bench::state& st )
+                                {
+                                    const int32_t num_hubs = 8;
+                                    graph_fixture<Tstorage> fixture;
+                                    while ( st.keep_running() )
+                                    {
+                                        st.pause_timing();
+                                        fixture.build( num_nodes, edges_p.get() );
+                                        st.resume_timing();
+                                        for ( int32_t i = 0; i < num_hubs; i++ )
+                                        {
+                                            fixture.graph_p->remove_node( fixture.nodes[i] );
+                                        }
+                                        st.pause_timing();
+                                        fixture.reset();
+                                        st.resume_timing();
+                                    }
+                                    st.set_items_processed( st.iterations() * num_hubs );
+                                } );
+                }
+            }
+        }
+        
+        for ( int32_t num_nodes : { 1000, 100000 } )
+        {
+            for ( bool with_index : { false, true } )
+            {
+                runner.add( Name( "find_node", storage, with_index ? "index" : "scan", num_nodes ),
+                            [=]( ds::bench::state& st )
+                            {
+                                const int32_t num_lookups = 64;
+                                graph_fixture<Tstorage> fixture;
+                                fixture.build( num_nodes, nullptr );
+                                if ( with_index )
+                                {
+                                    fixture.graph_p->enable_node_index();
+                                }
+                                uint32_t seed = 7;
+                                while ( st.keep_running() )
+                                {
+                                    for ( int32_t i = 0; i < num_lookups; i++ )
+                                    {
+                                        seed = seed * 1103515245 + 12345;
+                                        auto found = fixture.graph_p->find_node( (int)( ( seed >> 8 ) % num_nodes ) );
+                                        ds::bench::do_not_optimize( found );
+                                    }
+                                }
+                                st.set_items_processed( st.iterations() * num_lookups );
+                            } );
+            }
+        }
+        return;
+    }
+}
+
+/****************************************************************************************/
+
+void AddOrgraphBenchmarks( ds::bench::runner& runner )
+{
+    AddStorageBenchmarks<ds::orgraph::map_storage>( runner, "map" );
+    AddStorageBenchmarks<ds::orgraph::slot_map_storage>( runner, "slot_map" );
+    return;
+}
@@ -0,0 +1,14 @@
+#!/bin/bash
+
+# Usage: bench.sh [--filter=TEXT] [--min-time=SECONDS] [--repetitions=N] [--json=FILE]
+#                 [--baseline=FILE] [--threshold=PERCENT]
+
+BASEDIR=`dirname $0`
+PROJECT_PATH=`cd $BASEDIR; pwd`
+
+echo "Using path:$PROJECT_PATH" 1>&2
+
+cd $PROJECT_PATH
+
+g++ -O2 -DNDEBUG -std=c++17 -I$PROJECT_PATH -I$PROJECT_PATH/.. -o bench.bin ./bench.cpp ./bench.orgraph.cpp ./bench.vector2d.cpp || exit 1
+./bench.bin "$@"
@@ -0,0 +1,157 @@
+#include <string>
+#include <memory>
+
+#include <stdint.h>
+
+#include "bench.hpp"
+#include "vector2d.hpp"
+
+/****************************************************************************************/
+
+namespace
+{
+    using ds::vector2d::vector2d;
+    using ds::vector2d::point2d;
+    
+    std::string Name( const char *what, const char *layout, int32_t side )
+    {
+        return std::string( "vector2d/" ) + what + "/" + layout + "/n:" + std::to_string( side );
+    }
+    
+    template <typename Tlayout>
+    void AddLayoutBenchmarks( ds::bench::runner& runner, const char *layout, int32_t side )
+    {
+        const int64_t num_cells = (int64_t)side * side;
+        
+        runner.add( Name( "iterate", layout, side ), [=]( ds::bench::state& st )
+                    {
+                        vector2d<int,Tlayout> grid( side, side, 1 );
+                        while ( st.keep_running() )
+                        {
+                            int64_t sum = 0;
+                            for ( auto value : grid )
+                            {
+                                sum += value;
+                            }
+                            ds::bench::do_not_optimize( sum );
+                        }
+                        st.set_items_processed( st.iterations() * num_cells );
+                    } );
+        
+        runner.add( Name( "access_checked_rows", layout, side ), [=]( ds::bench::state& st )
+                    {
+                        vector2d<int,Tlayout> grid( side, side, 1 );
+                        while ( st.keep_running() )
+                        {
+                            int64_t sum = 0;
+                            for ( int32_t y = 0; y < side; y++ )
+                            {
+                                for ( int32_t x = 0; x < side; x++ )
+                                {
+                                    sum += grid( x, y );
+                                }
+                            }
+                            ds::bench::do_not_optimize( sum );
+                        }
+                        st.set_items_processed( st.iterations() * num_cells );
+                    } );
+        
+        runner.add( Name( "access_unchecked_rows", layout, side ), [=]( ds::bench::state& st )
+                    {
+                        vector2d<int,Tlayout> grid( side, side, 1 );
+                        while ( st.keep_running() )
+                        {
+                            int64_t sum = 0;
+                            for ( int32_t y = 0; y < side; y++ )
+                            {
+                                for ( int32_t x = 0; x < side; x++ )
+                                {
+                                    sum += grid.at_unchecked( x, y );
+                                }
+                            }
+                            ds::bench::do_not_optimize( sum );
+                        }
+                        st.set_items_processed( st.iterations() * num_cells );
+                    } );
+        
+        runner.add( Name( "access_unchecked_columns", layout, side ), [=]( ds::bench::state& st )
+                    {
+                        vector2d<int,Tlayout> grid( side, side, 1 );
+                        while ( st.keep_running() )
+                        {
+                            int64_t sum = 0;
+                            for ( int32_t x = 0; x < side; x++ )
+                            {
+                                for ( int32_t y = 0; y < side; y++ )
+                                {
+                                    sum += grid.at_unchecked( x, y );
+                                }
+                            }
+                            ds::bench::do_not_optimize( sum );
+                        }
+                        st.set_items_processed( st.iterations() * num_cells );
+                    } );
+        
+        // resizes of both directions, source grid is made outside of timing
+        const point2d new_sizes[] = { point2d( side + side / 4, side ), point2d( side, side + side / 4 ),
+                                      point2d( side / 2, side / 2 ) };
+        const char *resize_names[] = { "resize_grow_x", "resize_grow_y", "resize_shrink" };
+        for ( int i = 0; i < 3; i++ )
+        {
+            const point2d new_size = new_sizes[i];
+            runner.add( Name( resize_names[i], layout, side ), [=]( ds::bench::state& st )
+                        {
+                            std::unique_ptr< vector2d<int,Tlayout> > grid_p;
+                            while ( st.keep_running() )
+                            {
+                                st.pause_timing();
+                                grid_p.reset( new vector2d<int,Tlayout>( side, side, 1 ) );
+                                st.resume_timing();
+                                grid_p->resize( new_size );
+                                ds::bench::do_not_optimize( grid_p->data() );
+                                st.pause_timing();
+                                grid_p.reset();
+                                st.resume_timing();
+                            }
+                            st.set_items_processed( st.iterations() * num_cells );
+                        } );
+        }
+        return;
+    }
+}
+
+/****************************************************************************************/
+
+void AddVector2dBenchmarks( ds::bench::runner& runner )
+{
+    for ( int32_t side : { 256, 2048 } )
+    {
+        AddLayoutBenchmarks<ds::vector2d::row_major>( runner, "row_major", side );
+        AddLayoutBenchmarks<ds::vector2d::column_major>( runner, "column_major", side );
+        AddLayoutBenchmarks< ds::vector2d::tiled<8> >( runner, "tiled8", side );
+        AddLayoutBenchmarks<ds::vector2d::morton>( runner, "morton", side );
+    }
+    
+    // row spans of row_major give plain pointer loops
+    for ( int32_t side : { 256, 2048 } )
+    {
+        runner.add( Name( "row_unchecked", "row_major", side ), [=]( ds::bench::state& st )
+                    {
+                        vector2d<int> grid( side, side, 1 );
+                        while ( st.keep_running() )
+                        {
+                            int64_t sum = 0;
+                            for ( int32_t y = 0; y < side; y++ )
+                            {
+                                for ( auto value : grid.row_unchecked( y ) )
+                                {
+                                    sum += value;
+                                }
+                            }
+                            ds::bench::do_not_optimize( sum );
+                        }
+                        st.set_items_processed( st.iterations() * (int64_t)side * side );
+                    } );
+    }
+    return;
+}
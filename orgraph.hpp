@@ -21,30 +21,51 @@
  *          10. Iterating through all edges.
  *          11. Iterating through all pred edges of node.
  *          12. Iterating through all succ edges of node.
- * 
+ *
  * So there are 3 visible types:
  *      1.  orgraph<Tnode,Tedge>
  *      2.  node_ref<Tnode> - works as ref to edge
  *      3.  edge_ref<Tedge> - works as ref to edge
  * And others are invisible:
- * 
+ *
+ * Storage of nodes and edges is chosen by policy - third template parameter:
+ *      1.  map_storage      - std::map by id, default;
+ *      2.  slot_map_storage - vector of slots with free list and generations,
+ *                             O(1) lookup by id.
+ * Both are basic_map_storage<Talloc> and basic_slot_map_storage<Talloc> with std::allocator.
+ * Storages, adjacency sets of nodes and so whole graph are allocated by Talloc given
+ * to constructor of orgraph, e.g. whole graph can live in one arena:
+ *      std::pmr::monotonic_buffer_resource arena;
+ *      orgraph<Tnode,Tedge,pmr_slot_map_storage> graph( &arena );
+ *
+ * Defining STATS_DS_ORGRAPH turns on counters of lookups, allocations and scans
+ * of all graphs, they are read by get_stats() (see orgraph_stats).
+ *
  * Oriented graph interface (visible methods):
- *      
+ *
  *      class orgraph<Tnode,Tedge>
  *      {
- *          
+ *
  *      };
  */
 
 /****************************************************************************************/
 
 #include <vector>
+#include <algorithm>
 #include <map>
 #include <set>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <unordered_map>
 #include <string>
 #include <stdexcept>
 #include <functional>
 #include <optional>
+#include <utility>
+#include <tuple>
+#include <type_traits>
 
 #include <iterator> // For std::forward_iterator_tag
 #include <cstddef>  // For std::ptrdiff_t
@@ -55,6 +76,10 @@
 #include <assert.h>
 #endif /* DEBUG_DS_ORGRAPH */
 
+#ifdef STATS_DS_ORGRAPH
+#include <atomic>
+#endif /* STATS_DS_ORGRAPH */
+
 /****************************************************************************************/
 
 namespace ds
@@ -64,358 +89,2211 @@ namespace ds
         /********************************************************************************/
         
         /**
-         * Forward declarations.
+         * Class of node id.
+         * Is needed to distinguish different id's in graph member types.
+         * Generation tells apart ids sharing one index in storages reusing indices.
+         * Id is trivially copyable 8-byte handle of node, it is hashable and ordered,
+         * so it can be kept in vectors and hash maps instead of node_ref and turned
+         * back into ref by orgraph::ref( id ). Default id refers to no node.
          */
-        template <typename Tnode, typename Tedge> class node_ref;
-        template <typename Tnode, typename Tedge> class edge_ref;
-        template <typename Tnode, typename Tedge> class orgraph;
+        class node_id
+        {
+        private:
+            int32_t  m_id         = -1;
+            uint32_t m_generation = 0;
+            
+        public:
+            node_id() = default;
+            explicit node_id( int32_t new_id ) : m_id( new_id ) {}
+            node_id( int32_t new_id, uint32_t new_generation ) :
+                m_id( new_id ),
+                m_generation( new_generation )
+            {}
+            
+            int32_t& operator() ()
+            {
+                return m_id;
+            }
+            
+            int32_t operator() () const
+            {
+                return m_id;
+            }
+            
+            uint32_t generation() const
+            {
+                return m_generation;
+            }
+            
+            bool operator<( const node_id& n1 ) const
+            {
+                return ( m_id < n1() || ( m_id == n1() && m_generation < n1.generation() ) );
+            }
+            
+            bool operator==( const node_id& n1 ) const
+            {
+                return ( m_id == n1() && m_generation == n1.generation() );
+            }
+            
+            bool operator!=( const node_id& n1 ) const
+            {
+                return !( *this == n1 );
+            }
+            
+            node_id next() const
+            {
+                return node_id( m_id + 1 );
+            }
+        };
         
         /********************************************************************************/
         
-        template <typename Tnode, typename Tedge>
-        class orgraph
+        /**
+         * Class of edge id.
+         * Is needed to distinguish different id's in graph member types.
+         * Generation tells apart ids sharing one index in storages reusing indices.
+         * Like node id it is trivially copyable 8-byte handle, see node_id.
+         */
+        class edge_id
         {
-            /*****************************************************************************
-                                    Inner types and friend types
-            *****************************************************************************/
-            friend class node_ref<Tnode,Tedge>;
-            friend class edge_ref<Tnode,Tedge>;
+        private:
+            int32_t  m_id         = -1;
+            uint32_t m_generation = 0;
+            
+        public:
+            edge_id() = default;
+            explicit edge_id( int32_t new_id ) : m_id( new_id ) {}
+            edge_id( int32_t new_id, uint32_t new_generation ) :
+                m_id( new_id ),
+                m_generation( new_generation )
+            {}
+            
+            int32_t& operator() ()
+            {
+                return m_id;
+            }
+            
+            int32_t operator() () const
+            {
+                return m_id;
+            }
+            
+            uint32_t generation() const
+            {
+                return m_generation;
+            }
+            
+            bool operator<( const edge_id& n1 ) const
+            {
+                return ( m_id < n1() || ( m_id == n1() && m_generation < n1.generation() ) );
+            }
+            
+            bool operator==( const edge_id& n1 ) const
+            {
+                return ( m_id == n1() && m_generation == n1.generation() );
+            }
+            
+            bool operator!=( const edge_id& n1 ) const
+            {
+                return !( *this == n1 );
+            }
+            
+            edge_id next() const
+            {
+                return edge_id( m_id + 1 );
+            }
+        };
+        
+        /********************************************************************************/
+        
+        /**
+         * Hash of id of node or edge, mixes index and generation.
+         */
+        template <typename Tid>
+        struct id_hash
+        {
+            size_t operator()( const Tid& id ) const
+            {
+                return std::hash<uint64_t>()( ( (uint64_t)id.generation() << 32 ) | (uint32_t)id() );
+            }
+        };
+    }
+}
+
+namespace std
+{
+    template <>
+    struct hash<ds::orgraph::node_id> : ds::orgraph::id_hash<ds::orgraph::node_id> {};
+    
+    template <>
+    struct hash<ds::orgraph::edge_id> : ds::orgraph::id_hash<ds::orgraph::edge_id> {};
+}
+
+namespace ds
+{
+    namespace orgraph
+    {
+        /********************************************************************************/
+        
+        /**
+         * Counters of orgraph operations in whole process.
+         * Are counted only if STATS_DS_ORGRAPH is defined, otherwise they stay zero
+         * and counting costs nothing. Counting is relaxed atomic, so counters are
+         * only approximately consistent with each other while graphs are used
+         * by several threads.
+         */
+        struct orgraph_stats
+        {
+            uint64_t lookups               = 0; // lookups of nodes and edges by id in storages
+            uint64_t adjacency_allocations = 0; // heap arrays allocated by adjacency of nodes
+            uint64_t adjacency_bytes       = 0; // bytes of these arrays
+            uint64_t find_scans            = 0; // find_node(s) and find_edge(s) calls without index
+            uint64_t find_scanned          = 0; // payloads compared by these calls
+            uint64_t ref_vectors           = 0; // vectors of refs made by nodes(), succ_edges() etc.
+        };
+        
+#ifdef STATS_DS_ORGRAPH
+        struct orgraph_stats_counters
+        {
+            std::atomic<uint64_t> lookups{ 0 };
+            std::atomic<uint64_t> adjacency_allocations{ 0 };
+            std::atomic<uint64_t> adjacency_bytes{ 0 };
+            std::atomic<uint64_t> find_scans{ 0 };
+            std::atomic<uint64_t> find_scanned{ 0 };
+            std::atomic<uint64_t> ref_vectors{ 0 };
+        };
+        
+        inline orgraph_stats_counters stats_counters;
+        
+        inline void add_stat( std::atomic<uint64_t>& counter, uint64_t n = 1 )
+        {
+            counter.fetch_add( n, std::memory_order_relaxed );
+            return;
+        }
+#endif /* STATS_DS_ORGRAPH */
+        
+        /**
+         * Gives current values of counters.
+         */
+        inline orgraph_stats get_stats()
+        {
+            orgraph_stats out;
+#ifdef STATS_DS_ORGRAPH
+            out.lookups               = stats_counters.lookups.load( std::memory_order_relaxed );
+            out.adjacency_allocations = stats_counters.adjacency_allocations.load( std::memory_order_relaxed );
+            out.adjacency_bytes       = stats_counters.adjacency_bytes.load( std::memory_order_relaxed );
+            out.find_scans            = stats_counters.find_scans.load( std::memory_order_relaxed );
+            out.find_scanned          = stats_counters.find_scanned.load( std::memory_order_relaxed );
+            out.ref_vectors           = stats_counters.ref_vectors.load( std::memory_order_relaxed );
+#endif /* STATS_DS_ORGRAPH */
+            return out;
+        }
+        
+        inline void reset_stats()
+        {
+#ifdef STATS_DS_ORGRAPH
+            stats_counters.lookups.store( 0, std::memory_order_relaxed );
+            stats_counters.adjacency_allocations.store( 0, std::memory_order_relaxed );
+            stats_counters.adjacency_bytes.store( 0, std::memory_order_relaxed );
+            stats_counters.find_scans.store( 0, std::memory_order_relaxed );
+            stats_counters.find_scanned.store( 0, std::memory_order_relaxed );
+            stats_counters.ref_vectors.store( 0, std::memory_order_relaxed );
+#endif /* STATS_DS_ORGRAPH */
+            return;
+        }
+        
+        /********************************************************************************/
+        
+        /**
+         * Storage of nodes or edges of graph keyed by id.
+         * Every storage has the same interface:
+         *      Tid     next_id() const            - id which next emplace will take;
+         *      Tvalue& emplace( id, args... )     - constructs value with next_id();
+         *      Tvalue& at( id )                   - throws std::out_of_range if no value;
+         *      bool    contains( id ) const;
+         *      find_by_index( index ) const       - pointer to value with such id index
+         *                                           or nullptr;
+         *      void    erase( id );
+         *      size_t  size() const;
+         *      void    reserve( n )               - prepares storage for n values;
+         *      int32_t id_bound() const           - all ids of storage are less than it,
+         *                                           is usable for dense arrays by id;
+         *      begin(), end()                     - iterate through stored values.
+         */
+        
+        /**
+         * Storage built on std::map.
+         * Ids are given by monotonically increasing counter and never reused.
+         * Lookup is O(log n).
+         */
+        template <typename Tid, typename Tvalue, typename Talloc = std::allocator<char>>
+        class map_container
+        {
+        private:
+            using map_type = std::map< Tid, Tvalue, std::less<Tid>,
+                                       typename std::allocator_traits<Talloc>::template
+                                           rebind_alloc< std::pair<const Tid, Tvalue> > >;
+            
+            map_type m_map;
+            Tid      m_next_id = Tid( 0 );
+            
+        public:
+            explicit map_container( const Talloc& alloc = Talloc() ) :
+                m_map( alloc )
+            {}
+            
+            /**
+             * Iterator through stored values.
+             */
+            template <typename Tmap_iterator, typename Tref>
+            class basic_iterator
+            {
+            private:
+                Tmap_iterator m_it;
+                
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using difference_type   = std::ptrdiff_t;
+                using value_type        = Tvalue;
+                using pointer           = std::remove_reference_t<Tref>*;
+                using reference         = Tref;
+                
+                basic_iterator( Tmap_iterator it ) : m_it( it ) {}
+                
+                reference operator*() const
+                {
+                    return m_it->second;
+                }
+                
+                pointer operator->() const
+                {
+                    return &( m_it->second );
+                }
+                
+                basic_iterator& operator++()
+                {
+                    m_it++;
+                    return *this;
+                }
+                
+                basic_iterator operator++( int )
+                {
+                    basic_iterator tmp = *this;
+                    m_it++;
+                    return tmp;
+                }
+                
+                bool operator==( const basic_iterator& it ) const
+                {
+                    return ( m_it == it.m_it );
+                }
+                
+                bool operator!=( const basic_iterator& it ) const
+                {
+                    return ( m_it != it.m_it );
+                }
+            };
+            
+            using iterator       = basic_iterator< typename map_type::iterator, Tvalue& >;
+            using const_iterator = basic_iterator< typename map_type::const_iterator, const Tvalue& >;
+            
+            Tid next_id() const
+            {
+                return m_next_id;
+            }
+            
+            template <typename... Targs>
+            Tvalue& emplace( const Tid& id, Targs&&... args )
+            {
+#ifdef DEBUG_DS_ORGRAPH
+                assert( id == m_next_id );
+#endif /* DEBUG_DS_ORGRAPH */
+                auto [it,success] = m_map.emplace( std::piecewise_construct,
+                                                   std::forward_as_tuple( id ),
+                                                   std::forward_as_tuple( std::forward<Targs>( args )... ) );
+#ifdef DEBUG_DS_ORGRAPH
+                assert( success );
+#endif /* DEBUG_DS_ORGRAPH */
+                m_next_id = id.next();
+                return it->second;
+            }
+            
+            Tvalue& at( const Tid& id )
+            {
+#ifdef STATS_DS_ORGRAPH
+                add_stat( stats_counters.lookups );
+#endif /* STATS_DS_ORGRAPH */
+                return m_map.at( id );
+            }
+            
+            const Tvalue& at( const Tid& id ) const
+            {
+#ifdef STATS_DS_ORGRAPH
+                add_stat( stats_counters.lookups );
+#endif /* STATS_DS_ORGRAPH */
+                return m_map.at( id );
+            }
+            
+            bool contains( const Tid& id ) const
+            {
+#ifdef STATS_DS_ORGRAPH
+                add_stat( stats_counters.lookups );
+#endif /* STATS_DS_ORGRAPH */
+                return ( m_map.find( id ) != m_map.end() );
+            }
+            
+            const Tvalue* find_by_index( int32_t index ) const
+            {
+#ifdef STATS_DS_ORGRAPH
+                add_stat( stats_counters.lookups );
+#endif /* STATS_DS_ORGRAPH */
+                auto it = m_map.find( Tid( index ) );
+                return ( it != m_map.end() ) ? &( it->second ) : nullptr;
+            }
+            
+            void erase( const Tid& id )
+            {
+                m_map.erase( id );
+                return;
+            }
+            
+            size_t size() const
+            {
+                return m_map.size();
+            }
+            
+            void reserve( size_t )
+            {
+                return;
+            }
+            
+            int32_t id_bound() const
+            {
+                return m_next_id();
+            }
+            
+            iterator begin()
+            {
+                return iterator( m_map.begin() );
+            }
+            
+            iterator end()
+            {
+                return iterator( m_map.end() );
+            }
+            
+            const_iterator begin() const
+            {
+                return const_iterator( m_map.begin() );
+            }
+            
+            const_iterator end() const
+            {
+                return const_iterator( m_map.end() );
+            }
+        };
+        
+        /********************************************************************************/
+        
+        /**
+         * Storage built on vector of slots (slot map).
+         * Id index is position of slot, so lookup is O(1) and values lie compactly.
+         * Slots of erased values are kept in free list and reused by next emplaces;
+         * generation of slot is increased on every erase, so ids of erased values
+         * don't match values which reused their slots.
+         * Values are iterated in order of slots, not in order of ids creation.
+         */
+        template <typename Tid, typename Tvalue, typename Talloc = std::allocator<char>>
+        class slot_map_container
+        {
+        private:
+            struct slot
+            {
+                uint32_t              generation = 0;
+                int32_t               next_free  = -1;
+                std::optional<Tvalue> value;
+            };
+            
+            using slots_type = std::vector< slot, typename std::allocator_traits<Talloc>::template
+                                                      rebind_alloc<slot> >;
+            
+            slots_type m_slots;
+            int32_t    m_free_head = -1;
+            size_t     m_size      = 0;
+            
+            [[noreturn]] static void throw_no_value( const Tid& id )
+            {
+                throw std::out_of_range( "id " + std::to_string( id() ) + ":" +
+                                         std::to_string( id.generation() ) +
+                                         " is not in slot map" );
+            }
+            
+        public:
+            explicit slot_map_container( const Talloc& alloc = Talloc() ) :
+                m_slots( alloc )
+            {}
+            
+            /**
+             * Iterator through stored values. Skips free slots.
+             */
+            template <typename Tslots, typename Tref>
+            class basic_iterator
+            {
+            private:
+                Tslots *m_slots_p;
+                size_t  m_pos;
+                
+                void skip_free()
+                {
+                    while ( m_pos < m_slots_p->size() && !( *m_slots_p )[m_pos].value )
+                    {
+                        m_pos++;
+                    }
+                }
+                
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using difference_type   = std::ptrdiff_t;
+                using value_type        = Tvalue;
+                using pointer           = std::remove_reference_t<Tref>*;
+                using reference         = Tref;
+                
+                basic_iterator( Tslots *slots_p, size_t pos ) :
+                    m_slots_p( slots_p ),
+                    m_pos( pos )
+                {
+                    skip_free();
+                }
+                
+                reference operator*() const
+                {
+                    return *( ( *m_slots_p )[m_pos].value );
+                }
+                
+                pointer operator->() const
+                {
+                    return &*( ( *m_slots_p )[m_pos].value );
+                }
+                
+                basic_iterator& operator++()
+                {
+                    m_pos++;
+                    skip_free();
+                    return *this;
+                }
+                
+                basic_iterator operator++( int )
+                {
+                    basic_iterator tmp = *this;
+                    ++( *this );
+                    return tmp;
+                }
+                
+                bool operator==( const basic_iterator& it ) const
+                {
+                    return ( m_pos == it.m_pos );
+                }
+                
+                bool operator!=( const basic_iterator& it ) const
+                {
+                    return ( m_pos != it.m_pos );
+                }
+            };
+            
+            using iterator       = basic_iterator< slots_type, Tvalue& >;
+            using const_iterator = basic_iterator< const slots_type, const Tvalue& >;
+            
+            Tid next_id() const
+            {
+                if ( m_free_head >= 0 )
+                {
+                    return Tid( m_free_head, m_slots[m_free_head].generation );
+                }
+                return Tid( (int32_t)m_slots.size(), 0 );
+            }
+            
+            template <typename... Targs>
+            Tvalue& emplace( const Tid& id, Targs&&... args )
+            {
+#ifdef DEBUG_DS_ORGRAPH
+                assert( id == next_id() );
+#endif /* DEBUG_DS_ORGRAPH */
+                if ( m_free_head >= 0 )
+                {
+                    m_free_head = m_slots[ id() ].next_free;
+                    m_slots[ id() ].value.emplace( std::forward<Targs>( args )... );
+                } else
+                {
+                    // args can refer into slots (e.g. add_node( *node_of_this_graph )),
+                    // so value is made before slots can be reallocated
+                    Tvalue new_value( std::forward<Targs>( args )... );
+                    m_slots.emplace_back();
+                    m_slots.back().value.emplace( std::move( new_value ) );
+                }
+                
+                slot& cur_slot = m_slots[ id() ];
+                cur_slot.next_free = -1;
+                m_size++;
+                
+                return *cur_slot.value;
+            }
+            
+            Tvalue& at( const Tid& id )
+            {
+                if ( !contains( id ) )
+                {
+                    throw_no_value( id );
+                }
+                return *( m_slots[ id() ].value );
+            }
+            
+            const Tvalue& at( const Tid& id ) const
+            {
+                if ( !contains( id ) )
+                {
+                    throw_no_value( id );
+                }
+                return *( m_slots[ id() ].value );
+            }
+            
+            bool contains( const Tid& id ) const
+            {
+#ifdef STATS_DS_ORGRAPH
+                add_stat( stats_counters.lookups );
+#endif /* STATS_DS_ORGRAPH */
+                return ( id() >= 0 && id() < (int32_t)m_slots.size() &&
+                         m_slots[ id() ].generation == id.generation() &&
+                         m_slots[ id() ].value.has_value() );
+            }
+            
+            const Tvalue* find_by_index( int32_t index ) const
+            {
+#ifdef STATS_DS_ORGRAPH
+                add_stat( stats_counters.lookups );
+#endif /* STATS_DS_ORGRAPH */
+                if ( index < 0 || index >= (int32_t)m_slots.size() || !m_slots[index].value )
+                {
+                    return nullptr;
+                }
+                return &*( m_slots[index].value );
+            }
+            
+            void erase( const Tid& id )
+            {
+                if ( !contains( id ) )
+                {
+                    return;
+                }
+                
+                slot& cur_slot = m_slots[ id() ];
+                cur_slot.value.reset();
+                cur_slot.generation++;
+                cur_slot.next_free = m_free_head;
+                m_free_head = id();
+                m_size--;
+                return;
+            }
+            
+            size_t size() const
+            {
+                return m_size;
+            }
+            
+            void reserve( size_t new_capacity )
+            {
+                m_slots.reserve( new_capacity );
+                return;
+            }
+            
+            int32_t id_bound() const
+            {
+                return (int32_t)m_slots.size();
+            }
+            
+            iterator begin()
+            {
+                return iterator( &m_slots, 0 );
+            }
+            
+            iterator end()
+            {
+                return iterator( &m_slots, m_slots.size() );
+            }
+            
+            const_iterator begin() const
+            {
+                return const_iterator( &m_slots, 0 );
+            }
+            
+            const_iterator end() const
+            {
+                return const_iterator( &m_slots, m_slots.size() );
+            }
+        };
+        
+        /********************************************************************************/
+        
+        /**
+         * Storage policies of orgraph.
+         * Talloc allocates storages and adjacency sets, it is rebound to every type.
+         */
+        template <typename Talloc>
+        struct basic_map_storage
+        {
+            using allocator_type = Talloc;
+            
+            template <typename Tid, typename Tvalue>
+            using container = map_container<Tid,Tvalue,Talloc>;
+        };
+        
+        template <typename Talloc>
+        struct basic_slot_map_storage
+        {
+            using allocator_type = Talloc;
+            
+            template <typename Tid, typename Tvalue>
+            using container = slot_map_container<Tid,Tvalue,Talloc>;
+        };
+        
+        using map_storage      = basic_map_storage< std::allocator<char> >;
+        using slot_map_storage = basic_slot_map_storage< std::allocator<char> >;
+        
+        /**
+         * Storages allocating from std::pmr::memory_resource, e.g. from arena.
+         */
+        using pmr_map_storage      = basic_map_storage< std::pmr::polymorphic_allocator<char> >;
+        using pmr_slot_map_storage = basic_slot_map_storage< std::pmr::polymorphic_allocator<char> >;
+        
+        /********************************************************************************/
+        
+        /**
+         * Pair of iterators usable in range-based for.
+         */
+        template <typename Titerator>
+        class range
+        {
+        private:
+            Titerator m_begin;
+            Titerator m_end;
+            
+        public:
+            range( Titerator new_begin, Titerator new_end ) :
+                m_begin( new_begin ),
+                m_end( new_end )
+            {}
+            
+            Titerator begin() const
+            {
+                return m_begin;
+            }
+            
+            Titerator end() const
+            {
+                return m_end;
+            }
+            
+            bool empty() const
+            {
+                return ( m_begin == m_end );
+            }
+        };
+        
+        /********************************************************************************/
+        
+        /**
+         * Sorted set of ids for adjacency of node.
+         * Up to N ids are stored inline in set itself, more ids go to sorted array
+         * allocated by Talloc. Both ways ids are contiguous and sorted, so lookup is
+         * binary search and iteration is linear scan without pointer chasing.
+         * Unlike std::set inserting and erasing invalidate iterators.
+         */
+        template <typename Tid, size_t N, typename Talloc = std::allocator<Tid>>
+        class small_id_set
+        {
+            static_assert( std::is_trivially_copyable<Tid>::value, "ids are moved as raw memory" );
+            static_assert( N > 0, "inline capacity should be positive" );
+            
+        public:
+            using allocator_type = typename std::allocator_traits<Talloc>::template rebind_alloc<Tid>;
+            using const_iterator = const Tid*;
+            
+        private:
+            using alloc_traits = std::allocator_traits<allocator_type>;
+            
+            allocator_type m_alloc;
+            uint32_t       m_size     = 0;
+            uint32_t       m_capacity = N;
+            union
+            {
+                alignas( Tid ) unsigned char m_inline[ N * sizeof( Tid ) ];
+                Tid                         *m_heap_p;
+            };
+            
+            bool is_inline() const
+            {
+                return ( N == m_capacity );
+            }
+            
+            Tid* ids()
+            {
+                return is_inline() ? reinterpret_cast<Tid*>( m_inline ) : m_heap_p;
+            }
+            
+            const Tid* ids() const
+            {
+                return is_inline() ? reinterpret_cast<const Tid*>( m_inline ) : m_heap_p;
+            }
+            
+            void release()
+            {
+                if ( !is_inline() )
+                {
+                    alloc_traits::deallocate( m_alloc, m_heap_p, m_capacity );
+                    m_capacity = N;
+                }
+                m_size = 0;
+                return;
+            }
+            
+            void grow( size_t min_capacity )
+            {
+                if ( min_capacity <= m_capacity )
+                {
+                    return;
+                }
+                size_t new_capacity = std::max<size_t>( min_capacity, 2 * (size_t)m_capacity );
+                Tid *new_ids_p = alloc_traits::allocate( m_alloc, new_capacity );
+#ifdef STATS_DS_ORGRAPH
+                add_stat( stats_counters.adjacency_allocations );
+                add_stat( stats_counters.adjacency_bytes, new_capacity * sizeof( Tid ) );
+#endif /* STATS_DS_ORGRAPH */
+                std::memcpy( (void*)new_ids_p, (const void*)ids(), m_size * sizeof( Tid ) );
+                
+                const uint32_t size = m_size;
+                release();
+                m_heap_p   = new_ids_p;
+                m_capacity = (uint32_t)new_capacity;
+                m_size     = size;
+                return;
+            }
+            
+            void copy_from( const small_id_set& s )
+            {
+                grow( s.m_size );
+                std::memcpy( (void*)ids(), (const void*)s.ids(), s.m_size * sizeof( Tid ) );
+                m_size = s.m_size;
+                return;
+            }
+            
+            /**
+             * Takes ids of s, s is left empty.
+             */
+            void steal_from( small_id_set& s )
+            {
+                if ( s.is_inline() )
+                {
+                    copy_from( s );
+                } else
+                {
+                    m_heap_p   = s.m_heap_p;
+                    m_capacity = s.m_capacity;
+                    m_size     = s.m_size;
+                    s.m_capacity = N;
+                }
+                s.m_size = 0;
+                return;
+            }
+            
+        public:
+            explicit small_id_set( const Talloc& alloc = Talloc() ) :
+                m_alloc( alloc )
+            {}
+            
+            small_id_set( const small_id_set& s ) :
+                m_alloc( alloc_traits::select_on_container_copy_construction( s.m_alloc ) )
+            {
+                copy_from( s );
+            }
+            
+            // noexcept, so vectors of nodes move sets on reallocation instead of copying
+            small_id_set( small_id_set&& s ) noexcept :
+                m_alloc( s.m_alloc )
+            {
+                steal_from( s );
+            }
+            
+            small_id_set& operator=( const small_id_set& s )
+            {
+                if ( this != &s )
+                {
+                    m_size = 0;
+                    copy_from( s );
+                }
+                return *this;
+            }
+            
+            small_id_set& operator=( small_id_set&& s )
+            {
+                if ( this != &s )
+                {
+                    // storage of s can be taken only if it is freed by the same allocator
+                    if ( m_alloc == s.m_alloc )
+                    {
+                        release();
+                        steal_from( s );
+                    } else
+                    {
+                        m_size = 0;
+                        copy_from( s );
+                    }
+                }
+                return *this;
+            }
+            
+            ~small_id_set()
+            {
+                release();
+            }
+            
+            size_t size() const
+            {
+                return m_size;
+            }
+            
+            bool empty() const
+            {
+                return ( 0 == m_size );
+            }
+            
+            const_iterator begin() const
+            {
+                return ids();
+            }
+            
+            const_iterator end() const
+            {
+                return ids() + m_size;
+            }
+            
+            const_iterator find( const Tid& id ) const
+            {
+                const_iterator it = std::lower_bound( begin(), end(), id );
+                return ( it != end() && *it == id ) ? it : end();
+            }
+            
+            bool contains( const Tid& id ) const
+            {
+                return ( find( id ) != end() );
+            }
+            
+            /**
+             * Returns: true if id is inserted, false if it is already in set.
+             */
+            bool insert( const Tid& id )
+            {
+                const_iterator it = std::lower_bound( begin(), end(), id );
+                if ( it != end() && *it == id )
+                {
+                    return false;
+                }
+                const size_t pos = it - begin();
+                grow( m_size + 1 );
+                
+                Tid *ids_p = ids();
+                std::memmove( (void*)( ids_p + pos + 1 ), (const void*)( ids_p + pos ),
+                              ( m_size - pos ) * sizeof( Tid ) );
+                new ( ids_p + pos ) Tid( id );
+                m_size++;
+                return true;
+            }
+            
+            /**
+             * Inserts sorted range of ids.
+             * Ids greater than all ids of set are just appended, others are merged.
+             */
+            template <typename Titerator>
+            void insert( Titerator first, Titerator last )
+            {
+                grow( m_size + std::distance( first, last ) );
+                
+                Tid *ids_p = ids();
+                const size_t old_size = m_size;
+                for ( ; first != last; first++ )
+                {
+                    new ( ids_p + m_size ) Tid( *first );
+                    m_size++;
+                }
+                if ( old_size > 0 && old_size < m_size && !( ids_p[old_size - 1] < ids_p[old_size] ) )
+                {
+                    std::inplace_merge( ids_p, ids_p + old_size, ids_p + m_size );
+                    m_size = (uint32_t)( std::unique( ids_p, ids_p + m_size ) - ids_p );
+                }
+                return;
+            }
+            
+            /**
+             * Returns: number of erased ids, 0 or 1.
+             */
+            size_t erase( const Tid& id )
+            {
+                const_iterator it = find( id );
+                if ( it == end() )
+                {
+                    return 0;
+                }
+                const size_t pos = it - begin();
+                
+                Tid *ids_p = ids();
+                std::memmove( (void*)( ids_p + pos ), (const void*)( ids_p + pos + 1 ),
+                              ( m_size - pos - 1 ) * sizeof( Tid ) );
+                m_size--;
+                return 1;
+            }
+            
+            /**
+             * Erases all ids satisfying predicate in one pass.
+             * Returns: number of erased ids.
+             */
+            template <typename Tpredicate>
+            size_t erase_if( Tpredicate predicate )
+            {
+                Tid *ids_p = ids();
+                const uint32_t new_size = (uint32_t)( std::remove_if( ids_p, ids_p + m_size, predicate ) - ids_p );
+                const size_t num_erased = m_size - new_size;
+                m_size = new_size;
+                return num_erased;
+            }
+            
+            void clear()
+            {
+                m_size = 0;
+                return;
+            }
+        };
+        
+        /********************************************************************************/
+        
+        /**
+         * Secondary hash index of payloads of nodes or edges.
+         * Keeps hashes of payloads, not payloads themselves, so found ids should be
+         * checked by comparing payloads. Payloads can repeat, so one hash can have
+         * several ids.
+         * Payload of id marked dirty can be changed, it is rehashed on next refresh.
+         */
+        template <typename Tid, typename Tdata>
+        class payload_index
+        {
+        private:
+            struct entry
+            {
+                size_t hash;
+                bool   dirty;
+            };
+            
+            std::function< size_t( const Tdata& ) > m_hasher;
+            std::unordered_multimap< size_t, Tid > m_ids_by_hash;
+            std::unordered_map< Tid, entry > m_entries;
+            std::vector<Tid> m_dirty_ids;
+            
+            void erase_by_hash( const Tid& id, size_t hash )
+            {
+                auto [it, it_end] = m_ids_by_hash.equal_range( hash );
+                for ( ; it != it_end; it++ )
+                {
+                    if ( it->second == id )
+                    {
+                        m_ids_by_hash.erase( it );
+                        return;
+                    }
+                }
+                return;
+            }
+            
+        public:
+            explicit payload_index( std::function< size_t( const Tdata& ) > hasher ) :
+                m_hasher( std::move( hasher ) )
+            {}
+            
+            void insert( const Tid& id, const Tdata& data )
+            {
+                const size_t hash = m_hasher( data );
+                m_ids_by_hash.emplace( hash, id );
+                m_entries.emplace( id, entry{ hash, false } );
+                return;
+            }
+            
+            void erase( const Tid& id )
+            {
+                auto it = m_entries.find( id );
+                if ( it == m_entries.end() )
+                {
+                    return;
+                }
+                erase_by_hash( id, it->second.hash );
+                m_entries.erase( it );
+                return;
+            }
+            
+            /**
+             * Marks that payload of id can be changed.
+             */
+            void mark_dirty( const Tid& id )
+            {
+                auto it = m_entries.find( id );
+                if ( it == m_entries.end() || it->second.dirty )
+                {
+                    return;
+                }
+                it->second.dirty = true;
+                m_dirty_ids.push_back( id );
+                return;
+            }
+            
+            /**
+             * Rehashes payloads marked dirty.
+             * data_of( id ) should give current payload of id.
+             */
+            template <typename Tdata_of>
+            void refresh( Tdata_of data_of )
+            {
+                for ( const auto& id : m_dirty_ids )
+                {
+                    auto it = m_entries.find( id );
+                    if ( it == m_entries.end() )
+                    {
+                        continue;
+                    }
+                    
+                    const size_t new_hash = m_hasher( data_of( id ) );
+                    if ( new_hash != it->second.hash )
+                    {
+                        erase_by_hash( id, it->second.hash );
+                        m_ids_by_hash.emplace( new_hash, id );
+                        it->second.hash = new_hash;
+                    }
+                    it->second.dirty = false;
+                }
+                m_dirty_ids.clear();
+                return;
+            }
+            
+            /**
+             * Gives ids with the same hash of payload as data.
+             * Note: index should be refreshed before.
+             */
+            auto candidates( const Tdata& data ) const
+            {
+                return m_ids_by_hash.equal_range( m_hasher( data ) );
+            }
+        };
+        
+        /********************************************************************************/
+        
+        /**
+         * Forward declarations.
+         */
+        template <typename Tnode, typename Tedge, typename Tstorage = map_storage> class node_ref;
+        template <typename Tnode, typename Tedge, typename Tstorage = map_storage> class edge_ref;
+        template <typename Tnode, typename Tedge, typename Tstorage = map_storage> class orgraph;
+        template <typename Tnode, typename Tedge> class csr_view;
+        template <typename Tgraph> class graph_adapter;
+        
+        /********************************************************************************/
+        
+        /**
+         * Listener of graph changes, is subscribed by orgraph::subscribe.
+         * Every method is called by graph:
+         *      on_add_node    - after node is added;
+         *      on_add_edge    - after edge is added;
+         *      on_remove_node - before node is removed, its edges are already removed;
+         *      on_remove_edge - before edge is removed;
+         *      on_touch_node  - before payload of node is given for writing by node_ref::operator*;
+         *      on_touch_edge  - before payload of edge is given for writing by edge_ref::operator*.
+         * Methods can subscribe and unsubscribe listeners, this one too. on_touch_*
+         * should not add nodes or edges, payload reference is taken before it.
+         */
+        template <typename Tnode, typename Tedge, typename Tstorage = map_storage>
+        class orgraph_listener
+        {
+        public:
+            virtual ~orgraph_listener() = default;
+            
+            virtual void on_add_node( const node_ref<Tnode,Tedge,Tstorage>& )
+            {
+                return;
+            }
+            
+            virtual void on_add_edge( const edge_ref<Tnode,Tedge,Tstorage>& )
+            {
+                return;
+            }
+            
+            virtual void on_remove_node( const node_ref<Tnode,Tedge,Tstorage>& )
+            {
+                return;
+            }
+            
+            virtual void on_remove_edge( const edge_ref<Tnode,Tedge,Tstorage>& )
+            {
+                return;
+            }
+            
+            virtual void on_touch_node( const node_ref<Tnode,Tedge,Tstorage>& )
+            {
+                return;
+            }
+            
+            virtual void on_touch_edge( const edge_ref<Tnode,Tedge,Tstorage>& )
+            {
+                return;
+            }
+        };
+        
+        /********************************************************************************/
+        
+        template <typename Tnode, typename Tedge, typename Tstorage>
+        class orgraph
+        {
+            /*****************************************************************************
+                                    Inner types and friend types
+            *****************************************************************************/
+            friend class node_ref<Tnode,Tedge,Tstorage>;
+            friend class edge_ref<Tnode,Tedge,Tstorage>;
+            friend class csr_view<Tnode,Tedge>;
+            friend class graph_adapter< orgraph<Tnode,Tedge,Tstorage> >;
+            
+        public:
+            using allocator_type = typename Tstorage::allocator_type;
+        
+        private:
+            using node_id = ds::orgraph::node_id;
+            using edge_id = ds::orgraph::edge_id;
+            using listener_type = orgraph_listener<Tnode,Tedge,Tstorage>;
+            
+            /**
+             * Set of edge ids in adjacency of node, is allocated by allocator of graph.
+             * Most nodes have few edges, their ids are kept inside node.
+             */
+            static constexpr size_t inline_edge_ids = 4;
+            using edge_id_set = small_id_set< edge_id, inline_edge_ids, allocator_type >;
+            
+            /****************************************************************************/
+            
+            /**
+             * Node class.
+             */
+            class node
+            {
+            private:
+                Tnode m_data;
+            
+                // these fields are set once in constructor and then cannot be changed
+                const node_id                         m_id;
+                orgraph<Tnode,Tedge,Tstorage> * const m_graph_p;
+                
+                edge_id_set m_pred_edges;
+                edge_id_set m_succ_edges;
+                
+            public:
+                node( orgraph<Tnode,Tedge,Tstorage> * const graph_p, const node_id id ) :
+                    m_id( id ),
+                    m_graph_p( graph_p ),
+                    m_pred_edges( graph_p->m_allocator ),
+                    m_succ_edges( graph_p->m_allocator )
+                {}
+                node( orgraph<Tnode,Tedge,Tstorage> * const graph_p, const node_id id,
+                      const Tnode& data ) :
+                    m_data( data ),
+                    m_id( id ),
+                    m_graph_p( graph_p ),
+                    m_pred_edges( graph_p->m_allocator ),
+                    m_succ_edges( graph_p->m_allocator )
+                {}
+                template <typename... Targs>
+                node( orgraph<Tnode,Tedge,Tstorage> * const graph_p, const node_id id,
+                      std::in_place_t, Targs&&... data_args ) :
+                    m_data( std::forward<Targs>( data_args )... ),
+                    m_id( id ),
+                    m_graph_p( graph_p ),
+                    m_pred_edges( graph_p->m_allocator ),
+                    m_succ_edges( graph_p->m_allocator )
+                {}
+                
+                Tnode& data()
+                {
+                    return m_data;
+                }
+                
+                const Tnode& data() const
+                {
+                    return m_data;
+                }
+                
+                const node_id id() const
+                {
+                    return m_id;
+                }
+                
+                void add_pred_edge_id( edge_id pred_edge )
+                {
+                    m_pred_edges.insert( pred_edge );
+                    return;
+                }
+                
+                void add_succ_edge_id( edge_id succ_edge )
+                {
+                    m_succ_edges.insert( succ_edge );
+                    return;
+                }
+                
+                /**
+                 * Adds many edge ids at once. Ids should be sorted.
+                 */
+                template <typename Titerator>
+                void add_pred_edge_ids( Titerator first, Titerator last )
+                {
+                    m_pred_edges.insert( first, last );
+                    return;
+                }
+                
+                template <typename Titerator>
+                void add_succ_edge_ids( Titerator first, Titerator last )
+                {
+                    m_succ_edges.insert( first, last );
+                    return;
+                }
+                
+                void remove_pred_edge_id( edge_id pred_edge )
+                {
+                    m_pred_edges.erase( pred_edge );
+                    return;
+                }
+                
+                void remove_succ_edge_id( edge_id succ_edge )
+                {
+                    m_succ_edges.erase( succ_edge );
+                    return;
+                }
+                
+                edge_id_set& preds()
+                {
+                    return m_pred_edges;
+                }
+                
+                edge_id_set& succs()
+                {
+                    return m_succ_edges;
+                }
+                
+                const edge_id_set& preds() const
+                {
+                    return m_pred_edges;
+                }
+                
+                const edge_id_set& succs() const
+                {
+                    return m_succ_edges;
+                }
+                
+                node_ref<Tnode,Tedge,Tstorage> make_ref() const
+                {
+                    return node_ref<Tnode,Tedge,Tstorage>( m_graph_p, m_id );
+                }
+            };
+            
+            /****************************************************************************/
+            
+            /**
+             * Edge class.
+             * Its pred and succ are unchangeable.
+             */
+            class edge
+            {
+            private:
+                Tedge m_data;
+            
+                // these fields are set once in constructor and then cannot be changed
+                const edge_id                         m_id;
+                orgraph<Tnode,Tedge,Tstorage> * const m_graph_p;
+                const node_id                         m_pred_node;
+                const node_id                         m_succ_node;
+                
+            public:
+                edge( orgraph<Tnode,Tedge,Tstorage> * const graph_p, const edge_id id,
+                      node_id pred_node, node_id succ_node ) :
+                    m_id( id ),
+                    m_graph_p( graph_p ),
+                    m_pred_node( pred_node ),
+                    m_succ_node( succ_node )
+                {}
+                edge( orgraph<Tnode,Tedge,Tstorage> * const graph_p, const edge_id id,
+                      const Tedge& data,
+                      const node_id pred_node, const node_id succ_node ) :
+                    m_data( data ),
+                    m_id( id ),
+                    m_graph_p( graph_p ),
+                    m_pred_node( pred_node ),
+                    m_succ_node( succ_node )
+                {}
+                template <typename... Targs>
+                edge( orgraph<Tnode,Tedge,Tstorage> * const graph_p, const edge_id id,
+                      const node_id pred_node, const node_id succ_node,
+                      std::in_place_t, Targs&&... data_args ) :
+                    m_data( std::forward<Targs>( data_args )... ),
+                    m_id( id ),
+                    m_graph_p( graph_p ),
+                    m_pred_node( pred_node ),
+                    m_succ_node( succ_node )
+                {}
+                
+                Tedge& data()
+                {
+                    return m_data;
+                }
+                
+                const Tedge& data() const
+                {
+                    return m_data;
+                }
+                
+                const edge_id id() const
+                {
+                    return m_id;
+                }
+                
+                const node_id pred() const
+                {
+                    return m_pred_node;
+                }
+                
+                const node_id succ() const
+                {
+                    return m_succ_node;
+                }
+                
+                edge_ref<Tnode,Tedge,Tstorage> make_ref() const
+                {
+                    return edge_ref<Tnode,Tedge,Tstorage>( m_graph_p, m_id );
+                }
+            };
+            
+            /****************************************************************************/
+            
+            /**
+             * Policies of adjacency_iterator.
+             * Tpolicy::get( graph, edge id ) makes value for edge id of adjacency.
+             */
+            struct adjacent_edge_policy
+            {
+                using value_type = edge_ref<Tnode,Tedge,Tstorage>;
+                static value_type get( orgraph<Tnode,Tedge,Tstorage> *graph_p, const edge_id& id )
+                {
+                    return value_type( graph_p, id );
+                }
+            };
+            
+            struct pred_node_policy
+            {
+                using value_type = node_ref<Tnode,Tedge,Tstorage>;
+                static value_type get( orgraph<Tnode,Tedge,Tstorage> *graph_p, const edge_id& id )
+                {
+                    return value_type( graph_p, graph_p->m_edges.at( id ).pred() );
+                }
+            };
+            
+            struct succ_node_policy
+            {
+                using value_type = node_ref<Tnode,Tedge,Tstorage>;
+                static value_type get( orgraph<Tnode,Tedge,Tstorage> *graph_p, const edge_id& id )
+                {
+                    return value_type( graph_p, graph_p->m_edges.at( id ).succ() );
+                }
+            };
+            
+        public:
+            /**
+             * Iterator through pred or succ edge ids of node.
+             * Refs are made on the fly, nothing is allocated while iterating.
+             * Is invalidated by adding or removing edges of the node.
+             */
+            template <typename Tpolicy>
+            class adjacency_iterator
+            {
+            private:
+                using base_iterator = typename edge_id_set::const_iterator;
+                
+                orgraph<Tnode,Tedge,Tstorage> *m_graph_p;
+                base_iterator                  m_it;
+                
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using difference_type   = std::ptrdiff_t;
+                using value_type        = typename Tpolicy::value_type;
+                using pointer           = void;
+                using reference         = value_type;
+                
+                adjacency_iterator( orgraph<Tnode,Tedge,Tstorage> *graph_p, base_iterator it ) :
+                    m_graph_p( graph_p ),
+                    m_it( it )
+                {}
+                
+                value_type operator*() const
+                {
+                    return Tpolicy::get( m_graph_p, *m_it );
+                }
+                
+                adjacency_iterator& operator++()
+                {
+                    m_it++;
+                    return *this;
+                }
+                
+                adjacency_iterator operator++( int )
+                {
+                    adjacency_iterator tmp = *this;
+                    m_it++;
+                    return tmp;
+                }
+                
+                bool operator==( const adjacency_iterator& it ) const
+                {
+                    return ( m_it == it.m_it );
+                }
+                
+                bool operator!=( const adjacency_iterator& it ) const
+                {
+                    return ( m_it != it.m_it );
+                }
+            };
+            
+            using adjacent_edge_iterator = adjacency_iterator<adjacent_edge_policy>;
+            using pred_node_iterator     = adjacency_iterator<pred_node_policy>;
+            using succ_node_iterator     = adjacency_iterator<succ_node_policy>;
+            
+            /*****************************************************************************
+                                                Data
+            *****************************************************************************/
+        private:
+            /**
+             * Data of orgraph.
+             * Ids of new nodes and edges are given by storages.
+             * Allocator is declared first, so it is ready when storages are built.
+             */
+            allocator_type                                         m_allocator;
+            typename Tstorage::template container< node_id, node > m_nodes;
+            typename Tstorage::template container< edge_id, edge > m_edges;
+            
+            /**
+             * Optional indices of payloads.
+             * Are refreshed lazily by const find methods, so they are mutable.
+             */
+            mutable std::optional< payload_index< node_id, Tnode > > m_node_index;
+            mutable std::optional< payload_index< edge_id, Tedge > > m_edge_index;
+            
+            /**
+             * Subscribed listeners of changes, listeners unsubscribed during
+             * notification are null until it ends.
+             */
+            std::vector<listener_type*> m_listeners;
+            int32_t                     m_notify_depth = 0;
+            
+            /**
+             * Nodes whose adjacency can keep ids of removed edges (tombstones).
+             * Is emptied by compact(), its capacity is kept for next removals.
+             */
+            std::vector<node_id> m_dirty_nodes;
+            bool                 m_compaction_deferred = false;
+            
+            /*****************************************************************************
+                                             Inner methods
+            *****************************************************************************/
+        private:
+            /**
+             * Calls method of every listener subscribed when notification starts.
+             * Listeners can subscribe and unsubscribe from callbacks: new ones are called
+             * from the next notification, unsubscribed ones are not called anymore.
+             */
+            template <typename Tref>
+            void notify( void ( listener_type::*method )( const Tref& ), const Tref& ref )
+            {
+                const size_t num_listeners = m_listeners.size();
+                if ( 0 == num_listeners )
+                {
+                    return;
+                }
+                m_notify_depth++;
+                try
+                {
+                    for ( size_t i = 0; i < num_listeners; i++ )
+                    {
+                        if ( nullptr != m_listeners[i] )
+                        {
+                            ( m_listeners[i]->*method )( ref );
+                        }
+                    }
+                } catch ( ... )
+                {
+                    end_notify();
+                    throw;
+                }
+                end_notify();
+                return;
+            }
             
-        private:
-            /****************************************************************************/
+            void end_notify()
+            {
+                if ( 0 == --m_notify_depth )
+                {
+                    m_listeners.erase( std::remove( m_listeners.begin(), m_listeners.end(), nullptr ),
+                                       m_listeners.end() );
+                }
+                return;
+            }
             
             /**
-             * Class of node id.
-             * Is needed to distinguish different id's in graph member types.
+             * Is called when payload of node or edge can be changed through ref,
+             * takes node or edge already found by ref.
              */
-            class node_id
+            void touch_node( const node& touched )
             {
-            private:
-                int32_t m_id;
-                
-            public:
-                node_id( int32_t new_id ) : m_id( new_id ) {}
-                
-                int32_t& operator() ()
+                if ( m_node_index )
                 {
-                    return m_id;
+                    m_node_index->mark_dirty( touched.id() );
                 }
-                
-                int32_t operator() () const
+                if ( !m_listeners.empty() )
                 {
-                    return m_id;
+                    notify( &listener_type::on_touch_node, touched.make_ref() );
                 }
-                
-                bool operator<( const node_id& n1 ) const
+                return;
+            }
+            
+            void touch_edge( const edge& touched )
+            {
+                if ( m_edge_index )
                 {
-                    return ( m_id < n1() );
+                    m_edge_index->mark_dirty( touched.id() );
                 }
-                
-                node_id next() const
+                if ( !m_listeners.empty() )
                 {
-                    return node_id( m_id + 1 );
+                    notify( &listener_type::on_touch_edge, touched.make_ref() );
                 }
-            };
-            
-            /****************************************************************************/
+                return;
+            }
             
             /**
-             * Class of edge id.
-             * Is needed to distinguish different id's in graph member types.
+             * Removes edge from storage leaving its id in adjacency of its ends,
+             * the ends are marked dirty to be compacted.
              */
-            class edge_id
+            void erase_edge_lazily( const edge_id& rm_edge_id )
             {
-            private:
-                int32_t m_id;
+                const edge& rm_edge = m_edges.at( rm_edge_id );
+                edge_ref<Tnode,Tedge,Tstorage> rm_edge_ref = rm_edge.make_ref();
+                notify( &listener_type::on_remove_edge, rm_edge_ref );
                 
-            public:
-                edge_id( int32_t new_id ) : m_id( new_id ) {}
+                m_dirty_nodes.push_back( rm_edge.pred() );
+                m_dirty_nodes.push_back( rm_edge.succ() );
                 
-                int32_t& operator() ()
+                if ( m_edge_index )
                 {
-                    return m_id;
+                    m_edge_index->erase( rm_edge_id );
+                }
+                
+                m_edges.erase( rm_edge_id );
+                return;
+            }
+            
+            /**
+             * Removes node and its edges leaving edge ids in adjacency of neighbours,
+             * the neighbours are marked dirty to be compacted.
+             */
+            void erase_node_lazily( const node_id& rm_node_id )
+            {
+                node& rm_node = m_nodes.at( rm_node_id );
+                
+                // edges between removed nodes and self loops are met twice, tombstones are skipped
+                for ( auto e : rm_node.preds() )
+                {
+                    if ( m_edges.contains( e ) )
+                    {
+                        erase_edge_lazily( e );
+                    }
                 }
+                for ( auto e : rm_node.succs() )
+                {
+                    if ( m_edges.contains( e ) )
+                    {
+                        erase_edge_lazily( e );
+                    }
+                }
+                rm_node.preds().clear();
+                rm_node.succs().clear();
                 
-                int32_t operator() () const
+                node_ref<Tnode,Tedge,Tstorage> rm_node_ref = rm_node.make_ref();
+                notify( &listener_type::on_remove_node, rm_node_ref );
+                
+                if ( m_node_index )
                 {
-                    return m_id;
+                    m_node_index->erase( rm_node_id );
                 }
+                
+                m_nodes.erase( rm_node_id );
+                return;
+            }
             
-                bool operator<( const edge_id& n1 ) const
+            /**
+             * Sorts ( node id, edge id ) links by node and passes edge ids of every node
+             * to its adjacency at once.
+             */
+            void link_edges( std::vector< std::pair<node_id,edge_id> >& links,
+                             void ( node::*add_ids )( edge_id*, edge_id* ) )
+            {
+                std::sort( links.begin(), links.end() );
+                
+                std::vector<edge_id> group_ids;
+                size_t group_begin = 0;
+                while ( group_begin < links.size() )
                 {
-                    return ( m_id < n1() );
+                    const node_id group_node = links[group_begin].first;
+                    
+                    group_ids.clear();
+                    size_t group_end = group_begin;
+                    while ( group_end < links.size() && links[group_end].first == group_node )
+                    {
+                        group_ids.push_back( links[group_end].second );
+                        group_end++;
+                    }
+                    
+                    ( m_nodes.at( group_node ).*add_ids )( group_ids.data(),
+                                                           group_ids.data() + group_ids.size() );
+                    group_begin = group_end;
                 }
+                return;
+            }
+            
+            void refresh_node_index() const
+            {
+                m_node_index->refresh( [this]( const node_id& id ) -> const Tnode&
+                                       {
+                                           return m_nodes.at( id ).data();
+                                       } );
+                return;
+            }
+            
+            void refresh_edge_index() const
+            {
+                m_edge_index->refresh( [this]( const edge_id& id ) -> const Tedge&
+                                       {
+                                           return m_edges.at( id ).data();
+                                       } );
+                return;
+            }
+            
+            /*****************************************************************************
+                                          Public interface
+            *****************************************************************************/
+        public:
+            /**
+             * Makes empty graph allocating everything by alloc.
+             */
+            explicit orgraph( const allocator_type& alloc = allocator_type() ) :
+                m_allocator( alloc ),
+                m_nodes( alloc ),
+                m_edges( alloc )
+            {}
+            
+            /**
+             * Nodes and edges keep pointer to their graph, so graph is not copied.
+             */
+            orgraph( const orgraph& ) = delete;
+            orgraph& operator=( const orgraph& ) = delete;
+            
+            allocator_type get_allocator() const
+            {
+                return m_allocator;
+            }
+            
+            /**
+             * Adds node.
+             * Returns: ref to created node.
+             */
+            node_ref<Tnode,Tedge,Tstorage> add_node( const Tnode& new_node_data )
+            {
+                return emplace_node( new_node_data );
+            }
+            
+            /**
+             * Adds node moving data into it.
+             * Returns: ref to created node.
+             */
+            node_ref<Tnode,Tedge,Tstorage> add_node( Tnode&& new_node_data )
+            {
+                return emplace_node( std::move( new_node_data ) );
+            }
+            
+            /**
+             * Adds node constructing its data in place from arguments.
+             * Returns: ref to created node.
+             */
+            template <typename... Targs>
+            node_ref<Tnode,Tedge,Tstorage> emplace_node( Targs&&... data_args )
+            {
+                const node_id new_node_id = m_nodes.next_id();
+                node& new_node = m_nodes.emplace( new_node_id, this, new_node_id, std::in_place,
+                                                  std::forward<Targs>( data_args )... );
                 
-                edge_id next() const
+                if ( m_node_index )
                 {
-                    return edge_id( m_id + 1 );
+                    m_node_index->insert( new_node_id, new_node.data() );
                 }
-            };
+                
+                node_ref<Tnode,Tedge,Tstorage> ref = new_node.make_ref();
+                notify( &listener_type::on_add_node, ref );
+                
+                return ref;
+            }
             
-            /****************************************************************************/
+            /**
+             * Adds edge.
+             * Returns: ref to created edge.
+             */
+            edge_ref<Tnode,Tedge,Tstorage> add_edge( const Tedge& new_edge_data,
+                                                     node_ref<Tnode,Tedge,Tstorage> node_start,
+                                                     node_ref<Tnode,Tedge,Tstorage> node_end )
+            {
+                return emplace_edge( node_start, node_end, new_edge_data );
+            }
             
             /**
-             * Node class.
+             * Adds edge moving data into it.
+             * Returns: ref to created edge.
              */
-            class node
+            edge_ref<Tnode,Tedge,Tstorage> add_edge( Tedge&& new_edge_data,
+                                                     node_ref<Tnode,Tedge,Tstorage> node_start,
+                                                     node_ref<Tnode,Tedge,Tstorage> node_end )
             {
-            private:
-                Tnode m_data;
+                return emplace_edge( node_start, node_end, std::move( new_edge_data ) );
+            }
             
-                // these fields are set once in constructor and then cannot be changed
-                const node_id                m_id;
-                orgraph<Tnode,Tedge> * const m_graph_p;
+            /**
+             * Adds edge constructing its data in place from arguments.
+             * Returns: ref to created edge.
+             */
+            template <typename... Targs>
+            edge_ref<Tnode,Tedge,Tstorage> emplace_edge( node_ref<Tnode,Tedge,Tstorage> node_start,
+                                                         node_ref<Tnode,Tedge,Tstorage> node_end,
+                                                         Targs&&... data_args )
+            {
+                node& start = m_nodes.at( node_start.id() );
+                node& end   = m_nodes.at( node_end.id() );
                 
-                std::set<edge_id> m_pred_edges;
-                std::set<edge_id> m_succ_edges;
+                const edge_id new_edge_id = m_edges.next_id();
+                edge& new_edge = m_edges.emplace( new_edge_id, this, new_edge_id,
+                                                  node_start.id(), node_end.id(), std::in_place,
+                                                  std::forward<Targs>( data_args )... );
                 
-            public:
-                node( orgraph<Tnode,Tedge> * const graph_p, const node_id id ) :
-                    m_id( id ),
-                    m_graph_p( graph_p )
-                {}
-                node( orgraph<Tnode,Tedge> * const graph_p, const node_id id,
-                      const Tnode& data ) :
-                    m_id( id ),
-                    m_graph_p( graph_p ),
-                    m_data( data )
-                {}
+                start.add_succ_edge_id( new_edge_id );
+                end.add_pred_edge_id( new_edge_id );
                 
-                Tnode& data()
+                if ( m_edge_index )
                 {
-                    return m_data;
+                    m_edge_index->insert( new_edge_id, new_edge.data() );
                 }
                 
-                const Tnode data() const
+                edge_ref<Tnode,Tedge,Tstorage> ref = new_edge.make_ref();
+                notify( &listener_type::on_add_edge, ref );
+                
+                return ref;
+            }
+            
+            /**
+             * Subscribes listener to changes of graph.
+             * Listener should be unsubscribed before it is destroyed.
+             * Both can be called from callbacks of listeners (see notify).
+             */
+            void subscribe( orgraph_listener<Tnode,Tedge,Tstorage> *listener_p )
+            {
+                m_listeners.push_back( listener_p );
+                return;
+            }
+            
+            void unsubscribe( orgraph_listener<Tnode,Tedge,Tstorage> *listener_p )
+            {
+                if ( m_notify_depth > 0 )
                 {
-                    return m_data;
+                    std::replace( m_listeners.begin(), m_listeners.end(), listener_p, (listener_type*)nullptr );
+                    return;
                 }
+                m_listeners.erase( std::remove( m_listeners.begin(), m_listeners.end(), listener_p ),
+                                   m_listeners.end() );
+                return;
+            }
+            
+            /**
+             * Prepares graph for adding nodes and edges, so storages don't grow
+             * many times while graph is loaded.
+             */
+            void reserve( size_t num_nodes, size_t num_edges )
+            {
+                m_nodes.reserve( num_nodes );
+                m_edges.reserve( num_edges );
+                return;
+            }
+            
+            /**
+             * Adds nodes with data from range.
+             * Returns: refs to created nodes in order of range.
+             */
+            template <typename Trange>
+            std::vector< node_ref<Tnode,Tedge,Tstorage> > add_nodes( const Trange& nodes_data )
+            {
+                std::vector< node_ref<Tnode,Tedge,Tstorage> > out;
+#ifdef STATS_DS_ORGRAPH
+                add_stat( stats_counters.ref_vectors );
+#endif /* STATS_DS_ORGRAPH */
                 
-                const node_id id() const
+                const size_t num_new = std::distance( std::begin( nodes_data ), std::end( nodes_data ) );
+                m_nodes.reserve( m_nodes.size() + num_new );
+                out.reserve( num_new );
+                
+                for ( const auto& cur_data : nodes_data )
                 {
-                    return m_id;
+                    out.push_back( add_node( cur_data ) );
                 }
                 
-                void add_pred_edge_id( edge_id pred_edge )
+                return out;
+            }
+            
+            /**
+             * Adds edges from range of ( data, start node ref, end node ref ) tuples,
+             * for example std::tuple<Tedge,node_ref,node_ref>.
+             * Edges are grouped by nodes, so adjacency of every node is updated once.
+             * If some node ref is invalid, std::out_of_range is thrown and nothing is added.
+             * Returns: refs to created edges in order of range.
+             */
+            template <typename Trange>
+            std::vector< edge_ref<Tnode,Tedge,Tstorage> > add_edges( const Trange& edges_data )
+            {
+                std::vector< edge_ref<Tnode,Tedge,Tstorage> > out;
+#ifdef STATS_DS_ORGRAPH
+                add_stat( stats_counters.ref_vectors );
+#endif /* STATS_DS_ORGRAPH */
+                
+                for ( const auto& [cur_data, cur_start, cur_end] : edges_data )
                 {
-                    m_pred_edges.insert( pred_edge );
-                    return;
+                    m_nodes.at( cur_start.id() );
+                    m_nodes.at( cur_end.id() );
                 }
                 
-                void add_succ_edge_id( edge_id succ_edge )
+                const size_t num_new = std::distance( std::begin( edges_data ), std::end( edges_data ) );
+                m_edges.reserve( m_edges.size() + num_new );
+                out.reserve( num_new );
+                
+                // ( node id, edge id ) pairs for both directions
+                std::vector< std::pair<node_id,edge_id> > succ_links;
+                std::vector< std::pair<node_id,edge_id> > pred_links;
+                succ_links.reserve( num_new );
+                pred_links.reserve( num_new );
+                
+                for ( const auto& [cur_data, cur_start, cur_end] : edges_data )
                 {
-                    m_succ_edges.insert( succ_edge );
-                    return;
+                    const edge_id new_edge_id = m_edges.next_id();
+                    edge& new_edge = m_edges.emplace( new_edge_id, this, new_edge_id, cur_data,
+                                                      cur_start.id(), cur_end.id() );
+                    
+                    succ_links.emplace_back( cur_start.id(), new_edge_id );
+                    pred_links.emplace_back( cur_end.id(), new_edge_id );
+                    
+                    if ( m_edge_index )
+                    {
+                        m_edge_index->insert( new_edge_id, new_edge.data() );
+                    }
+                    
+                    out.push_back( new_edge.make_ref() );
                 }
                 
-                void remove_pred_edge_id( edge_id pred_edge )
+                link_edges( succ_links, &node::template add_succ_edge_ids<edge_id*> );
+                link_edges( pred_links, &node::template add_pred_edge_ids<edge_id*> );
+                
+                for ( const auto& ref : out )
                 {
-                    m_pred_edges.erase( pred_edge );
-                    return;
+                    notify( &listener_type::on_add_edge, ref );
                 }
                 
-                void remove_succ_edge_id( edge_id succ_edge )
+                return out;
+            }
+            
+            /**
+             * Removes node.
+             * Invalidates all refs to this node and all refs to neighbour edges
+             * as all neighbour edges are also removed.
+             * Edges are erased from adjacency of neighbours only, adjacency of removed
+             * node is scanned in place and dropped with it.
+             */
+            void remove_node( const node_ref<Tnode,Tedge,Tstorage>& rm_node_ref )
+            {
+                if ( m_compaction_deferred )
                 {
-                    m_succ_edges.erase( succ_edge );
+                    erase_node_lazily( rm_node_ref.id() );
                     return;
                 }
                 
-                std::set<edge_id>& preds()
+                node& rm_node = m_nodes.at( rm_node_ref.id() );
+                
+                // self loops are both pred and succ edges, they are removed as succ edges
+                for ( auto e : rm_node.preds() )
                 {
-                    return m_pred_edges;
+                    const edge& rm_edge = m_edges.at( e );
+                    if ( rm_edge.pred() == rm_node_ref.id() )
+                    {
+                        continue;
+                    }
+                    notify( &listener_type::on_remove_edge, rm_edge.make_ref() );
+                    m_nodes.at( rm_edge.pred() ).remove_succ_edge_id( e );
+                    if ( m_edge_index )
+                    {
+                        m_edge_index->erase( e );
+                    }
+                    m_edges.erase( e );
                 }
-                
-                std::set<edge_id>& succs()
+                for ( auto e : rm_node.succs() )
                 {
-                    return m_succ_edges;
+                    const edge& rm_edge = m_edges.at( e );
+                    notify( &listener_type::on_remove_edge, rm_edge.make_ref() );
+                    if ( rm_edge.succ() != rm_node_ref.id() )
+                    {
+                        m_nodes.at( rm_edge.succ() ).remove_pred_edge_id( e );
+                    }
+                    if ( m_edge_index )
+                    {
+                        m_edge_index->erase( e );
+                    }
+                    m_edges.erase( e );
                 }
+                rm_node.preds().clear();
+                rm_node.succs().clear();
+                
+                notify( &listener_type::on_remove_node, rm_node_ref );
                 
-                node_ref<Tnode,Tedge> make_ref() const
+                if ( m_node_index )
                 {
-                    return node_ref<Tnode,Tedge>( m_graph_p, m_id );
+                    m_node_index->erase( rm_node_ref.id() );
                 }
-            };
-            
-            /****************************************************************************/
+                
+                m_nodes.erase( rm_node_ref.id() );
+                return;
+            }
             
             /**
-             * Edge class.
-             * Its pred and succ are unchangeable.
+             * Removes edge. Invalidates all refs to this edge.
              */
-            class edge
+            void remove_edge( const edge_ref<Tnode,Tedge,Tstorage>& rm_edge_ref )
             {
-            private:
-                Tedge m_data;
-            
-                // these fields are set once in constructor and then cannot be changed
-                const edge_id                m_id;
-                orgraph<Tnode,Tedge> * const m_graph_p;
-                const node_id m_pred_node;
-                const node_id m_succ_node;
-                
-            public:
-                edge( orgraph<Tnode,Tedge> * const graph_p, const edge_id id,
-                      node_id pred_node, node_id succ_node ) :
-                    m_id( id ),
-                    m_graph_p( graph_p ),
-                    m_pred_node( pred_node ),
-                    m_succ_node( succ_node )
-                {}
-                edge( orgraph<Tnode,Tedge> * const graph_p, const edge_id id,
-                      const Tnode& data,
-                      const node_id pred_node, const node_id succ_node ) :
-                    m_id( id ),
-                    m_graph_p( graph_p ),
-                    m_data( data ),
-                    m_pred_node( pred_node ),
-                    m_succ_node( succ_node )
-                {}
-                
-                Tedge& data()
+                if ( m_compaction_deferred )
                 {
-                    return m_data;
+                    erase_edge_lazily( rm_edge_ref.id() );
+                    return;
                 }
                 
-                const Tedge data() const
-                {
-                    return m_data;
-                }
+                notify( &listener_type::on_remove_edge, rm_edge_ref );
                 
-                const edge_id id() const
-                {
-                    return m_id;
-                }
+                node_id pred_node_id = m_edges.at( rm_edge_ref.id() ).pred();
+                m_nodes.at( pred_node_id ).remove_succ_edge_id( rm_edge_ref.id() );
                 
-                const node_id pred() const
+                node_id succ_node_id = m_edges.at( rm_edge_ref.id() ).succ();
+                m_nodes.at( succ_node_id ).remove_pred_edge_id( rm_edge_ref.id() );
+                
+                if ( m_edge_index )
                 {
-                    return m_pred_node;
+                    m_edge_index->erase( rm_edge_ref.id() );
                 }
                 
-                const node_id succ() const
+                m_edges.erase( rm_edge_ref.id() );
+                return;
+            }
+            
+            /**
+             * Removes range of nodes with their edges in time linear in number of
+             * removed nodes and degrees of their neighbours: edges are erased from
+             * storage first, then adjacency of every touched neighbour is compacted once.
+             * Range can repeat nodes and have nodes removed already.
+             */
+            template <typename Titerator>
+            void remove_nodes( Titerator first, Titerator last )
+            {
+                for ( ; first != last; first++ )
                 {
-                    return m_succ_node;
+                    if ( m_nodes.contains( first->id() ) )
+                    {
+                        erase_node_lazily( first->id() );
+                    }
                 }
-                
-                edge_ref<Tnode,Tedge> make_ref() const
+                if ( !m_compaction_deferred )
                 {
-                    return edge_ref<Tnode,Tedge>( m_graph_p, m_id );
+                    compact();
                 }
-            };
+                return;
+            }
             
-            /*****************************************************************************
-                                                Data
-            *****************************************************************************/
-        private:
             /**
-             * Data of orgraph.
+             * Removes range of edges, adjacency of every touched node is compacted once.
+             * Range can repeat edges and have edges removed already.
              */
-            std::map< node_id, node > m_nodes;
-            std::map< edge_id, edge > m_edges;
-            
-            node_id next_node_id = node_id( 0 );
-            edge_id next_edge_id = edge_id( 0 );
+            template <typename Titerator>
+            void remove_edges( Titerator first, Titerator last )
+            {
+                for ( ; first != last; first++ )
+                {
+                    if ( m_edges.contains( first->id() ) )
+                    {
+                        erase_edge_lazily( first->id() );
+                    }
+                }
+                if ( !m_compaction_deferred )
+                {
+                    compact();
+                }
+                return;
+            }
             
-            /*****************************************************************************
-                                          Public interface
-            *****************************************************************************/
-        public:
             /**
-             * Adds node.
-             * Returns: ref to created node.
+             * Switches graph to lazy removal: remove_node and remove_edge leave ids of
+             * removed edges in adjacency of nodes as tombstones until compact().
+             * Until then graph can only get nodes and edges added and removed,
+             * adjacency of nodes (pred/succ edges and nodes, adapters, freeze)
+             * should not be read.
              */
-            node_ref<Tnode,Tedge> add_node( const Tnode& new_node_data )
+            void defer_compaction()
             {
-                node new_node( this, next_node_id, new_node_data );
-                auto [it,success] = m_nodes.insert( { next_node_id, new_node } );
-#ifdef DEBUG_DS_ORGRAPH
-                assert( success );
-#endif /* DEBUG_DS_ORGRAPH */
-                node_ref<Tnode,Tedge> ref = it->second.make_ref();
-                
-                next_node_id = next_node_id.next();
-                
-                return ref;
+                m_compaction_deferred = true;
+                return;
             }
             
             /**
-             * Adds edge.
-             * Returns: ref to created edge.
+             * Drops tombstones from adjacency of nodes and ends lazy removal.
              */
-            edge_ref<Tnode,Tedge> add_edge( const Tedge& new_edge_data,
-                                            node_ref<Tnode,Tedge> node_start,
-                                            node_ref<Tnode,Tedge> node_end )
+            void compact()
             {
-                edge new_edge( this, next_edge_id, new_edge_data,
-                               node_start.id(), node_end.id() );
-                auto [it,success] = m_edges.insert( { next_edge_id, new_edge } );
-#ifdef DEBUG_DS_ORGRAPH
-                assert( success );
-#endif /* DEBUG_DS_ORGRAPH */
-                edge_ref<Tnode,Tedge> ref = it->second.make_ref();
-                
-                next_edge_id = next_edge_id.next();
-                
-                m_nodes.at( node_start.id() ).add_succ_edge_id( new_edge.id() );
-                m_nodes.at( node_end.id() ).add_pred_edge_id( new_edge.id() );
+                std::sort( m_dirty_nodes.begin(), m_dirty_nodes.end() );
+                m_dirty_nodes.erase( std::unique( m_dirty_nodes.begin(), m_dirty_nodes.end() ),
+                                     m_dirty_nodes.end() );
                 
-                return ref;
+                auto is_tombstone = [this]( const edge_id& e )
+                                    {
+                                        return !m_edges.contains( e );
+                                    };
+                for ( const auto& cur_node_id : m_dirty_nodes )
+                {
+                    if ( m_nodes.contains( cur_node_id ) )
+                    {
+                        node& cur_node = m_nodes.at( cur_node_id );
+                        cur_node.preds().erase_if( is_tombstone );
+                        cur_node.succs().erase_if( is_tombstone );
+                    }
+                }
+                m_dirty_nodes.clear();
+                m_compaction_deferred = false;
+                return;
             }
             
             /**
-             * Removes node.
-             * Invalidates all refs to this node and all refs to neighbour edges
-             * as all neighbour edges are also removed.
+             * Builds hash index of node payloads, so find_node and find_nodes take O(1)
+             * on average instead of scanning all nodes.
+             * Index is kept in sync by add_node, remove_node and by writes through
+             * node_ref::operator*.
+             * Note: node is marked changed when operator* gives its payload, and it is
+             *       rehashed by next find. Writes through reference kept after that find
+             *       are not seen by index, so call operator* again for every write.
+             * Note: find methods rehash changed payloads, so with index even const finds
+             *       change graph and should not run concurrently with each other.
              */
-            void remove_node( const node_ref<Tnode,Tedge>& rm_node_ref )
+            template <typename Thash = std::hash<Tnode>>
+            void enable_node_index( Thash hasher = Thash() )
             {
-                std::vector<edge_id> copy_pred_edges;
-                for ( auto e : m_nodes.at( rm_node_ref.id() ).preds() )
-                {
-                    copy_pred_edges.push_back( e );
-                }
-                for ( auto e : copy_pred_edges )
-                {
-                    remove_edge( m_edges.at( e ).make_ref() );
-                }
-                
-                std::vector<edge_id> copy_succ_edges;
-                for ( auto e : m_nodes.at( rm_node_ref.id() ).succs() )
-                {
-                    copy_succ_edges.push_back( e );
-                }
-                for ( auto e : copy_succ_edges )
+                m_node_index.emplace( hasher );
+                for ( const auto& cur_node : m_nodes )
                 {
-                    remove_edge( m_edges.at( e ).make_ref() );
+                    m_node_index->insert( cur_node.id(), cur_node.data() );
                 }
-                
-                m_nodes.erase( rm_node_ref.id() );
                 return;
             }
             
+            void disable_node_index()
+            {
+                m_node_index.reset();
+                return;
+            }
+            
+            bool has_node_index() const
+            {
+                return m_node_index.has_value();
+            }
+            
             /**
-             * Removes edge. Invalidates all refs to this edge.
+             * Builds hash index of edge payloads, so find_edge and find_edges take O(1)
+             * on average instead of scanning all edges.
+             * Index is kept in sync by add_edge, remove_edge and by writes through
+             * edge_ref::operator*.
+             * Note: edge is marked changed when operator* gives its payload, and it is
+             *       rehashed by next find. Writes through reference kept after that find
+             *       are not seen by index, so call operator* again for every write.
+             * Note: find methods rehash changed payloads, so with index even const finds
+             *       change graph and should not run concurrently with each other.
              */
-            void remove_edge( const edge_ref<Tnode,Tedge>& rm_edge_ref )
+            template <typename Thash = std::hash<Tedge>>
+            void enable_edge_index( Thash hasher = Thash() )
             {
-                node_id pred_node_id = m_edges.at( rm_edge_ref.id() ).pred();
-                m_nodes.at( pred_node_id ).remove_succ_edge_id( rm_edge_ref.id() );
-                
-                node_id succ_node_id = m_edges.at( rm_edge_ref.id() ).succ();
-                m_nodes.at( succ_node_id ).remove_pred_edge_id( rm_edge_ref.id() );
-                
-                m_edges.erase( rm_edge_ref.id() );
+                m_edge_index.emplace( hasher );
+                for ( const auto& cur_edge : m_edges )
+                {
+                    m_edge_index->insert( cur_edge.id(), cur_edge.data() );
+                }
+                return;
+            }
+            
+            void disable_edge_index()
+            {
+                m_edge_index.reset();
                 return;
             }
             
+            bool has_edge_index() const
+            {
+                return m_edge_index.has_value();
+            }
+            
             /**
              * Finds node with specified data.
              * Returns: ref to found node.
              * Note: Tnode should have implemented operator==.
+             * Note: if several nodes have such data, without index the one with the least id
+             *       is found, with index any of them.
+             * Note: with index it refreshes index and is not thread-safe (see enable_node_index).
              */
-            std::optional< node_ref<Tnode,Tedge> > find_node( Tnode node_data ) const
+            std::optional< node_ref<Tnode,Tedge,Tstorage> > find_node( const Tnode& node_data ) const
             {
-                for ( const auto& [id, cur_node] : m_nodes )
+                if ( m_node_index )
+                {
+                    refresh_node_index();
+                    auto [it, it_end] = m_node_index->candidates( node_data );
+                    for ( ; it != it_end; it++ )
+                    {
+                        const node& cur_node = m_nodes.at( it->second );
+                        if ( cur_node.data() == node_data )
+                        {
+                            return std::optional{ cur_node.make_ref() };
+                        }
+                    }
+                    return std::nullopt;
+                }
+                
+#ifdef STATS_DS_ORGRAPH
+                add_stat( stats_counters.find_scans );
+#endif /* STATS_DS_ORGRAPH */
+                for ( const auto& cur_node : m_nodes )
                 {
+#ifdef STATS_DS_ORGRAPH
+                    add_stat( stats_counters.find_scanned );
+#endif /* STATS_DS_ORGRAPH */
                     if ( cur_node.data() == node_data )
                     {
                         return std::optional{ cur_node.make_ref() };
@@ -425,15 +2303,82 @@ namespace ds
                 return std::nullopt;
             }
             
+            /**
+             * Finds all nodes with specified data.
+             * Note: Tnode should have implemented operator==.
+             */
+            std::vector< node_ref<Tnode,Tedge,Tstorage> > find_nodes( const Tnode& node_data ) const
+            {
+                std::vector< node_ref<Tnode,Tedge,Tstorage> > out;
+#ifdef STATS_DS_ORGRAPH
+                add_stat( stats_counters.ref_vectors );
+#endif /* STATS_DS_ORGRAPH */
+                
+                if ( m_node_index )
+                {
+                    refresh_node_index();
+                    auto [it, it_end] = m_node_index->candidates( node_data );
+                    for ( ; it != it_end; it++ )
+                    {
+                        const node& cur_node = m_nodes.at( it->second );
+                        if ( cur_node.data() == node_data )
+                        {
+                            out.push_back( cur_node.make_ref() );
+                        }
+                    }
+                    return out;
+                }
+                
+#ifdef STATS_DS_ORGRAPH
+                add_stat( stats_counters.find_scans );
+#endif /* STATS_DS_ORGRAPH */
+                for ( const auto& cur_node : m_nodes )
+                {
+#ifdef STATS_DS_ORGRAPH
+                    add_stat( stats_counters.find_scanned );
+#endif /* STATS_DS_ORGRAPH */
+                    if ( cur_node.data() == node_data )
+                    {
+                        out.push_back( cur_node.make_ref() );
+                    }
+                }
+                
+                return out;
+            }
+            
             /**
              * Finds edge with specified data.
              * Returns: ref to found edge.
              * Note: Tedge should have implemented operator==.
+             * Note: if several edges have such data, without index the one with the least id
+             *       is found, with index any of them.
+             * Note: with index it refreshes index and is not thread-safe (see enable_edge_index).
              */
-            std::optional< edge_ref<Tnode,Tedge> > find_edge( Tedge edge_data ) const
+            std::optional< edge_ref<Tnode,Tedge,Tstorage> > find_edge( const Tedge& edge_data ) const
             {
-                for ( const auto& [id, cur_edge] : m_edges )
+                if ( m_edge_index )
+                {
+                    refresh_edge_index();
+                    auto [it, it_end] = m_edge_index->candidates( edge_data );
+                    for ( ; it != it_end; it++ )
+                    {
+                        const edge& cur_edge = m_edges.at( it->second );
+                        if ( cur_edge.data() == edge_data )
+                        {
+                            return std::optional{ cur_edge.make_ref() };
+                        }
+                    }
+                    return std::nullopt;
+                }
+                
+#ifdef STATS_DS_ORGRAPH
+                add_stat( stats_counters.find_scans );
+#endif /* STATS_DS_ORGRAPH */
+                for ( const auto& cur_edge : m_edges )
                 {
+#ifdef STATS_DS_ORGRAPH
+                    add_stat( stats_counters.find_scanned );
+#endif /* STATS_DS_ORGRAPH */
                     if ( cur_edge.data() == edge_data )
                     {
                         return std::optional{ cur_edge.make_ref() };
@@ -443,14 +2388,60 @@ namespace ds
                 return std::nullopt;
             }
             
+            /**
+             * Finds all edges with specified data.
+             * Note: Tedge should have implemented operator==.
+             */
+            std::vector< edge_ref<Tnode,Tedge,Tstorage> > find_edges( const Tedge& edge_data ) const
+            {
+                std::vector< edge_ref<Tnode,Tedge,Tstorage> > out;
+#ifdef STATS_DS_ORGRAPH
+                add_stat( stats_counters.ref_vectors );
+#endif /* STATS_DS_ORGRAPH */
+                
+                if ( m_edge_index )
+                {
+                    refresh_edge_index();
+                    auto [it, it_end] = m_edge_index->candidates( edge_data );
+                    for ( ; it != it_end; it++ )
+                    {
+                        const edge& cur_edge = m_edges.at( it->second );
+                        if ( cur_edge.data() == edge_data )
+                        {
+                            out.push_back( cur_edge.make_ref() );
+                        }
+                    }
+                    return out;
+                }
+                
+#ifdef STATS_DS_ORGRAPH
+                add_stat( stats_counters.find_scans );
+#endif /* STATS_DS_ORGRAPH */
+                for ( const auto& cur_edge : m_edges )
+                {
+#ifdef STATS_DS_ORGRAPH
+                    add_stat( stats_counters.find_scanned );
+#endif /* STATS_DS_ORGRAPH */
+                    if ( cur_edge.data() == edge_data )
+                    {
+                        out.push_back( cur_edge.make_ref() );
+                    }
+                }
+                
+                return out;
+            }
+            
             /**
              * Gives a container of refs to all nodes of graph.
              */
-            std::vector< node_ref<Tnode,Tedge> > nodes() const
+            std::vector< node_ref<Tnode,Tedge,Tstorage> > nodes() const
             {
-                std::vector< node_ref<Tnode,Tedge> > out;
+                std::vector< node_ref<Tnode,Tedge,Tstorage> > out;
+#ifdef STATS_DS_ORGRAPH
+                add_stat( stats_counters.ref_vectors );
+#endif /* STATS_DS_ORGRAPH */
                 
-                for ( const auto& [id, cur_node] : m_nodes )
+                for ( const auto& cur_node : m_nodes )
                 {
                     out.push_back( cur_node.make_ref() );
                 }
@@ -461,62 +2452,121 @@ namespace ds
             /**
              * Gives a container of refs to all edges of graph.
              */
-            std::vector< edge_ref<Tnode,Tedge> > edges() const
+            std::vector< edge_ref<Tnode,Tedge,Tstorage> > edges() const
             {
-                std::vector< edge_ref<Tnode,Tedge> > out;
+                std::vector< edge_ref<Tnode,Tedge,Tstorage> > out;
+#ifdef STATS_DS_ORGRAPH
+                add_stat( stats_counters.ref_vectors );
+#endif /* STATS_DS_ORGRAPH */
                 
-                for ( const auto& [id, cur_edge] : m_edges )
+                for ( const auto& cur_edge : m_edges )
                 {
                     out.push_back( cur_edge.make_ref() );
                 }
                 
                 return out;
             }
+            
+            /**
+             * Checks if handle refers to node or edge of graph.
+             */
+            bool contains( const node_id& id ) const
+            {
+                return m_nodes.contains( id );
+            }
+            
+            bool contains( const edge_id& id ) const
+            {
+                return m_edges.contains( id );
+            }
+            
+            /**
+             * Gives ref by handle.
+             * Throws std::out_of_range if there is no such node or edge in graph.
+             */
+            node_ref<Tnode,Tedge,Tstorage> ref( const node_id& id ) const
+            {
+                return m_nodes.at( id ).make_ref();
+            }
+            
+            edge_ref<Tnode,Tedge,Tstorage> ref( const edge_id& id ) const
+            {
+                return m_edges.at( id ).make_ref();
+            }
+            
+            /**
+             * Gives data by handle without making ref.
+             * Throws std::out_of_range if there is no such node or edge in graph.
+             */
+            const Tnode& data( const node_id& id ) const
+            {
+                return m_nodes.at( id ).data();
+            }
+            
+            const Tedge& data( const edge_id& id ) const
+            {
+                return m_edges.at( id ).data();
+            }
         };
         
         /********************************************************************************/
         
-        template <typename Tnode, typename Tedge>
+        template <typename Tnode, typename Tedge, typename Tstorage>
         class node_ref
         {
             /*****************************************************************************
                                     Inner types and friend types
             *****************************************************************************/
-            friend class edge_ref<Tnode,Tedge>;
-            friend class orgraph<Tnode,Tedge>;
+            friend class edge_ref<Tnode,Tedge,Tstorage>;
+            friend class orgraph<Tnode,Tedge,Tstorage>;
+            friend class csr_view<Tnode,Tedge>;
+            friend class graph_adapter< orgraph<Tnode,Tedge,Tstorage> >;
             
             /*****************************************************************************
                                                 Data
             *****************************************************************************/
         private:
-            const typename orgraph<Tnode,Tedge>::node_id m_id;
-            orgraph<Tnode,Tedge> * const m_graph_p;
+            node_id                        m_id;
+            orgraph<Tnode,Tedge,Tstorage> *m_graph_p;
             
             /*****************************************************************************
                                 Accessible by friend classes interface
             *****************************************************************************/
         private:
-            const typename orgraph<Tnode,Tedge>::node_id id() const
-            {
-                return m_id;
-            }
-            
-            node_ref( orgraph<Tnode,Tedge> * const graph_p,
-                      const typename orgraph<Tnode,Tedge>::node_id id ) :
+            node_ref( orgraph<Tnode,Tedge,Tstorage> * const graph_p,
+                      const node_id id ) :
                 m_id( id ),
                 m_graph_p( graph_p )
             {}
             
+            template <typename Titerator, typename Tadjacency>
+            range<Titerator> make_range( const Tadjacency& adjacency ) const
+            {
+                return range<Titerator>( Titerator( m_graph_p, adjacency.begin() ),
+                                         Titerator( m_graph_p, adjacency.end() ) );
+            }
+            
             /*****************************************************************************
                                           Public interface
             *****************************************************************************/
         public:
+            /**
+             * Handle of node, stays valid while node is in graph.
+             */
+            node_id id() const
+            {
+                return m_id;
+            }
+            
             /**
              * Dereference operator for accessing data of node.
+             * Note: it is seen by listeners and index as write, use read() to only read.
              */
             Tnode& operator*()
             {
-                return m_graph_p->m_nodes.at( m_id ).data();
+                auto& cur_node = m_graph_p->m_nodes.at( m_id );
+                m_graph_p->touch_node( cur_node );
+                return cur_node.data();
             }
             
             /**
@@ -527,14 +2577,25 @@ namespace ds
                 return m_graph_p->m_nodes.at( m_id ).data();
             }
             
+            /**
+             * Gives data of node for reading, is not seen as write by listeners and index.
+             */
+            const Tnode& read() const
+            {
+                return m_graph_p->m_nodes.at( m_id ).data();
+            }
+            
             /**
              * Gives a container of refs to all pred edges of node.
              */
-            std::vector< edge_ref<Tnode,Tedge> > pred_edges() const
+            std::vector< edge_ref<Tnode,Tedge,Tstorage> > pred_edges() const
             {
-                std::vector< edge_ref<Tnode,Tedge> > out;
+                std::vector< edge_ref<Tnode,Tedge,Tstorage> > out;
+#ifdef STATS_DS_ORGRAPH
+                add_stat( stats_counters.ref_vectors );
+#endif /* STATS_DS_ORGRAPH */
                 
-                std::set< typename orgraph<Tnode,Tedge>::edge_id >& edge_ids =
+                typename orgraph<Tnode,Tedge,Tstorage>::edge_id_set& edge_ids =
                     m_graph_p->m_nodes.at( m_id ).preds();
                 for ( const auto& cur_edge_id : edge_ids )
                 {
@@ -547,15 +2608,18 @@ namespace ds
             /**
              * Gives a container of refs to all pred nodes of node.
              */
-            std::vector< node_ref<Tnode,Tedge> > pred_nodes() const
+            std::vector< node_ref<Tnode,Tedge,Tstorage> > pred_nodes() const
             {
-                std::vector< node_ref<Tnode,Tedge> > out;
+                std::vector< node_ref<Tnode,Tedge,Tstorage> > out;
+#ifdef STATS_DS_ORGRAPH
+                add_stat( stats_counters.ref_vectors );
+#endif /* STATS_DS_ORGRAPH */
                 
-                std::set< typename orgraph<Tnode,Tedge>::edge_id >& edge_ids =
+                typename orgraph<Tnode,Tedge,Tstorage>::edge_id_set& edge_ids =
                     m_graph_p->m_nodes.at( m_id ).preds();
                 for ( const auto& cur_edge_id : edge_ids )
                 {
-                    typename orgraph<Tnode,Tedge>::node_id cur_node_id =
+                    node_id cur_node_id =
                         m_graph_p->m_edges.at( cur_edge_id ).pred();
                     out.push_back( m_graph_p->m_nodes.at( cur_node_id ).make_ref() );
                 }
@@ -566,11 +2630,14 @@ namespace ds
             /**
              * Gives a container of refs to all succ edges of node.
              */
-            std::vector< edge_ref<Tnode,Tedge> > succ_edges() const
+            std::vector< edge_ref<Tnode,Tedge,Tstorage> > succ_edges() const
             {
-                std::vector< edge_ref<Tnode,Tedge> > out;
+                std::vector< edge_ref<Tnode,Tedge,Tstorage> > out;
+#ifdef STATS_DS_ORGRAPH
+                add_stat( stats_counters.ref_vectors );
+#endif /* STATS_DS_ORGRAPH */
                 
-                std::set< typename orgraph<Tnode,Tedge>::edge_id >& edge_ids =
+                typename orgraph<Tnode,Tedge,Tstorage>::edge_id_set& edge_ids =
                     m_graph_p->m_nodes.at( m_id ).succs();
                 for ( const auto& cur_edge_id : edge_ids )
                 {
@@ -583,33 +2650,102 @@ namespace ds
             /**
              * Gives a container of refs to all succ nodes of node.
              */
-            std::vector< node_ref<Tnode,Tedge> > succ_nodes() const
+            std::vector< node_ref<Tnode,Tedge,Tstorage> > succ_nodes() const
             {
-                std::vector< node_ref<Tnode,Tedge> > out;
+                std::vector< node_ref<Tnode,Tedge,Tstorage> > out;
+#ifdef STATS_DS_ORGRAPH
+                add_stat( stats_counters.ref_vectors );
+#endif /* STATS_DS_ORGRAPH */
                 
-                std::set< typename orgraph<Tnode,Tedge>::edge_id >& edge_ids =
+                typename orgraph<Tnode,Tedge,Tstorage>::edge_id_set& edge_ids =
                     m_graph_p->m_nodes.at( m_id ).succs();
                 for ( const auto& cur_edge_id : edge_ids )
                 {
-                    typename orgraph<Tnode,Tedge>::node_id cur_node_id =
+                    node_id cur_node_id =
                         m_graph_p->m_edges.at( cur_edge_id ).succ();
                     out.push_back( m_graph_p->m_nodes.at( cur_node_id ).make_ref() );
                 }
                 
                 return out;
             }
+            
+            /**
+             * Gives a lazy range of refs to all pred edges of node.
+             * Unlike pred_edges() nothing is allocated.
+             */
+            range< typename orgraph<Tnode,Tedge,Tstorage>::adjacent_edge_iterator >
+            pred_edges_range() const
+            {
+                return make_range< typename orgraph<Tnode,Tedge,Tstorage>::adjacent_edge_iterator >(
+                    m_graph_p->m_nodes.at( m_id ).preds() );
+            }
+            
+            /**
+             * Gives a lazy range of refs to all pred nodes of node.
+             * Unlike pred_nodes() nothing is allocated.
+             */
+            range< typename orgraph<Tnode,Tedge,Tstorage>::pred_node_iterator >
+            pred_nodes_range() const
+            {
+                return make_range< typename orgraph<Tnode,Tedge,Tstorage>::pred_node_iterator >(
+                    m_graph_p->m_nodes.at( m_id ).preds() );
+            }
+            
+            /**
+             * Gives a lazy range of refs to all succ edges of node.
+             * Unlike succ_edges() nothing is allocated.
+             */
+            range< typename orgraph<Tnode,Tedge,Tstorage>::adjacent_edge_iterator >
+            succ_edges_range() const
+            {
+                return make_range< typename orgraph<Tnode,Tedge,Tstorage>::adjacent_edge_iterator >(
+                    m_graph_p->m_nodes.at( m_id ).succs() );
+            }
+            
+            /**
+             * Gives a lazy range of refs to all succ nodes of node.
+             * Unlike succ_nodes() nothing is allocated.
+             */
+            range< typename orgraph<Tnode,Tedge,Tstorage>::succ_node_iterator >
+            succ_nodes_range() const
+            {
+                return make_range< typename orgraph<Tnode,Tedge,Tstorage>::succ_node_iterator >(
+                    m_graph_p->m_nodes.at( m_id ).succs() );
+            }
+            
+            /**
+             * Refs are equal if they refer to the same node of the same graph.
+             */
+            bool operator==( const node_ref& r ) const
+            {
+                return ( m_id == r.m_id && m_graph_p == r.m_graph_p );
+            }
+            
+            bool operator!=( const node_ref& r ) const
+            {
+                return !( *this == r );
+            }
+            
+            /**
+             * Refs are ordered by graph and by id, so they can be sorted.
+             */
+            bool operator<( const node_ref& r ) const
+            {
+                return ( m_graph_p != r.m_graph_p ) ? std::less<const void*>()( m_graph_p, r.m_graph_p )
+                                                    : ( m_id < r.m_id );
+            }
         };
         
         /********************************************************************************/
         
-        template <typename Tnode, typename Tedge>
+        template <typename Tnode, typename Tedge, typename Tstorage>
         class edge_ref
         {
             /*****************************************************************************
                                     Inner types and friend types
             *****************************************************************************/
-            friend class node_ref<Tnode,Tedge>;
-            friend class orgraph<Tnode,Tedge>;
+            friend class node_ref<Tnode,Tedge,Tstorage>;
+            friend class orgraph<Tnode,Tedge,Tstorage>;
             
         private:
             
@@ -617,20 +2753,15 @@ namespace ds
                                                 Data
             *****************************************************************************/
         private:
-            const typename orgraph<Tnode,Tedge>::edge_id m_id;
-            orgraph<Tnode,Tedge> * const m_graph_p;
+            edge_id                        m_id;
+            orgraph<Tnode,Tedge,Tstorage> *m_graph_p;
             
             /*****************************************************************************
                                 Accessible by friend classes interface
             *****************************************************************************/
         private:
-            const typename orgraph<Tnode,Tedge>::edge_id id() const
-            {
-                return m_id;
-            }
-            
-            edge_ref( orgraph<Tnode,Tedge> * const graph_p,
-                      const typename orgraph<Tnode,Tedge>::edge_id id ) :
+            edge_ref( orgraph<Tnode,Tedge,Tstorage> * const graph_p,
+                      const edge_id id ) :
                 m_id( id ),
                 m_graph_p( graph_p )
             {}
@@ -639,12 +2770,23 @@ namespace ds
                                           Public interface
             *****************************************************************************/
         public:
+            /**
+             * Handle of edge, stays valid while edge is in graph.
+             */
+            edge_id id() const
+            {
+                return m_id;
+            }
+            
             /**
              * Dereference operator for accessing data of edge.
+             * Note: it is seen by listeners and index as write, use read() to only read.
              */
             Tedge& operator*()
             {
-                return m_graph_p->m_edges.at( m_id ).data();
+                auto& cur_edge = m_graph_p->m_edges.at( m_id );
+                m_graph_p->touch_edge( cur_edge );
+                return cur_edge.data();
             }
             
             /**
@@ -655,12 +2797,20 @@ namespace ds
                 return m_graph_p->m_edges.at( m_id ).data();
             }
             
+            /**
+             * Gives data of edge for reading, is not seen as write by listeners and index.
+             */
+            const Tedge& read() const
+            {
+                return m_graph_p->m_edges.at( m_id ).data();
+            }
+            
             /**
              * Dereference operator for accessing data of edge.
              */
-            const node_ref<Tnode,Tedge> pred() const
+            const node_ref<Tnode,Tedge,Tstorage> pred() const
             {
-                typename orgraph<Tnode,Tedge>::node_id pred_node_id =
+                node_id pred_node_id =
                     m_graph_p->m_edges.at( m_id ).pred();
                 return m_graph_p->m_nodes.at( pred_node_id ).make_ref();
             }
@@ -668,18 +2818,64 @@ namespace ds
             /**
              * Dereference operator for accessing data of edge.
              */
-            const node_ref<Tnode,Tedge> succ() const
+            const node_ref<Tnode,Tedge,Tstorage> succ() const
             {
-                typename orgraph<Tnode,Tedge>::node_id succ_node_id =
+                node_id succ_node_id =
                     m_graph_p->m_edges.at( m_id ).succ();
                 return m_graph_p->m_nodes.at( succ_node_id ).make_ref();
             }
+            
+            /**
+             * Refs are equal if they refer to the same edge of the same graph.
+             */
+            bool operator==( const edge_ref& r ) const
+            {
+                return ( m_id == r.m_id && m_graph_p == r.m_graph_p );
+            }
+            
+            bool operator!=( const edge_ref& r ) const
+            {
+                return !( *this == r );
+            }
+            
+            /**
+             * Refs are ordered by graph and by id, so they can be sorted.
+             */
+            bool operator<( const edge_ref& r ) const
+            {
+                return ( m_graph_p != r.m_graph_p ) ? std::less<const void*>()( m_graph_p, r.m_graph_p )
+                                                    : ( m_id < r.m_id );
+            }
         };
         
         /********************************************************************************/
     }
 }
 
+/**
+ * Refs are hashed by ids, refs of different graphs with equal ids only collide.
+ */
+namespace std
+{
+    template <typename Tnode, typename Tedge, typename Tstorage>
+    struct hash< ds::orgraph::node_ref<Tnode,Tedge,Tstorage> >
+    {
+        size_t operator()( const ds::orgraph::node_ref<Tnode,Tedge,Tstorage>& ref ) const
+        {
+            return hash<ds::orgraph::node_id>()( ref.id() );
+        }
+    };
+    
+    template <typename Tnode, typename Tedge, typename Tstorage>
+    struct hash< ds::orgraph::edge_ref<Tnode,Tedge,Tstorage> >
+    {
+        size_t operator()( const ds::orgraph::edge_ref<Tnode,Tedge,Tstorage>& ref ) const
+        {
+            return hash<ds::orgraph::edge_id>()( ref.id() );
+        }
+    };
+}
+
 /****************************************************************************************/
 
 #if 0
@@ -711,7 +2907,7 @@ namespace ds
             int32_t m_id;
             
         public:
-            node_id( int32_t new_id ) : m_id( new_id ) {}
+            explicit node_id( int32_t new_id ) : m_id( new_id ) {}
             
             int32_t& operator() ()
             {
@@ -749,7 +2945,7 @@ namespace ds
             int32_t m_id;
             
         public:
-            edge_id( int32_t new_id ) : m_id( new_id ) {}
+            explicit edge_id( int32_t new_id ) : m_id( new_id ) {}
             
             int32_t& operator() ()
             {
@@ -0,0 +1,277 @@
+/**
+ * Change-log of oriented graph.
+ */
+#pragma once
+
+/****************************************************************************************/
+
+/**
+ * orgraph_changelog is subscribed to orgraph as listener and records every change
+ * of it: added and removed nodes and edges and writes of payloads through
+ * node_ref::operator* and edge_ref::operator*. Recorded changes are passed to
+ * change subscribers in batches by dispatch(), so data derived from graph
+ * (counters, caches) is updated by deltas instead of being rebuilt.
+ *
+ * Change keeps ids, not refs: by the time batch is dispatched nodes and edges
+ * of its changes can be already removed. Removed edge keeps ids of its ends.
+ * Write is recorded when non-const operator* is called, before payload is
+ * actually changed, so it means "payload may be changed". Repeated writes
+ * of the same node or edge in a row are recorded once. Plain reads through
+ * non-const refs are recorded as writes too, so read payloads by
+ * node_ref::read() and edge_ref::read(), they are not recorded.
+ *
+ * Batches are dispatched only by explicit dispatch() call, never from inside
+ * graph methods, so subscribers see graph in consistent state. Subscribers can
+ * subscribe and unsubscribe others and themselves from on_changes.
+ *
+ * Usage:
+ *      ds::orgraph::orgraph_changelog<Tnode,Tedge> log( graph );
+ *      log.subscribe( &degree_counter );
+ *      ... graph.add_edge(), graph.remove_node(), *cur_node_ref = data ...
+ *      log.dispatch();
+ */
+
+/****************************************************************************************/
+
+#include <vector>
+#include <algorithm>
+
+#include <stdint.h>
+
+#include "orgraph.hpp"
+
+/****************************************************************************************/
+
+namespace ds
+{
+    namespace orgraph
+    {
+        /********************************************************************************/
+        
+        enum class change_kind : uint8_t
+        {
+            add_node,
+            add_edge,
+            remove_node,
+            remove_edge,
+            write_node,
+            write_edge
+        };
+        
+        /**
+         * Recorded change. Node changes keep node, edge changes keep edge and its ends.
+         */
+        struct orgraph_change
+        {
+            change_kind kind;
+            node_id     node;
+            edge_id     edge;
+            node_id     pred;
+            node_id     succ;
+        };
+        
+        /********************************************************************************/
+        
+        /**
+         * Subscriber of change batches, is subscribed by orgraph_changelog::subscribe.
+         */
+        class orgraph_change_subscriber
+        {
+        public:
+            virtual ~orgraph_change_subscriber() = default;
+            
+            /**
+             * Is called by dispatch with changes recorded since previous batch, in order.
+             */
+            virtual void on_changes( const std::vector<orgraph_change>& batch ) = 0;
+        };
+        
+        /********************************************************************************/
+        
+        /**
+         * Object should not outlive graph, it unsubscribes itself in destructor.
+         */
+        template <typename Tnode, typename Tedge, typename Tstorage = map_storage>
+        class orgraph_changelog : public orgraph_listener<Tnode,Tedge,Tstorage>
+        {
+        public:
+            using graph_type = orgraph<Tnode,Tedge,Tstorage>;
+            using node_type  = node_ref<Tnode,Tedge,Tstorage>;
+            using edge_type  = edge_ref<Tnode,Tedge,Tstorage>;
+            
+            /*****************************************************************************
+                                                Data
+            *****************************************************************************/
+        private:
+            graph_type                               &m_graph;
+            std::vector<orgraph_change>               m_changes;
+            std::vector<orgraph_change>               m_batch; // batch being dispatched
+            std::vector<orgraph_change_subscriber*>   m_subscribers;
+            bool                                      m_dispatching = false;
+            
+            /*****************************************************************************
+                                             Inner methods
+            *****************************************************************************/
+        private:
+            void record_node( change_kind kind, const node_type& ref )
+            {
+                m_changes.push_back( orgraph_change{ kind, ref.id(), edge_id(), node_id(), node_id() } );
+                return;
+            }
+            
+            void record_edge( change_kind kind, const edge_type& ref )
+            {
+                m_changes.push_back( orgraph_change{ kind, node_id(), ref.id(),
+                                                     ref.pred().id(), ref.succ().id() } );
+                return;
+            }
+            
+            void on_add_node( const node_type& ref ) override
+            {
+                record_node( change_kind::add_node, ref );
+                return;
+            }
+            
+            void on_add_edge( const edge_type& ref ) override
+            {
+                record_edge( change_kind::add_edge, ref );
+                return;
+            }
+            
+            void on_remove_node( const node_type& ref ) override
+            {
+                record_node( change_kind::remove_node, ref );
+                return;
+            }
+            
+            void on_remove_edge( const edge_type& ref ) override
+            {
+                record_edge( change_kind::remove_edge, ref );
+                return;
+            }
+            
+            void on_touch_node( const node_type& ref ) override
+            {
+                if ( !m_changes.empty() && m_changes.back().kind == change_kind::write_node &&
+                     m_changes.back().node == ref.id() )
+                {
+                    return;
+                }
+                record_node( change_kind::write_node, ref );
+                return;
+            }
+            
+            void on_touch_edge( const edge_type& ref ) override
+            {
+                if ( !m_changes.empty() && m_changes.back().kind == change_kind::write_edge &&
+                     m_changes.back().edge == ref.id() )
+                {
+                    return;
+                }
+                record_edge( change_kind::write_edge, ref );
+                return;
+            }
+            
+            /*****************************************************************************
+                                          Public interface
+            *****************************************************************************/
+        public:
+            /**
+             * Subscribes to changes of graph, current graph is not recorded.
+             */
+            explicit orgraph_changelog( graph_type& graph )
+                : m_graph( graph )
+            {
+                m_graph.subscribe( this );
+            }
+            
+            orgraph_changelog( const orgraph_changelog& ) = delete;
+            orgraph_changelog& operator=( const orgraph_changelog& ) = delete;
+            
+            ~orgraph_changelog() override
+            {
+                m_graph.unsubscribe( this );
+            }
+            
+            /**
+             * Subscribes subscriber to batches.
+             * Subscriber should be unsubscribed before it is destroyed.
+             */
+            void subscribe( orgraph_change_subscriber *subscriber_p )
+            {
+                m_subscribers.push_back( subscriber_p );
+                return;
+            }
+            
+            void unsubscribe( orgraph_change_subscriber *subscriber_p )
+            {
+                m_subscribers.erase( std::remove( m_subscribers.begin(), m_subscribers.end(), subscriber_p ),
+                                     m_subscribers.end() );
+                return;
+            }
+            
+            /**
+             * Changes recorded since last dispatch.
+             */
+            const std::vector<orgraph_change>& changes() const
+            {
+                return m_changes;
+            }
+            
+            bool empty() const
+            {
+                return m_changes.empty();
+            }
+            
+            /**
+             * Passes recorded changes to every subscriber and clears log.
+             * Changes made by subscribers go to the next batch.
+             * Subscriber subscribed during dispatch gets the next batch, subscriber
+             * unsubscribed during dispatch gets nothing more. dispatch() called
+             * from on_changes does nothing and returns 0.
+             * Returns: number of dispatched changes.
+             */
+            size_t dispatch()
+            {
+                if ( m_dispatching || m_changes.empty() )
+                {
+                    return 0;
+                }
+                m_dispatching = true;
+                m_batch.clear();
+                m_batch.swap( m_changes );
+                // on_changes can change subscribers, so they are walked by copy
+                const std::vector<orgraph_change_subscriber*> subscribers = m_subscribers;
+                try
+                {
+                    for ( auto subscriber_p : subscribers )
+                    {
+                        if ( std::find( m_subscribers.begin(), m_subscribers.end(), subscriber_p ) != m_subscribers.end() )
+                        {
+                            subscriber_p->on_changes( m_batch );
+                        }
+                    }
+                } catch ( ... )
+                {
+                    m_dispatching = false;
+                    throw;
+                }
+                m_dispatching = false;
+                return m_batch.size();
+            }
+            
+            /**
+             * Drops recorded changes without dispatching them.
+             */
+            void clear()
+            {
+                m_changes.clear();
+                return;
+            }
+        };
+        
+        /********************************************************************************/
+    }
+}
+
+/****************************************************************************************/
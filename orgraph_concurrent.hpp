@@ -0,0 +1,158 @@
+/**
+ * Concurrent reading and batched writing of oriented graph.
+ */
+#pragma once
+
+/****************************************************************************************/
+
+/**
+ * concurrent_orgraph keeps master orgraph, which is changed only by writer,
+ * and published snapshot of it, which is read by any number of readers.
+ *
+ * Snapshot is immutable frozen CSR view (see orgraph_csr.hpp) tagged by epoch.
+ * Writer applies batch of changes to master graph and publishes new snapshot
+ * atomically (RCU-style): readers holding old snapshot keep reading it, next
+ * readers get the new one. Old snapshot is freed when its last reader drops it.
+ * So readers never wait for writer and never see half-applied batch.
+ *
+ * Publishing freezes whole master graph, O(V+E), so changes should be batched.
+ * Writers are serialized by mutex.
+ *
+ * Usage:
+ *      ds::orgraph::concurrent_orgraph<Tnode,Tedge> graph;
+ *
+ *      // writer
+ *      graph.write( [&]( ds::orgraph::orgraph<Tnode,Tedge>& master )
+ *                   {
+ *                       ... master.add_node(), master.add_edge(), master.remove_node() ...
+ *                   } );
+ *
+ *      // reader
+ *      auto snapshot_p = graph.read();
+ *      for ( auto cur_node : snapshot_p->view.nodes() )
+ *      {
+ *          ...
+ *      }
+ */
+
+/****************************************************************************************/
+
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <utility>
+
+#include <stdint.h>
+
+#include "orgraph.hpp"
+#include "orgraph_csr.hpp"
+
+/****************************************************************************************/
+
+namespace ds
+{
+    namespace orgraph
+    {
+        /********************************************************************************/
+        
+        /**
+         * Published version of graph.
+         */
+        template <typename Tnode, typename Tedge>
+        struct orgraph_snapshot
+        {
+            uint64_t              epoch;
+            csr_view<Tnode,Tedge> view;
+        };
+        
+        /********************************************************************************/
+        
+        template <typename Tnode, typename Tedge, typename Tstorage = map_storage>
+        class concurrent_orgraph
+        {
+        public:
+            using graph_type    = orgraph<Tnode,Tedge,Tstorage>;
+            using snapshot_type = orgraph_snapshot<Tnode,Tedge>;
+            
+            /*****************************************************************************
+                                                Data
+            *****************************************************************************/
+        private:
+            // master graph and epoch of its last publication, are guarded by m_write_mutex
+            std::mutex         m_write_mutex;
+            graph_type         m_graph;
+            uint64_t           m_epoch = 0;
+            
+            // is accessed only by atomic_load/atomic_store
+            std::shared_ptr<const snapshot_type> m_snapshot_p;
+            
+            /*****************************************************************************
+                                             Inner methods
+            *****************************************************************************/
+        private:
+            void publish()
+            {
+                m_epoch++;
+                std::shared_ptr<const snapshot_type> snapshot_p =
+                    std::make_shared<const snapshot_type>( snapshot_type{ m_epoch, freeze( m_graph ) } );
+                std::atomic_store_explicit( &m_snapshot_p, std::move( snapshot_p ),
+                                            std::memory_order_release );
+                return;
+            }
+            
+            /*****************************************************************************
+                                          Public interface
+            *****************************************************************************/
+        public:
+            /**
+             * Makes empty graph and publishes its empty snapshot.
+             */
+            explicit concurrent_orgraph( const typename graph_type::allocator_type& alloc =
+                                             typename graph_type::allocator_type() ) :
+                m_graph( alloc )
+            {
+                publish();
+            }
+            
+            concurrent_orgraph( const concurrent_orgraph& ) = delete;
+            concurrent_orgraph& operator=( const concurrent_orgraph& ) = delete;
+            
+            /**
+             * Gives current snapshot without waiting for writer.
+             * Snapshot stays valid while it is held.
+             */
+            std::shared_ptr<const snapshot_type> read() const
+            {
+                return std::atomic_load_explicit( &m_snapshot_p, std::memory_order_acquire );
+            }
+            
+            /**
+             * Epoch of current snapshot.
+             */
+            uint64_t epoch() const
+            {
+                return read()->epoch;
+            }
+            
+            /**
+             * Runs batch( master graph ) and publishes result as new snapshot.
+             * If batch throws nothing is published, changes made before exception
+             * stay in master graph and are published by next write.
+             * Refs got from master graph can be kept by writer between batches.
+             * Returns: epoch of published snapshot.
+             */
+            template <typename Tfunc>
+            uint64_t write( Tfunc batch )
+            {
+                std::lock_guard<std::mutex> lock( m_write_mutex );
+                batch( m_graph );
+                publish();
+                return m_epoch;
+            }
+        };
+        
+        /********************************************************************************/
+    }
+}
+
+/****************************************************************************************/
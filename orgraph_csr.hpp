@@ -0,0 +1,890 @@
+/**
+ * Frozen compressed-sparse-row (CSR) snapshot of oriented graph.
+ */
+#pragma once
+
+/****************************************************************************************/
+
+/**
+ * Snapshot is built once from orgraph<Tnode,Tedge,Tstorage> and then is read-only.
+ * All adjacency lives in contiguous arrays, so traversals don't chase pointers
+ * through node and edge storages of orgraph.
+ *
+ * Nodes and edges of snapshot are renumbered densely:
+ *      node index - position in [0, node_count()), nodes keep orgraph id order;
+ *      edge index - position in [0, edge_count()), edges are grouped by pred node,
+ *                   inside group they keep orgraph id order.
+ * Snapshot made by permuted() has nodes in given order instead
+ * (see orgraph_reorder.hpp), ids of orgraph are kept by any snapshot.
+ *
+ * Arrays:
+ *      succ_offsets[n] .. succ_offsets[n+1] - positions of succ edges of node n,
+ *                                             position is edge index itself;
+ *      succ_targets[pos]                    - succ node of edge pos;
+ *      pred_offsets[n] .. pred_offsets[n+1] - positions of pred edges of node n;
+ *      pred_sources[pos]                    - pred node of pred edge at pos;
+ *      pred_edges[pos]                      - edge index of pred edge at pos.
+ *
+ * Arrays are read through csr_array views, memory behind them is kept alive by
+ * owner shared by copies of snapshot: vectors of snapshot built from graph or
+ * mapping of file (see orgraph_serialization.hpp). Copying snapshot is cheap.
+ *
+ * Visible types:
+ *      1.  csr_view<Tnode,Tedge>
+ *      2.  csr_node_ref<Tnode,Tedge> - works as ref to node of snapshot
+ *      3.  csr_edge_ref<Tnode,Tedge> - works as ref to edge of snapshot
+ */
+
+/****************************************************************************************/
+
+#include <vector>
+#include <string>
+#include <stdexcept>
+#include <optional>
+#include <memory>
+#include <algorithm>
+#include <utility>
+
+#include <iterator> // For std::forward_iterator_tag
+#include <cstddef>  // For std::ptrdiff_t
+
+#include <stdint.h>
+
+#include "orgraph.hpp"
+
+#ifdef DEBUG_DS_ORGRAPH
+#include <assert.h>
+#endif /* DEBUG_DS_ORGRAPH */
+
+/****************************************************************************************/
+
+namespace ds
+{
+    namespace orgraph
+    {
+        /********************************************************************************/
+        
+        /**
+         * Forward declarations.
+         */
+        template <typename Tnode, typename Tedge> class csr_node_ref;
+        template <typename Tnode, typename Tedge> class csr_edge_ref;
+        template <typename Tnode, typename Tedge> class csr_file;
+        
+        /********************************************************************************/
+        
+        /**
+         * Read-only view of contiguous array, doesn't own memory.
+         */
+        template <typename T>
+        class csr_array
+        {
+        private:
+            const T *m_data_p = nullptr;
+            size_t   m_size   = 0;
+            
+        public:
+            csr_array() = default;
+            csr_array( const T *data_p, size_t size ) :
+                m_data_p( data_p ),
+                m_size( size )
+            {}
+            template <typename Talloc>
+            csr_array( const std::vector<T,Talloc>& v ) :
+                m_data_p( v.data() ),
+                m_size( v.size() )
+            {}
+            
+            const T& operator[]( size_t pos ) const
+            {
+                return m_data_p[pos];
+            }
+            
+            const T* data() const
+            {
+                return m_data_p;
+            }
+            
+            size_t size() const
+            {
+                return m_size;
+            }
+            
+            const T* begin() const
+            {
+                return m_data_p;
+            }
+            
+            const T* end() const
+            {
+                return m_data_p + m_size;
+            }
+        };
+        
+        /********************************************************************************/
+        
+        /**
+         * Iterator through positions of csr_view arrays.
+         * Tpolicy::get( view, pos ) makes value (ref to node or edge) for position.
+         * Nothing is allocated while iterating.
+         */
+        template <typename Tnode, typename Tedge, typename Tpolicy>
+        class csr_iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using difference_type   = std::ptrdiff_t;
+            using value_type        = typename Tpolicy::value_type;
+            using pointer           = void;
+            using reference         = value_type;
+        
+        private:
+            const csr_view<Tnode,Tedge> *m_view_p = nullptr;
+            int32_t                      m_pos    = 0;
+        
+        public:
+            csr_iterator() = default;
+            csr_iterator( const csr_view<Tnode,Tedge> *view_p, int32_t pos ) :
+                m_view_p( view_p ),
+                m_pos( pos )
+            {}
+            
+            value_type operator*() const
+            {
+                return Tpolicy::get( m_view_p, m_pos );
+            }
+            
+            csr_iterator& operator++()
+            {
+                m_pos++;
+                return *this;
+            }
+            
+            csr_iterator operator++( int )
+            {
+                csr_iterator tmp = *this;
+                m_pos++;
+                return tmp;
+            }
+            
+            bool operator==( const csr_iterator& it ) const
+            {
+                return ( m_pos == it.m_pos && m_view_p == it.m_view_p );
+            }
+            
+            bool operator!=( const csr_iterator& it ) const
+            {
+                return !( *this == it );
+            }
+        };
+        
+        /********************************************************************************/
+        
+        /**
+         * Pair of csr_iterator usable in range-based for.
+         */
+        template <typename Titerator>
+        using csr_range = range<Titerator>;
+        
+        /********************************************************************************/
+        
+        template <typename Tnode, typename Tedge>
+        class csr_view
+        {
+            /*****************************************************************************
+                                    Inner types and friend types
+            *****************************************************************************/
+            friend class csr_node_ref<Tnode,Tedge>;
+            friend class csr_edge_ref<Tnode,Tedge>;
+            friend class csr_file<Tnode,Tedge>;
+        
+        private:
+            using node_id = ds::orgraph::node_id;
+            using edge_id = ds::orgraph::edge_id;
+            
+            /**
+             * Arrays of snapshot built in memory.
+             */
+            struct owned_arrays
+            {
+                std::vector<Tnode> node_data;
+                std::vector<Tedge> edge_data;
+                
+                std::vector<int32_t> succ_offsets;
+                std::vector<int32_t> succ_targets;
+                std::vector<int32_t> edge_sources;
+                
+                std::vector<int32_t> pred_offsets;
+                std::vector<int32_t> pred_sources;
+                std::vector<int32_t> pred_edges;
+                
+                std::vector<node_id> node_ids;
+                std::vector<edge_id> edge_ids;
+                std::vector<int32_t> node_index_of_id;
+            };
+            
+            /**
+             * Policies of csr_iterator.
+             */
+            struct all_nodes_policy
+            {
+                using value_type = csr_node_ref<Tnode,Tedge>;
+                static value_type get( const csr_view *view_p, int32_t pos )
+                {
+                    return value_type( view_p, pos );
+                }
+            };
+            
+            struct all_edges_policy
+            {
+                using value_type = csr_edge_ref<Tnode,Tedge>;
+                static value_type get( const csr_view *view_p, int32_t pos )
+                {
+                    return value_type( view_p, pos );
+                }
+            };
+            
+            struct succ_nodes_policy
+            {
+                using value_type = csr_node_ref<Tnode,Tedge>;
+                static value_type get( const csr_view *view_p, int32_t pos )
+                {
+                    return value_type( view_p, view_p->m_succ_targets[pos] );
+                }
+            };
+            
+            struct pred_nodes_policy
+            {
+                using value_type = csr_node_ref<Tnode,Tedge>;
+                static value_type get( const csr_view *view_p, int32_t pos )
+                {
+                    return value_type( view_p, view_p->m_pred_sources[pos] );
+                }
+            };
+            
+            struct pred_edges_policy
+            {
+                using value_type = csr_edge_ref<Tnode,Tedge>;
+                static value_type get( const csr_view *view_p, int32_t pos )
+                {
+                    return value_type( view_p, view_p->m_pred_edges[pos] );
+                }
+            };
+        
+        public:
+            using node_iterator      = csr_iterator<Tnode,Tedge,all_nodes_policy>;
+            using edge_iterator      = csr_iterator<Tnode,Tedge,all_edges_policy>;
+            using succ_node_iterator = csr_iterator<Tnode,Tedge,succ_nodes_policy>;
+            using succ_edge_iterator = csr_iterator<Tnode,Tedge,all_edges_policy>;
+            using pred_node_iterator = csr_iterator<Tnode,Tedge,pred_nodes_policy>;
+            using pred_edge_iterator = csr_iterator<Tnode,Tedge,pred_edges_policy>;
+            
+            /*****************************************************************************
+                                                Data
+            *****************************************************************************/
+        private:
+            csr_array<Tnode> m_node_data;
+            csr_array<Tedge> m_edge_data;
+            
+            csr_array<int32_t> m_succ_offsets;
+            csr_array<int32_t> m_succ_targets;
+            csr_array<int32_t> m_edge_sources;
+            
+            csr_array<int32_t> m_pred_offsets;
+            csr_array<int32_t> m_pred_sources;
+            csr_array<int32_t> m_pred_edges;
+            
+            // back mapping to ids of orgraph the snapshot was made from
+            csr_array<node_id> m_node_ids;
+            csr_array<edge_id> m_edge_ids;
+            csr_array<int32_t> m_node_index_of_id;
+            
+            // keeps memory of arrays alive
+            std::shared_ptr<const void> m_owner_p;
+            
+            /*****************************************************************************
+                                             Inner methods
+            *****************************************************************************/
+        private:
+            /**
+             * Points views to arrays built in memory.
+             */
+            void adopt( std::shared_ptr<const owned_arrays> arrays_p )
+            {
+                m_node_data        = arrays_p->node_data;
+                m_edge_data        = arrays_p->edge_data;
+                m_succ_offsets     = arrays_p->succ_offsets;
+                m_succ_targets     = arrays_p->succ_targets;
+                m_edge_sources     = arrays_p->edge_sources;
+                m_pred_offsets     = arrays_p->pred_offsets;
+                m_pred_sources     = arrays_p->pred_sources;
+                m_pred_edges       = arrays_p->pred_edges;
+                m_node_ids         = arrays_p->node_ids;
+                m_edge_ids         = arrays_p->edge_ids;
+                m_node_index_of_id = arrays_p->node_index_of_id;
+                m_owner_p          = std::move( arrays_p );
+                return;
+            }
+            
+            /*****************************************************************************
+                                          Public interface
+            *****************************************************************************/
+        public:
+            /**
+             * Makes empty snapshot.
+             */
+            csr_view()
+            {
+                auto arrays_p = std::make_shared<owned_arrays>();
+                arrays_p->succ_offsets.assign( 1, 0 );
+                arrays_p->pred_offsets.assign( 1, 0 );
+                adopt( std::move( arrays_p ) );
+            }
+            
+            /**
+             * Makes snapshot of current state of graph.
+             * Later changes of graph are not visible through snapshot.
+             */
+            template <typename Tstorage>
+            explicit csr_view( const orgraph<Tnode,Tedge,Tstorage>& graph )
+            {
+                const int32_t num_nodes = (int32_t)graph.m_nodes.size();
+                const int32_t num_edges = (int32_t)graph.m_edges.size();
+                
+                auto arrays_p = std::make_shared<owned_arrays>();
+                owned_arrays& arrays = *arrays_p;
+                
+                arrays.node_data.reserve( num_nodes );
+                arrays.node_ids.reserve( num_nodes );
+                arrays.node_index_of_id.assign( graph.m_nodes.id_bound(), -1 );
+                
+                arrays.edge_data.reserve( num_edges );
+                arrays.edge_ids.reserve( num_edges );
+                arrays.edge_sources.reserve( num_edges );
+                arrays.succ_targets.reserve( num_edges );
+                arrays.succ_offsets.reserve( num_nodes + 1 );
+                
+                for ( const auto& cur_node : graph.m_nodes )
+                {
+                    arrays.node_index_of_id[ cur_node.id()() ] = (int32_t)arrays.node_ids.size();
+                    arrays.node_ids.push_back( cur_node.id() );
+                    arrays.node_data.push_back( cur_node.data() );
+                }
+                
+                // succ direction: edges are numbered in order of grouping by pred node
+                std::vector<int32_t> edge_index_of_id( graph.m_edges.id_bound(), -1 );
+                arrays.succ_offsets.push_back( 0 );
+                for ( const auto& cur_node : graph.m_nodes )
+                {
+                    const int32_t cur_index = arrays.node_index_of_id[ cur_node.id()() ];
+                    for ( const auto& cur_edge_id : cur_node.succs() )
+                    {
+                        const auto& cur_edge = graph.m_edges.at( cur_edge_id );
+                        edge_index_of_id[ cur_edge_id() ] = (int32_t)arrays.edge_ids.size();
+                        arrays.edge_ids.push_back( cur_edge_id );
+                        arrays.edge_data.push_back( cur_edge.data() );
+                        arrays.edge_sources.push_back( cur_index );
+                        arrays.succ_targets.push_back( arrays.node_index_of_id[ cur_edge.succ()() ] );
+                    }
+                    arrays.succ_offsets.push_back( (int32_t)arrays.edge_ids.size() );
+                }
+                
+                // pred direction
+                arrays.pred_offsets.reserve( num_nodes + 1 );
+                arrays.pred_sources.reserve( num_edges );
+                arrays.pred_edges.reserve( num_edges );
+                arrays.pred_offsets.push_back( 0 );
+                for ( const auto& cur_node : graph.m_nodes )
+                {
+                    for ( const auto& cur_edge_id : cur_node.preds() )
+                    {
+                        const int32_t cur_edge_index = edge_index_of_id[ cur_edge_id() ];
+                        arrays.pred_edges.push_back( cur_edge_index );
+                        arrays.pred_sources.push_back( arrays.edge_sources[ cur_edge_index ] );
+                    }
+                    arrays.pred_offsets.push_back( (int32_t)arrays.pred_edges.size() );
+                }
+#ifdef DEBUG_DS_ORGRAPH
+                assert( (int32_t)arrays.edge_ids.size() == num_edges );
+                assert( (int32_t)arrays.pred_edges.size() == num_edges );
+#endif /* DEBUG_DS_ORGRAPH */
+                
+                adopt( std::move( arrays_p ) );
+            }
+            
+            /**
+             * Makes snapshot with nodes renumbered: node i of new snapshot is node order[i]
+             * of this one. Order should be a permutation of node indices.
+             * Edges are regrouped by new pred nodes and sorted by new succ nodes inside
+             * groups, ids of orgraph are kept, so find() and origin() work as before.
+             */
+            csr_view permuted( const std::vector<int32_t>& order ) const
+            {
+                const int32_t num_nodes = node_count();
+                const int32_t num_edges = edge_count();
+                if ( (int32_t)order.size() != num_nodes )
+                {
+                    throw std::invalid_argument( "order of " + std::to_string( order.size() ) +
+                                                 " nodes is given for " + std::to_string( num_nodes ) + " nodes" );
+                }
+                
+                std::vector<int32_t> new_index( num_nodes, -1 );
+                for ( int32_t i = 0; i < num_nodes; i++ )
+                {
+                    if ( order[i] < 0 || order[i] >= num_nodes || new_index[ order[i] ] >= 0 )
+                    {
+                        throw std::invalid_argument( "order is not a permutation of nodes" );
+                    }
+                    new_index[ order[i] ] = i;
+                }
+                
+                auto arrays_p = std::make_shared<owned_arrays>();
+                owned_arrays& arrays = *arrays_p;
+                
+                arrays.node_data.reserve( num_nodes );
+                arrays.node_ids.reserve( num_nodes );
+                arrays.node_index_of_id.assign( m_node_index_of_id.size(), -1 );
+                for ( int32_t i = 0; i < num_nodes; i++ )
+                {
+                    arrays.node_data.push_back( m_node_data[ order[i] ] );
+                    arrays.node_ids.push_back( m_node_ids[ order[i] ] );
+                    arrays.node_index_of_id[ m_node_ids[ order[i] ]() ] = i;
+                }
+                
+                // ( new node, old edge or pred position ) of one group at a time
+                std::vector< std::pair<int32_t,int32_t> > group;
+                
+                std::vector<int32_t> new_edge_index( num_edges );
+                arrays.edge_data.reserve( num_edges );
+                arrays.edge_ids.reserve( num_edges );
+                arrays.edge_sources.reserve( num_edges );
+                arrays.succ_targets.reserve( num_edges );
+                arrays.succ_offsets.reserve( num_nodes + 1 );
+                arrays.succ_offsets.push_back( 0 );
+                for ( int32_t i = 0; i < num_nodes; i++ )
+                {
+                    group.clear();
+                    for ( int32_t e = succ_begin( order[i] ); e < succ_end( order[i] ); e++ )
+                    {
+                        group.emplace_back( new_index[ m_succ_targets[e] ], e );
+                    }
+                    std::sort( group.begin(), group.end() );
+                    for ( const auto& [target, e] : group )
+                    {
+                        new_edge_index[e] = (int32_t)arrays.edge_ids.size();
+                        arrays.edge_ids.push_back( m_edge_ids[e] );
+                        arrays.edge_data.push_back( m_edge_data[e] );
+                        arrays.edge_sources.push_back( i );
+                        arrays.succ_targets.push_back( target );
+                    }
+                    arrays.succ_offsets.push_back( (int32_t)arrays.edge_ids.size() );
+                }
+                
+                arrays.pred_offsets.reserve( num_nodes + 1 );
+                arrays.pred_sources.reserve( num_edges );
+                arrays.pred_edges.reserve( num_edges );
+                arrays.pred_offsets.push_back( 0 );
+                for ( int32_t i = 0; i < num_nodes; i++ )
+                {
+                    group.clear();
+                    for ( int32_t pos = pred_begin( order[i] ); pos < pred_end( order[i] ); pos++ )
+                    {
+                        group.emplace_back( new_index[ m_pred_sources[pos] ], new_edge_index[ m_pred_edges[pos] ] );
+                    }
+                    std::sort( group.begin(), group.end() );
+                    for ( const auto& [source, e] : group )
+                    {
+                        arrays.pred_sources.push_back( source );
+                        arrays.pred_edges.push_back( e );
+                    }
+                    arrays.pred_offsets.push_back( (int32_t)arrays.pred_edges.size() );
+                }
+                
+                csr_view out;
+                out.adopt( std::move( arrays_p ) );
+                return out;
+            }
+            
+            /**
+             * Number of nodes in snapshot.
+             */
+            int32_t node_count() const
+            {
+                return (int32_t)m_node_data.size();
+            }
+            
+            /**
+             * Number of edges in snapshot.
+             */
+            int32_t edge_count() const
+            {
+                return (int32_t)m_edge_data.size();
+            }
+            
+            /**
+             * Gives ref to node with specified index.
+             */
+            csr_node_ref<Tnode,Tedge> node( int32_t index ) const
+            {
+                if ( index < 0 || index >= node_count() )
+                {
+                    throw std::out_of_range( "node index " + std::to_string( index ) +
+                                             " is out of size " + std::to_string( node_count() ) );
+                }
+                return csr_node_ref<Tnode,Tedge>( this, index );
+            }
+            
+            /**
+             * Gives ref to edge with specified index.
+             */
+            csr_edge_ref<Tnode,Tedge> edge( int32_t index ) const
+            {
+                if ( index < 0 || index >= edge_count() )
+                {
+                    throw std::out_of_range( "edge index " + std::to_string( index ) +
+                                             " is out of size " + std::to_string( edge_count() ) );
+                }
+                return csr_edge_ref<Tnode,Tedge>( this, index );
+            }
+            
+            /**
+             * Finds snapshot node made from specified node of orgraph.
+             * Returns: nullopt if node was added to graph after snapshot was made.
+             */
+            template <typename Tstorage>
+            std::optional< csr_node_ref<Tnode,Tedge> >
+            find( const node_ref<Tnode,Tedge,Tstorage>& ref ) const
+            {
+                const node_id id = ref.id();
+                if ( id() < 0 || id() >= (int32_t)m_node_index_of_id.size() ||
+                     m_node_index_of_id[ id() ] < 0 ||
+                     m_node_ids[ m_node_index_of_id[ id() ] ] != id )
+                {
+                    return std::nullopt;
+                }
+                return std::optional{ csr_node_ref<Tnode,Tedge>( this, m_node_index_of_id[ id() ] ) };
+            }
+            
+            /**
+             * Gives ref to node of orgraph the snapshot node was made from.
+             * Note: graph should be the one snapshot was made from
+             *       and the node should not be removed from it.
+             */
+            template <typename Tstorage>
+            node_ref<Tnode,Tedge,Tstorage> origin( orgraph<Tnode,Tedge,Tstorage>& graph,
+                                                   const csr_node_ref<Tnode,Tedge>& ref ) const
+            {
+                return graph.m_nodes.at( m_node_ids[ ref.index() ] ).make_ref();
+            }
+            
+            /**
+             * Gives ref to edge of orgraph the snapshot edge was made from.
+             * Note: graph should be the one snapshot was made from
+             *       and the edge should not be removed from it.
+             */
+            template <typename Tstorage>
+            edge_ref<Tnode,Tedge,Tstorage> origin( orgraph<Tnode,Tedge,Tstorage>& graph,
+                                                   const csr_edge_ref<Tnode,Tedge>& ref ) const
+            {
+                return graph.m_edges.at( m_edge_ids[ ref.index() ] ).make_ref();
+            }
+            
+            /**
+             * Gives a range of refs to all nodes of snapshot.
+             */
+            csr_range<node_iterator> nodes() const
+            {
+                return csr_range<node_iterator>( node_iterator( this, 0 ),
+                                                 node_iterator( this, node_count() ) );
+            }
+            
+            /**
+             * Gives a range of refs to all edges of snapshot.
+             */
+            csr_range<edge_iterator> edges() const
+            {
+                return csr_range<edge_iterator>( edge_iterator( this, 0 ),
+                                                 edge_iterator( this, edge_count() ) );
+            }
+            
+            /*****************************************************************************
+                                     Raw access for algorithms
+            *****************************************************************************/
+        public:
+            /**
+             * Succ edges of node n are edges with indices [succ_begin(n), succ_end(n)).
+             */
+            int32_t succ_begin( int32_t n ) const
+            {
+                return m_succ_offsets[n];
+            }
+            
+            int32_t succ_end( int32_t n ) const
+            {
+                return m_succ_offsets[n + 1];
+            }
+            
+            /**
+             * Succ node of edge e.
+             */
+            int32_t succ_target( int32_t e ) const
+            {
+                return m_succ_targets[e];
+            }
+            
+            /**
+             * Pred node of edge e.
+             */
+            int32_t edge_source( int32_t e ) const
+            {
+                return m_edge_sources[e];
+            }
+            
+            /**
+             * Pred edges of node n are at positions [pred_begin(n), pred_end(n)).
+             */
+            int32_t pred_begin( int32_t n ) const
+            {
+                return m_pred_offsets[n];
+            }
+            
+            int32_t pred_end( int32_t n ) const
+            {
+                return m_pred_offsets[n + 1];
+            }
+            
+            /**
+             * Pred node of pred edge at position pos.
+             */
+            int32_t pred_source( int32_t pos ) const
+            {
+                return m_pred_sources[pos];
+            }
+            
+            /**
+             * Edge index of pred edge at position pos.
+             */
+            int32_t pred_edge( int32_t pos ) const
+            {
+                return m_pred_edges[pos];
+            }
+            
+            const Tnode& node_data( int32_t n ) const
+            {
+                return m_node_data[n];
+            }
+            
+            const Tedge& edge_data( int32_t e ) const
+            {
+                return m_edge_data[e];
+            }
+        };
+        
+        /********************************************************************************/
+        
+        template <typename Tnode, typename Tedge>
+        class csr_node_ref
+        {
+            /*****************************************************************************
+                                    Inner types and friend types
+            *****************************************************************************/
+            friend class csr_view<Tnode,Tedge>;
+            friend class csr_edge_ref<Tnode,Tedge>;
+            
+            /*****************************************************************************
+                                                Data
+            *****************************************************************************/
+        private:
+            const csr_view<Tnode,Tedge> *m_view_p;
+            int32_t                      m_index;
+            
+            /*****************************************************************************
+                                Accessible by friend classes interface
+            *****************************************************************************/
+        private:
+            csr_node_ref( const csr_view<Tnode,Tedge> *view_p, int32_t index ) :
+                m_view_p( view_p ),
+                m_index( index )
+            {}
+            
+            /*****************************************************************************
+                                          Public interface
+            *****************************************************************************/
+        public:
+            /**
+             * Dense index of node in snapshot.
+             */
+            int32_t index() const
+            {
+                return m_index;
+            }
+            
+            /**
+             * Dereference operator for accessing data of node.
+             */
+            const Tnode& operator*() const
+            {
+                return m_view_p->m_node_data[m_index];
+            }
+            
+            const Tnode* operator->() const
+            {
+                return &( m_view_p->m_node_data[m_index] );
+            }
+            
+            /**
+             * Gives a range of refs to all pred edges of node.
+             */
+            csr_range< typename csr_view<Tnode,Tedge>::pred_edge_iterator > pred_edges() const
+            {
+                using iterator = typename csr_view<Tnode,Tedge>::pred_edge_iterator;
+                return { iterator( m_view_p, m_view_p->pred_begin( m_index ) ),
+                         iterator( m_view_p, m_view_p->pred_end( m_index ) ) };
+            }
+            
+            /**
+             * Gives a range of refs to all pred nodes of node.
+             */
+            csr_range< typename csr_view<Tnode,Tedge>::pred_node_iterator > pred_nodes() const
+            {
+                using iterator = typename csr_view<Tnode,Tedge>::pred_node_iterator;
+                return { iterator( m_view_p, m_view_p->pred_begin( m_index ) ),
+                         iterator( m_view_p, m_view_p->pred_end( m_index ) ) };
+            }
+            
+            /**
+             * Gives a range of refs to all succ edges of node.
+             */
+            csr_range< typename csr_view<Tnode,Tedge>::succ_edge_iterator > succ_edges() const
+            {
+                using iterator = typename csr_view<Tnode,Tedge>::succ_edge_iterator;
+                return { iterator( m_view_p, m_view_p->succ_begin( m_index ) ),
+                         iterator( m_view_p, m_view_p->succ_end( m_index ) ) };
+            }
+            
+            /**
+             * Gives a range of refs to all succ nodes of node.
+             */
+            csr_range< typename csr_view<Tnode,Tedge>::succ_node_iterator > succ_nodes() const
+            {
+                using iterator = typename csr_view<Tnode,Tedge>::succ_node_iterator;
+                return { iterator( m_view_p, m_view_p->succ_begin( m_index ) ),
+                         iterator( m_view_p, m_view_p->succ_end( m_index ) ) };
+            }
+            
+            int32_t pred_count() const
+            {
+                return m_view_p->pred_end( m_index ) - m_view_p->pred_begin( m_index );
+            }
+            
+            int32_t succ_count() const
+            {
+                return m_view_p->succ_end( m_index ) - m_view_p->succ_begin( m_index );
+            }
+            
+            bool operator==( const csr_node_ref& r ) const
+            {
+                return ( m_index == r.m_index && m_view_p == r.m_view_p );
+            }
+            
+            bool operator!=( const csr_node_ref& r ) const
+            {
+                return !( *this == r );
+            }
+        };
+        
+        /********************************************************************************/
+        
+        template <typename Tnode, typename Tedge>
+        class csr_edge_ref
+        {
+            /*****************************************************************************
+                                    Inner types and friend types
+            *****************************************************************************/
+            friend class csr_view<Tnode,Tedge>;
+            friend class csr_node_ref<Tnode,Tedge>;
+            
+            /*****************************************************************************
+                                                Data
+            *****************************************************************************/
+        private:
+            const csr_view<Tnode,Tedge> *m_view_p;
+            int32_t                      m_index;
+            
+            /*****************************************************************************
+                                Accessible by friend classes interface
+            *****************************************************************************/
+        private:
+            csr_edge_ref( const csr_view<Tnode,Tedge> *view_p, int32_t index ) :
+                m_view_p( view_p ),
+                m_index( index )
+            {}
+            
+            /*****************************************************************************
+                                          Public interface
+            *****************************************************************************/
+        public:
+            /**
+             * Dense index of edge in snapshot.
+             */
+            int32_t index() const
+            {
+                return m_index;
+            }
+            
+            /**
+             * Dereference operator for accessing data of edge.
+             */
+            const Tedge& operator*() const
+            {
+                return m_view_p->m_edge_data[m_index];
+            }
+            
+            const Tedge* operator->() const
+            {
+                return &( m_view_p->m_edge_data[m_index] );
+            }
+            
+            /**
+             * Gives ref to pred node of edge.
+             */
+            csr_node_ref<Tnode,Tedge> pred() const
+            {
+                return csr_node_ref<Tnode,Tedge>( m_view_p, m_view_p->edge_source( m_index ) );
+            }
+            
+            /**
+             * Gives ref to succ node of edge.
+             */
+            csr_node_ref<Tnode,Tedge> succ() const
+            {
+                return csr_node_ref<Tnode,Tedge>( m_view_p, m_view_p->succ_target( m_index ) );
+            }
+            
+            bool operator==( const csr_edge_ref& r ) const
+            {
+                return ( m_index == r.m_index && m_view_p == r.m_view_p );
+            }
+            
+            bool operator!=( const csr_edge_ref& r ) const
+            {
+                return !( *this == r );
+            }
+        };
+        
+        /********************************************************************************/
+        
+        /**
+         * Makes frozen CSR snapshot of graph.
+         */
+        template <typename Tnode, typename Tedge, typename Tstorage>
+        csr_view<Tnode,Tedge> freeze( const orgraph<Tnode,Tedge,Tstorage>& graph )
+        {
+            return csr_view<Tnode,Tedge>( graph );
+        }
+        
+        /********************************************************************************/
+    }
+}
+
+/****************************************************************************************/
@@ -0,0 +1,497 @@
+/**
+ * Implicit graph of grid cells.
+ */
+#pragma once
+
+/****************************************************************************************/
+
+/**
+ * grid_graph is adapter of traversal and shortest path algorithms over
+ * vector2d: vertex is cell y * width + x, succs are neighbour cells, which are
+ * found on the fly, so there are no nodes, no edges and no allocation.
+ *
+ * Neighbours are 4 (grid_connectivity::four) or 8 (grid_connectivity::eight).
+ * Cost functor cost( const T& cell, bool diagonal ) -> Tweight gives weight of
+ * move into cell, negative weight means cell is blocked. Blocked cells are
+ * holes (is_vertex is false). Diagonal move doesn't cut corners: both cells
+ * beside it should be passable. Weight of edge depends only on cell it
+ * goes to, so edge_data is this weight and weight functor is identity.
+ * edge_count() and out_degree() of grid are counted, edge_count() is O(cells).
+ *
+ * Besides bfs, dijkstra and astar there is jump_point_search for 8-connected
+ * grids of uniform costs, which expands only few jump points of open areas.
+ *
+ * Adapter keeps pointer to vector2d, it should not be changed while adapter is used.
+ *
+ * Usage:
+ *      auto graph = ds::orgraph::adapt( map, ds::orgraph::grid_connectivity::eight,
+ *                                       []( char cell, bool diagonal )
+ *                                       {
+ *                                           return ( '#' == cell ) ? -1.0 : ( diagonal ? 1.5 : 1.0 );
+ *                                       } );
+ *      ds::orgraph::astar( graph, graph.vertex( from ), graph.vertex( to ), graph.weight(),
+ *                          graph.heuristic( graph.vertex( to ), 1.0, 1.5 ), scratch );
+ */
+
+/****************************************************************************************/
+
+#include <vector>
+#include <string>
+#include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <cstdlib>
+
+#include <stdint.h>
+
+#include "vector2d.hpp"
+#include "orgraph_shortest_path.hpp"
+
+/****************************************************************************************/
+
+namespace ds
+{
+    namespace orgraph
+    {
+        /********************************************************************************/
+        
+        enum class grid_connectivity
+        {
+            four,
+            eight
+        };
+        
+        /********************************************************************************/
+        
+        template <typename T, typename Tlayout, typename Tcost_func>
+        class grid_graph
+        {
+        public:
+            using grid_type   = ds::vector2d::vector2d<T,Tlayout>;
+            using weight_type = typename std::decay<decltype( std::declval<const Tcost_func&>()( std::declval<const T&>(), false ) )>::type;
+            using edge_data   = weight_type;
+        
+        private:
+            // straight directions go first, diagonal dx and dy are its neighbours
+            static constexpr int32_t num_directions = 8;
+            static constexpr int32_t dir_x[num_directions] = { 1, 0, -1,  0, 1, -1, -1,  1 };
+            static constexpr int32_t dir_y[num_directions] = { 0, 1,  0, -1, 1,  1, -1, -1 };
+            
+            const grid_type *m_grid_p;
+            grid_connectivity m_connectivity;
+            Tcost_func        m_cost;
+            int32_t           m_width;
+            int32_t           m_height;
+            
+            int32_t NumDirections() const
+            {
+                return ( grid_connectivity::eight == m_connectivity ) ? num_directions : 4;
+            }
+            
+            /**
+             * Calls f( neighbour, diagonal ) for every neighbour of pos, to or from which move is possible
+             * if pos is passable, while f returns true.
+             */
+            template <typename Tfunc>
+            void ForEachNeighbour( const ds::vector2d::point2d& pos, Tfunc& f ) const
+            {
+                const int32_t cur_num_directions = NumDirections();
+                for ( int32_t d = 0; d < cur_num_directions; d++ )
+                {
+                    const ds::vector2d::point2d next( pos.x + dir_x[d], pos.y + dir_y[d] );
+                    if ( !passable( next ) )
+                    {
+                        continue;
+                    }
+                    const bool diagonal = ( d >= 4 );
+                    if ( diagonal && ( !passable( ds::vector2d::point2d( next.x, pos.y ) ) ||
+                                       !passable( ds::vector2d::point2d( pos.x, next.y ) ) ) )
+                    {
+                        continue;
+                    }
+                    if ( !f( next, diagonal ) )
+                    {
+                        return;
+                    }
+                }
+                return;
+            }
+        
+        public:
+            grid_graph( const grid_type& grid, grid_connectivity new_connectivity, Tcost_func new_cost )
+                : m_grid_p( &grid ), m_connectivity( new_connectivity ), m_cost( new_cost ),
+                  m_width( grid.size().x ), m_height( grid.size().y )
+            {
+                if ( (int64_t)m_width * m_height > INT32_MAX )
+                {
+                    throw std::invalid_argument( "grid of size " + (std::string)grid.size() +
+                                                 " has more cells than vertices" );
+                }
+            }
+            
+            grid_connectivity connectivity() const
+            {
+                return m_connectivity;
+            }
+            
+            int32_t vertex_bound() const
+            {
+                return m_width * m_height;
+            }
+            
+            bool is_vertex( int32_t v ) const
+            {
+                return passable( position( v ) );
+            }
+            
+            int64_t edge_count() const
+            {
+                int64_t out = 0;
+                for ( int32_t v = 0; v < vertex_bound(); v++ )
+                {
+                    if ( is_vertex( v ) )
+                    {
+                        out += out_degree( v );
+                    }
+                }
+                return out;
+            }
+            
+            int32_t out_degree( int32_t v ) const
+            {
+                int32_t out = 0;
+                for_each_succ( v, [&]( int32_t, weight_type )
+                                  {
+                                      out++;
+                                      return true;
+                                  } );
+                return out;
+            }
+            
+            template <typename Tfunc>
+            void for_each_succ( int32_t v, Tfunc f ) const
+            {
+                auto on_neighbour = [&]( const ds::vector2d::point2d& next, bool diagonal )
+                                    {
+                                        return f( vertex( next ), cost( next, diagonal ) );
+                                    };
+                ForEachNeighbour( position( v ), on_neighbour );
+                return;
+            }
+            
+            /**
+             * Moves are symmetric, so preds are neighbours, but weight is of move into v.
+             */
+            template <typename Tfunc>
+            void for_each_pred( int32_t v, Tfunc f ) const
+            {
+                const ds::vector2d::point2d pos = position( v );
+                auto on_neighbour = [&]( const ds::vector2d::point2d& prev, bool diagonal )
+                                    {
+                                        return f( vertex( prev ), cost( pos, diagonal ) );
+                                    };
+                ForEachNeighbour( pos, on_neighbour );
+                return;
+            }
+            
+            /**
+             * Conversions between cells and vertices.
+             */
+            int32_t vertex( const ds::vector2d::point2d& pos ) const
+            {
+                return pos.y * m_width + pos.x;
+            }
+            
+            ds::vector2d::point2d position( int32_t v ) const
+            {
+                return ds::vector2d::point2d( v % m_width, v / m_width );
+            }
+            
+            bool passable( const ds::vector2d::point2d& pos ) const
+            {
+                return ( pos.x >= 0 && pos.y >= 0 && pos.x < m_width && pos.y < m_height &&
+                         !( cost( pos, false ) < weight_type( 0 ) ) );
+            }
+            
+            /**
+             * Weight of move into cell pos.
+             */
+            weight_type cost( const ds::vector2d::point2d& pos, bool diagonal ) const
+            {
+                return m_cost( m_grid_p->at_unchecked( pos ), diagonal );
+            }
+            
+            /**
+             * Weight functor of edges for dijkstra, delta_stepping and astar.
+             */
+            auto weight() const
+            {
+                return []( weight_type edge ) { return edge; };
+            }
+            
+            /**
+             * Heuristic of astar to target: manhattan distance for 4-connected grid,
+             * octile for 8-connected. It is admissible if straight and diagonal costs
+             * are not greater than any costs of cells. Diagonal step is estimated by
+             * at most two straight steps, which can be cheaper than diagonal_cost.
+             */
+            auto heuristic( int32_t target, weight_type straight_cost, weight_type diagonal_cost ) const
+            {
+                const ds::vector2d::point2d target_pos = position( target );
+                const bool is_eight = ( grid_connectivity::eight == m_connectivity );
+                const weight_type diagonal_step = std::min( diagonal_cost, straight_cost + straight_cost );
+                return [this, target_pos, is_eight, straight_cost, diagonal_step]( int32_t v )
+                       {
+                           const ds::vector2d::point2d pos = position( v );
+                           const int32_t dx = std::abs( pos.x - target_pos.x );
+                           const int32_t dy = std::abs( pos.y - target_pos.y );
+                           if ( !is_eight )
+                           {
+                               return weight_type( dx + dy ) * straight_cost;
+                           }
+                           const int32_t num_diagonal = std::min( dx, dy );
+                           return weight_type( dx + dy - 2 * num_diagonal ) * straight_cost +
+                                  weight_type( num_diagonal ) * diagonal_step;
+                       };
+            }
+        };
+        
+        /********************************************************************************/
+        
+        template <typename T, typename Tlayout, typename Tcost_func>
+        grid_graph<T,Tlayout,Tcost_func> adapt( const ds::vector2d::vector2d<T,Tlayout>& grid,
+                                               grid_connectivity connectivity, Tcost_func cost )
+        {
+            return grid_graph<T,Tlayout,Tcost_func>( grid, connectivity, cost );
+        }
+        
+        /********************************************************************************/
+        
+        namespace grid_detail
+        {
+            inline int32_t sign( int32_t value )
+            {
+                return ( value > 0 ) - ( value < 0 );
+            }
+            
+            /**
+             * Straight or diagonal jump from pos in direction (dx,dy) until jump point:
+             * target, cell with forced neighbour or, for diagonal, cell from which
+             * straight jump finds jump point. Returns: found jump point, cost is
+             * weight of moves from pos to it.
+             */
+            template <typename Tgraph>
+            bool jump( const Tgraph& graph, ds::vector2d::point2d pos, int32_t dx, int32_t dy,
+                       const ds::vector2d::point2d& target, ds::vector2d::point2d& out,
+                       typename Tgraph::weight_type& cost )
+            {
+                using ds::vector2d::point2d;
+                
+                const bool diagonal = ( 0 != dx && 0 != dy );
+                cost = typename Tgraph::weight_type( 0 );
+                for ( ;; )
+                {
+                    const point2d next( pos.x + dx, pos.y + dy );
+                    if ( !graph.passable( next ) ||
+                         ( diagonal && ( !graph.passable( point2d( next.x, pos.y ) ) ||
+                                         !graph.passable( point2d( pos.x, next.y ) ) ) ) )
+                    {
+                        return false;
+                    }
+                    cost += graph.cost( next, diagonal );
+                    pos = next;
+                    
+                    if ( pos.x == target.x && pos.y == target.y )
+                    {
+                        out = pos;
+                        return true;
+                    }
+                    
+                    if ( diagonal )
+                    {
+                        point2d straight_out( 0, 0 );
+                        typename Tgraph::weight_type straight_cost;
+                        if ( jump( graph, pos, dx, 0, target, straight_out, straight_cost ) ||
+                             jump( graph, pos, 0, dy, target, straight_out, straight_cost ) )
+                        {
+                            out = pos;
+                            return true;
+                        }
+                    } else if ( 0 != dx )
+                    {
+                        if ( ( graph.passable( point2d( pos.x, pos.y - 1 ) ) &&
+                               !graph.passable( point2d( pos.x - dx, pos.y - 1 ) ) ) ||
+                             ( graph.passable( point2d( pos.x, pos.y + 1 ) ) &&
+                               !graph.passable( point2d( pos.x - dx, pos.y + 1 ) ) ) )
+                        {
+                            out = pos;
+                            return true;
+                        }
+                    } else
+                    {
+                        if ( ( graph.passable( point2d( pos.x - 1, pos.y ) ) &&
+                               !graph.passable( point2d( pos.x - 1, pos.y - dy ) ) ) ||
+                             ( graph.passable( point2d( pos.x + 1, pos.y ) ) &&
+                               !graph.passable( point2d( pos.x + 1, pos.y - dy ) ) ) )
+                        {
+                            out = pos;
+                            return true;
+                        }
+                    }
+                }
+            }
+            
+            /**
+             * Calls f( dx, dy ) for directions of jumps from pos, where we came in
+             * direction (dx,dy) ((0,0) for source): natural and forced neighbours.
+             * Diagonal is checked by jump itself.
+             */
+            template <typename Tgraph, typename Tfunc>
+            void for_each_direction( const Tgraph& graph, const ds::vector2d::point2d& pos,
+                                     int32_t dx, int32_t dy, Tfunc f )
+            {
+                using ds::vector2d::point2d;
+                
+                if ( 0 == dx && 0 == dy )
+                {
+                    for ( int32_t y = -1; y <= 1; y++ )
+                    {
+                        for ( int32_t x = -1; x <= 1; x++ )
+                        {
+                            if ( 0 != x || 0 != y )
+                            {
+                                f( x, y );
+                            }
+                        }
+                    }
+                } else if ( 0 != dx && 0 != dy )
+                {
+                    f( 0, dy );
+                    f( dx, 0 );
+                    f( dx, dy );
+                } else if ( 0 != dx )
+                {
+                    // moves up and down are possible where they were closed from previous cell
+                    f( dx, 0 );
+                    for ( int32_t side = -1; side <= 1; side += 2 )
+                    {
+                        if ( graph.passable( point2d( pos.x, pos.y + side ) ) )
+                        {
+                            f( dx, side );
+                            f( 0, side );
+                        }
+                    }
+                } else
+                {
+                    f( 0, dy );
+                    for ( int32_t side = -1; side <= 1; side += 2 )
+                    {
+                        if ( graph.passable( point2d( pos.x + side, pos.y ) ) )
+                        {
+                            f( side, dy );
+                            f( side, 0 );
+                        }
+                    }
+                }
+                return;
+            }
+        }
+        
+        /********************************************************************************/
+        
+        /**
+         * Jump point search from source to target of 8-connected grid.
+         * Path is shortest if all cells have the same costs, costs of source cell
+         * are taken for heuristic. Vertices of path in scratch are jump points,
+         * expand_jump_path gives all cells of path.
+         * Throws std::invalid_argument for 4-connected grid.
+         */
+        template <typename T, typename Tlayout, typename Tcost_func, typename Tweight>
+        void jump_point_search( const grid_graph<T,Tlayout,Tcost_func>& graph, int32_t source, int32_t target,
+                                shortest_path_scratch<Tweight>& scratch )
+        {
+            using ds::vector2d::point2d;
+            
+            if ( grid_connectivity::eight != graph.connectivity() )
+            {
+                throw std::invalid_argument( "jump point search needs 8-connected grid" );
+            }
+            const int32_t num_vertices = graph.vertex_bound();
+            if ( source < 0 || source >= num_vertices || !graph.is_vertex( source ) )
+            {
+                throw std::out_of_range( "source vertex " + std::to_string( source ) +
+                                         " is not in graph" );
+            }
+            if ( target < 0 || target >= num_vertices || !graph.is_vertex( target ) )
+            {
+                throw std::out_of_range( "target vertex " + std::to_string( target ) +
+                                         " is not in graph" );
+            }
+            
+            const point2d source_pos = graph.position( source );
+            const point2d target_pos = graph.position( target );
+            auto heuristic = graph.heuristic( target, graph.cost( source_pos, false ), graph.cost( source_pos, true ) );
+            
+            best_first_search( num_vertices, source, target,
+                               [&]( int32_t u, auto&& relax )
+                               {
+                                   const point2d pos = graph.position( u );
+                                   const int32_t parent = scratch.parent( u );
+                                   int32_t dx = 0;
+                                   int32_t dy = 0;
+                                   if ( parent >= 0 )
+                                   {
+                                       const point2d parent_pos = graph.position( parent );
+                                       dx = grid_detail::sign( pos.x - parent_pos.x );
+                                       dy = grid_detail::sign( pos.y - parent_pos.y );
+                                   }
+                                   grid_detail::for_each_direction( graph, pos, dx, dy,
+                                                                    [&]( int32_t jump_dx, int32_t jump_dy )
+                                                                    {
+                                                                        point2d jump_point( 0, 0 );
+                                                                        Tweight cost;
+                                                                        if ( grid_detail::jump( graph, pos, jump_dx, jump_dy,
+                                                                                                target_pos, jump_point, cost ) )
+                                                                        {
+                                                                            relax( graph.vertex( jump_point ), (Tweight)cost );
+                                                                        }
+                                                                    } );
+                               },
+                               heuristic, scratch );
+            return;
+        }
+        
+        /**
+         * Path of all cells from path of jump points (straight or diagonal lines between them).
+         */
+        template <typename T, typename Tlayout, typename Tcost_func>
+        std::vector<int32_t> expand_jump_path( const grid_graph<T,Tlayout,Tcost_func>& graph,
+                                               const std::vector<int32_t>& jump_points )
+        {
+            std::vector<int32_t> out;
+            if ( jump_points.empty() )
+            {
+                return out;
+            }
+            out.push_back( jump_points.front() );
+            for ( size_t i = 1; i < jump_points.size(); i++ )
+            {
+                ds::vector2d::point2d pos = graph.position( jump_points[i - 1] );
+                const ds::vector2d::point2d next = graph.position( jump_points[i] );
+                const int32_t dx = grid_detail::sign( next.x - pos.x );
+                const int32_t dy = grid_detail::sign( next.y - pos.y );
+                while ( pos.x != next.x || pos.y != next.y )
+                {
+                    pos = ds::vector2d::point2d( pos.x + dx, pos.y + dy );
+                    out.push_back( graph.vertex( pos ) );
+                }
+            }
+            return out;
+        }
+        
+        /********************************************************************************/
+    }
+}
+
+/****************************************************************************************/
@@ -0,0 +1,500 @@
+/**
+ * Streaming ingestion of edge lists into oriented graph.
+ */
+#pragma once
+
+/****************************************************************************************/
+
+/**
+ * edge_list_importer reads text edge list by chunks and feeds it into orgraph
+ * through pipeline of stages connected by bounded queues:
+ *      1.  reader thread     - reads chunks of whole lines from file;
+ *      2.  parser threads    - parse lines of chunks into edge records;
+ *      3.  calling thread    - maps node keys of records to nodes, adding missing
+ *                              nodes, and adds edges of chunk by one add_edges call.
+ * Stages run in parallel, queues bound memory by few chunks per stage.
+ * Chunks are applied in order of file, so result doesn't depend on timing.
+ * Graph is changed only by calling thread, so listeners of graph work as usual.
+ *
+ * Importer keeps mapping of keys to nodes, so next imports extend the same nodes
+ * and nodes can be found by keys. Frozen CSR view is made by freeze( graph ).
+ *
+ * Parser is called for every line as parse( line_begin, line_end, record ) and
+ * returns false for lines to skip. whitespace_edge_parser parses "source target [data]".
+ *
+ * Usage:
+ *      ds::orgraph::edge_list_importer<Tnode,Tedge,int64_t> importer( graph );
+ *      importer.import( file_p, ds::orgraph::whitespace_edge_parser<Tedge>(),
+ *                       []( int64_t key ) { return Tnode( key ); } );
+ *      auto found = importer.find( 42 );
+ */
+
+/****************************************************************************************/
+
+#include <vector>
+#include <string>
+#include <map>
+#include <unordered_map>
+#include <optional>
+#include <tuple>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "orgraph.hpp"
+
+/****************************************************************************************/
+
+namespace ds
+{
+    namespace orgraph
+    {
+        /********************************************************************************/
+        
+        /**
+         * Queue of limited capacity between stages of pipeline.
+         * push waits while queue is full, pop waits while queue is empty.
+         * After close push fails and pop fails as soon as queue is drained.
+         */
+        template <typename T>
+        class bounded_queue
+        {
+        private:
+            std::mutex              m_mutex;
+            std::condition_variable m_not_full_cv;
+            std::condition_variable m_not_empty_cv;
+            std::vector<T>          m_items; // ring buffer
+            size_t                  m_head   = 0;
+            size_t                  m_size   = 0;
+            bool                    m_closed = false;
+        
+        public:
+            explicit bounded_queue( size_t capacity ) :
+                m_items( std::max<size_t>( capacity, 1 ) )
+            {}
+            
+            bool push( T item )
+            {
+                std::unique_lock<std::mutex> lock( m_mutex );
+                m_not_full_cv.wait( lock, [&] { return ( m_closed || m_size < m_items.size() ); } );
+                if ( m_closed )
+                {
+                    return false;
+                }
+                m_items[ ( m_head + m_size ) % m_items.size() ] = std::move( item );
+                m_size++;
+                m_not_empty_cv.notify_one();
+                return true;
+            }
+            
+            bool pop( T& item )
+            {
+                std::unique_lock<std::mutex> lock( m_mutex );
+                m_not_empty_cv.wait( lock, [&] { return ( m_closed || m_size > 0 ); } );
+                if ( 0 == m_size )
+                {
+                    return false;
+                }
+                item = std::move( m_items[m_head] );
+                m_head = ( m_head + 1 ) % m_items.size();
+                m_size--;
+                m_not_full_cv.notify_one();
+                return true;
+            }
+            
+            void close()
+            {
+                std::lock_guard<std::mutex> lock( m_mutex );
+                m_closed = true;
+                m_not_full_cv.notify_all();
+                m_not_empty_cv.notify_all();
+                return;
+            }
+        };
+        
+        /********************************************************************************/
+        
+        /**
+         * Edge parsed from line of edge list.
+         */
+        template <typename Tkey, typename Tedge>
+        struct edge_record
+        {
+            Tkey  source;
+            Tkey  target;
+            Tedge data;
+        };
+        
+        /**
+         * Parser of lines "source target [data]" with integer keys separated by spaces
+         * or tabs. Data is read as number, if it is missing default value is used.
+         * Empty lines and comments starting with '#' or '%' are skipped.
+         * Only first 127 characters of line are parsed.
+         */
+        template <typename Tedge>
+        struct whitespace_edge_parser
+        {
+            Tedge default_data = Tedge();
+            
+            bool operator()( const char *begin, const char *end, edge_record<int64_t,Tedge>& out ) const
+            {
+                // line is copied, so strto* functions stop at its end
+                char buffer[128];
+                const size_t length = std::min<size_t>( end - begin, sizeof( buffer ) - 1 );
+                std::copy( begin, begin + length, buffer );
+                buffer[length] = '\0';
+                
+                const char *cur_p = buffer;
+                while ( ' ' == *cur_p || '\t' == *cur_p )
+                {
+                    cur_p++;
+                }
+                if ( '\0' == *cur_p || '#' == *cur_p || '%' == *cur_p )
+                {
+                    return false;
+                }
+                
+                char *next_p = nullptr;
+                out.source = strtoll( cur_p, &next_p, 10 );
+                if ( next_p == cur_p )
+                {
+                    return false;
+                }
+                cur_p = next_p;
+                out.target = strtoll( cur_p, &next_p, 10 );
+                if ( next_p == cur_p )
+                {
+                    return false;
+                }
+                cur_p = next_p;
+                
+                const double data = strtod( cur_p, &next_p );
+                out.data = ( next_p == cur_p ) ? default_data : (Tedge)data;
+                return true;
+            }
+        };
+        
+        /**
+         * Options of import.
+         */
+        struct ingest_options
+        {
+            size_t chunk_bytes  = 1 << 20; // chunk is extended to the end of its last line
+            size_t queue_chunks = 4;       // capacity of every queue
+            size_t num_parsers  = std::max<size_t>( std::thread::hardware_concurrency(), 2 ) - 1;
+        };
+        
+        /**
+         * Counters of import.
+         */
+        struct ingest_stats
+        {
+            uint64_t lines   = 0;
+            uint64_t skipped = 0; // lines rejected by parser
+            uint64_t nodes   = 0; // added nodes
+            uint64_t edges   = 0; // added edges
+        };
+        
+        /********************************************************************************/
+        
+        template <typename Tnode, typename Tedge, typename Tkey, typename Tstorage = map_storage,
+                  typename Thash = std::hash<Tkey>>
+        class edge_list_importer
+        {
+        public:
+            using graph_type  = orgraph<Tnode,Tedge,Tstorage>;
+            using node_type   = node_ref<Tnode,Tedge,Tstorage>;
+            using record_type = edge_record<Tkey,Tedge>;
+            
+            /*****************************************************************************
+                                            Inner types
+            *****************************************************************************/
+        private:
+            struct text_chunk
+            {
+                uint64_t    seq = 0;
+                std::string text;
+            };
+            
+            struct parsed_chunk
+            {
+                uint64_t                 seq     = 0;
+                uint64_t                 lines   = 0;
+                uint64_t                 skipped = 0;
+                std::vector<record_type> records;
+            };
+            
+            /*****************************************************************************
+                                                Data
+            *****************************************************************************/
+        private:
+            graph_type                                 &m_graph;
+            std::unordered_map< Tkey, node_type, Thash > m_nodes_by_key;
+            
+            /*****************************************************************************
+                                             Inner methods
+            *****************************************************************************/
+        private:
+            /**
+             * Reads file into chunks of whole lines.
+             * Throws std::runtime_error if reading fails before end of file.
+             */
+            static void read_chunks( FILE *file_p, const ingest_options& options,
+                                     bounded_queue<text_chunk>& out )
+            {
+                std::string carry;
+                uint64_t    seq = 0;
+                for ( ;; )
+                {
+                    text_chunk chunk;
+                    chunk.seq = seq++;
+                    chunk.text.swap( carry );
+                    
+                    const size_t old_size = chunk.text.size();
+                    chunk.text.resize( old_size + options.chunk_bytes );
+                    const size_t num_read = fread( &chunk.text[old_size], 1, options.chunk_bytes, file_p );
+                    chunk.text.resize( old_size + num_read );
+                    const bool at_end = ( num_read < options.chunk_bytes );
+                    if ( at_end && ferror( file_p ) )
+                    {
+                        throw std::runtime_error( "error of reading edge list after " +
+                                                  std::to_string( seq - 1 ) + " chunks" );
+                    }
+                    
+                    // incomplete last line goes to next chunk
+                    if ( !at_end )
+                    {
+                        const size_t last_eol = chunk.text.rfind( '\n' );
+                        if ( last_eol != std::string::npos )
+                        {
+                            carry.assign( chunk.text, last_eol + 1, std::string::npos );
+                            chunk.text.resize( last_eol + 1 );
+                        } else
+                        {
+                            carry.swap( chunk.text );
+                            seq--;
+                            continue;
+                        }
+                    }
+                    
+                    if ( !chunk.text.empty() && !out.push( std::move( chunk ) ) )
+                    {
+                        return;
+                    }
+                    if ( at_end )
+                    {
+                        return;
+                    }
+                }
+            }
+            
+            template <typename Tparse>
+            static parsed_chunk parse_chunk( const text_chunk& chunk, Tparse& parse )
+            {
+                parsed_chunk out;
+                out.seq = chunk.seq;
+                
+                const char *cur_p = chunk.text.data();
+                const char *end_p = cur_p + chunk.text.size();
+                while ( cur_p < end_p )
+                {
+                    const char *eol_p = std::find( cur_p, end_p, '\n' );
+                    const char *line_end_p = eol_p;
+                    if ( line_end_p > cur_p && '\r' == line_end_p[-1] )
+                    {
+                        line_end_p--;
+                    }
+                    
+                    out.lines++;
+                    record_type record{};
+                    if ( parse( cur_p, line_end_p, record ) )
+                    {
+                        out.records.push_back( std::move( record ) );
+                    } else
+                    {
+                        out.skipped++;
+                    }
+                    cur_p = eol_p + 1;
+                }
+                return out;
+            }
+            
+            template <typename Tmake_node>
+            node_type node_of_key( const Tkey& key, Tmake_node& make_node, ingest_stats& stats )
+            {
+                auto it = m_nodes_by_key.find( key );
+                if ( it != m_nodes_by_key.end() )
+                {
+                    return it->second;
+                }
+                stats.nodes++;
+                return m_nodes_by_key.emplace( key, m_graph.add_node( make_node( key ) ) ).first->second;
+            }
+            
+            template <typename Tmake_node>
+            void apply_chunk( parsed_chunk& chunk, Tmake_node& make_node, ingest_stats& stats )
+            {
+                std::vector< std::tuple<Tedge, node_type, node_type> > edges_data;
+                edges_data.reserve( chunk.records.size() );
+                for ( auto& cur_record : chunk.records )
+                {
+                    node_type source = node_of_key( cur_record.source, make_node, stats );
+                    node_type target = node_of_key( cur_record.target, make_node, stats );
+                    edges_data.emplace_back( std::move( cur_record.data ), source, target );
+                }
+                m_graph.add_edges( edges_data );
+                
+                stats.lines   += chunk.lines;
+                stats.skipped += chunk.skipped;
+                stats.edges   += chunk.records.size();
+                return;
+            }
+            
+            /*****************************************************************************
+                                          Public interface
+            *****************************************************************************/
+        public:
+            explicit edge_list_importer( graph_type& graph ) :
+                m_graph( graph )
+            {}
+            
+            /**
+             * Imports edge list, node for new key is made as make_node( key ).
+             * First exception of reading, of parser or of graph is rethrown after pipeline
+             * is stopped, chunks applied before it stay in graph.
+             */
+            template <typename Tparse, typename Tmake_node>
+            ingest_stats import( FILE *file_p, Tparse parse, Tmake_node make_node,
+                                 const ingest_options& options = ingest_options() )
+            {
+                bounded_queue<text_chunk>   text_queue( options.queue_chunks );
+                bounded_queue<parsed_chunk> parsed_queue( options.queue_chunks );
+                
+                std::mutex         error_mutex;
+                std::exception_ptr error;
+                auto stop = [&]( std::exception_ptr cur_error )
+                            {
+                                {
+                                    std::lock_guard<std::mutex> lock( error_mutex );
+                                    if ( !error )
+                                    {
+                                        error = cur_error;
+                                    }
+                                }
+                                text_queue.close();
+                                parsed_queue.close();
+                            };
+                
+                std::thread reader( [&]
+                                    {
+                                        try
+                                        {
+                                            read_chunks( file_p, options, text_queue );
+                                        } catch ( ... )
+                                        {
+                                            stop( std::current_exception() );
+                                        }
+                                        text_queue.close();
+                                    } );
+                
+                const size_t num_parsers = std::max<size_t>( options.num_parsers, 1 );
+                std::atomic<size_t> num_running( num_parsers );
+                std::vector<std::thread> parsers;
+                for ( size_t i = 0; i < num_parsers; i++ )
+                {
+                    parsers.emplace_back( [&, parse]() mutable
+                                          {
+                                              try
+                                              {
+                                                  text_chunk chunk;
+                                                  while ( text_queue.pop( chunk ) )
+                                                  {
+                                                      if ( !parsed_queue.push( parse_chunk( chunk, parse ) ) )
+                                                      {
+                                                          break;
+                                                      }
+                                                  }
+                                              } catch ( ... )
+                                              {
+                                                  stop( std::current_exception() );
+                                              }
+                                              if ( 1 == num_running.fetch_sub( 1 ) )
+                                              {
+                                                  parsed_queue.close();
+                                              }
+                                          } );
+                }
+                
+                // parsed chunks come out of order, they are applied in order of seq
+                ingest_stats                       stats;
+                std::map< uint64_t, parsed_chunk > pending;
+                uint64_t                           next_seq = 0;
+                try
+                {
+                    parsed_chunk chunk;
+                    while ( parsed_queue.pop( chunk ) )
+                    {
+                        const uint64_t seq = chunk.seq;
+                        pending.emplace( seq, std::move( chunk ) );
+                        for ( auto it = pending.find( next_seq ); it != pending.end();
+                              it = pending.find( next_seq ) )
+                        {
+                            apply_chunk( it->second, make_node, stats );
+                            pending.erase( it );
+                            next_seq++;
+                        }
+                    }
+                } catch ( ... )
+                {
+                    stop( std::current_exception() );
+                }
+                
+                reader.join();
+                for ( auto& parser : parsers )
+                {
+                    parser.join();
+                }
+                if ( error )
+                {
+                    std::rethrow_exception( error );
+                }
+                return stats;
+            }
+            
+            /**
+             * Finds node added for key by imports.
+             */
+            std::optional<node_type> find( const Tkey& key ) const
+            {
+                auto it = m_nodes_by_key.find( key );
+                if ( it == m_nodes_by_key.end() )
+                {
+                    return std::nullopt;
+                }
+                return it->second;
+            }
+            
+            /**
+             * Makes importer aware of node added for key beside imports.
+             */
+            void bind( const Tkey& key, const node_type& node )
+            {
+                m_nodes_by_key.erase( key );
+                m_nodes_by_key.emplace( key, node );
+                return;
+            }
+        };
+        
+        /********************************************************************************/
+    }
+}
+
+/****************************************************************************************/
@@ -0,0 +1,176 @@
+/**
+ * Renumbering of nodes of frozen graph for locality.
+ */
+#pragma once
+
+/****************************************************************************************/
+
+/**
+ * Traversals touch node data and adjacency of neighbours one after another, so they
+ * are faster when neighbours have close indices. Snapshot keeps orgraph id order,
+ * which is order of insertion. node_order( view, kind ) computes better order:
+ *      reorder_kind::rcm    - reverse Cuthill-McKee: breadth-first from node of least
+ *                             degree of every component, neighbours by increasing
+ *                             degree, then reversed; keeps neighbours in narrow band;
+ *      reorder_kind::bfs    - plain breadth-first order of every component;
+ *      reorder_kind::degree - by decreasing degree, so hubs share cache lines.
+ * Direction of edges is ignored, degree is number of pred and succ edges.
+ *
+ * Order is permutation: order[new index] = old index. reorder( view, kind ) makes
+ * permuted snapshot (see csr_view::permuted), it keeps ids of orgraph, so
+ * find() and origin() of new snapshot map its nodes back to graph.
+ *
+ * Usage:
+ *      ds::orgraph::csr_view<Tnode,Tedge> view =
+ *          ds::orgraph::reorder( ds::orgraph::freeze( graph ), ds::orgraph::reorder_kind::rcm );
+ */
+
+/****************************************************************************************/
+
+#include <vector>
+#include <algorithm>
+
+#include <stdint.h>
+
+#include "orgraph_csr.hpp"
+
+/****************************************************************************************/
+
+namespace ds
+{
+    namespace orgraph
+    {
+        /********************************************************************************/
+        
+        enum class reorder_kind
+        {
+            rcm,
+            bfs,
+            degree
+        };
+        
+        /**
+         * Computes order of nodes of snapshot.
+         * Returns: order[new index] = old index.
+         */
+        template <typename Tnode, typename Tedge>
+        std::vector<int32_t> node_order( const csr_view<Tnode,Tedge>& view, reorder_kind kind )
+        {
+            const int32_t num_nodes = view.node_count();
+            auto degree = [&]( int32_t n )
+                          {
+                              return ( view.succ_end( n ) - view.succ_begin( n ) ) +
+                                     ( view.pred_end( n ) - view.pred_begin( n ) );
+                          };
+            
+            std::vector<int32_t> order;
+            order.reserve( num_nodes );
+            for ( int32_t n = 0; n < num_nodes; n++ )
+            {
+                order.push_back( n );
+            }
+            
+            if ( reorder_kind::degree == kind )
+            {
+                std::stable_sort( order.begin(), order.end(),
+                                  [&]( int32_t a, int32_t b )
+                                  {
+                                      return ( degree( a ) > degree( b ) );
+                                  } );
+                return order;
+            }
+            
+            // Cuthill-McKee starts components from nodes of least degree
+            if ( reorder_kind::rcm == kind )
+            {
+                std::stable_sort( order.begin(), order.end(),
+                                  [&]( int32_t a, int32_t b )
+                                  {
+                                      return ( degree( a ) < degree( b ) );
+                                  } );
+            }
+            const std::vector<int32_t> starts = std::move( order );
+            
+            order.clear();
+            order.reserve( num_nodes );
+            std::vector<uint8_t> visited( num_nodes, 0 );
+            std::vector<int32_t> neighbours;
+            for ( const auto start : starts )
+            {
+                if ( visited[start] )
+                {
+                    continue;
+                }
+                visited[start] = 1;
+                
+                // order itself is queue of the search
+                size_t head = order.size();
+                order.push_back( start );
+                while ( head < order.size() )
+                {
+                    const int32_t n = order[head++];
+                    neighbours.clear();
+                    for ( int32_t e = view.succ_begin( n ); e < view.succ_end( n ); e++ )
+                    {
+                        neighbours.push_back( view.succ_target( e ) );
+                    }
+                    for ( int32_t pos = view.pred_begin( n ); pos < view.pred_end( n ); pos++ )
+                    {
+                        neighbours.push_back( view.pred_source( pos ) );
+                    }
+                    if ( reorder_kind::rcm == kind )
+                    {
+                        std::stable_sort( neighbours.begin(), neighbours.end(),
+                                          [&]( int32_t a, int32_t b )
+                                          {
+                                              return ( degree( a ) < degree( b ) );
+                                          } );
+                    }
+                    for ( const auto neighbour : neighbours )
+                    {
+                        if ( !visited[neighbour] )
+                        {
+                            visited[neighbour] = 1;
+                            order.push_back( neighbour );
+                        }
+                    }
+                }
+            }
+            
+            if ( reorder_kind::rcm == kind )
+            {
+                std::reverse( order.begin(), order.end() );
+            }
+            return order;
+        }
+        
+        /**
+         * Makes snapshot with nodes renumbered in order of kind.
+         */
+        template <typename Tnode, typename Tedge>
+        csr_view<Tnode,Tedge> reorder( const csr_view<Tnode,Tedge>& view, reorder_kind kind )
+        {
+            return view.permuted( node_order( view, kind ) );
+        }
+        
+        /**
+         * Bandwidth of snapshot: maximal difference of indices of nodes joined by edge.
+         * Tells how well order keeps neighbours close.
+         */
+        template <typename Tnode, typename Tedge>
+        int32_t bandwidth( const csr_view<Tnode,Tedge>& view )
+        {
+            int32_t out = 0;
+            for ( int32_t e = 0; e < view.edge_count(); e++ )
+            {
+                const int32_t distance = view.succ_target( e ) - view.edge_source( e );
+                out = std::max( out, ( distance < 0 ) ? -distance : distance );
+            }
+            return out;
+        }
+        
+        /********************************************************************************/
+    }
+}
+
+/****************************************************************************************/
@@ -0,0 +1,751 @@
+/**
+ * Strongly connected components and reachability of oriented graph.
+ */
+#pragma once
+
+/****************************************************************************************/
+
+/**
+ * Algorithms work through graph adapters (see orgraph_traversal.hpp).
+ *
+ * strongly_connected_components( graph ) is iterative Tarjan's algorithm, O(V+E).
+ * strongly_connected_components( graph, pool_p ) is parallel coloring algorithm:
+ * maximal vertex labels are propagated along edges, then every vertex keeping its
+ * own label collects its component by backward search inside its label.
+ * Both number components in topological order: every edge goes from component
+ * with smaller number to component with bigger or the same number.
+ *
+ * condensation is DAG of components, it is graph adapter itself.
+ *
+ * reachability_index answers "does u reach v" without search: condensation is
+ * labeled by intervals of post-order numbers of its spanning forest, and every
+ * component keeps merged intervals of all components it reaches. Query is binary
+ * search in intervals of one component.
+ *
+ * Usage:
+ *      auto graph = ds::orgraph::adapt( og );
+ *      ds::orgraph::reachability_index index( graph );
+ *      if ( index.reaches( graph.vertex( a ), graph.vertex( b ) ) )
+ *      {
+ *          ...
+ *      }
+ */
+
+/****************************************************************************************/
+
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <utility>
+
+#include <stdint.h>
+
+#include "orgraph_traversal.hpp"
+#include "thread_pool.hpp"
+
+/****************************************************************************************/
+
+namespace ds
+{
+    namespace orgraph
+    {
+        /********************************************************************************/
+        
+        /**
+         * Components of graph.
+         */
+        struct scc_result
+        {
+            // component of every vertex, -1 for holes
+            std::vector<int32_t> component;
+            int32_t              count = 0;
+        };
+        
+        /********************************************************************************/
+        
+        /**
+         * Finds strongly connected components by iterative Tarjan's algorithm.
+         */
+        template <typename Tgraph>
+        scc_result strongly_connected_components( const Tgraph& graph )
+        {
+            struct frame
+            {
+                int32_t v;
+                size_t  begin; // succs of v are succ_buffer[begin, end)
+                size_t  pos;
+                size_t  end;
+            };
+            
+            const int32_t num_vertices = graph.vertex_bound();
+            scc_result out;
+            out.component.assign( num_vertices, -1 );
+            
+            std::vector<int32_t> order( num_vertices, -1 ); // order of discovery
+            std::vector<int32_t> low( num_vertices, 0 );
+            std::vector<uint8_t> on_stack( num_vertices, 0 );
+            std::vector<int32_t> stack;
+            std::vector<int32_t> succ_buffer;
+            std::vector<frame>   frames;
+            int32_t              next_order = 0;
+            
+            auto enter = [&]( int32_t v )
+                         {
+                             order[v] = low[v] = next_order++;
+                             stack.push_back( v );
+                             on_stack[v] = 1;
+                             
+                             const size_t begin = succ_buffer.size();
+                             graph.for_each_succ( v, [&]( int32_t w, const auto& )
+                                                  {
+                                                      succ_buffer.push_back( w );
+                                                      return true;
+                                                  } );
+                             frames.push_back( frame{ v, begin, begin, succ_buffer.size() } );
+                         };
+            
+            for ( int32_t s = 0; s < num_vertices; s++ )
+            {
+                if ( !graph.is_vertex( s ) || order[s] >= 0 )
+                {
+                    continue;
+                }
+                
+                enter( s );
+                while ( !frames.empty() )
+                {
+                    frame& cur_frame = frames.back();
+                    if ( cur_frame.pos < cur_frame.end )
+                    {
+                        const int32_t w = succ_buffer[ cur_frame.pos++ ];
+                        if ( order[w] < 0 )
+                        {
+                            enter( w );
+                        } else if ( on_stack[w] )
+                        {
+                            low[cur_frame.v] = std::min( low[cur_frame.v], order[w] );
+                        }
+                        continue;
+                    }
+                    
+                    const int32_t v = cur_frame.v;
+                    succ_buffer.resize( cur_frame.begin );
+                    frames.pop_back();
+                    
+                    if ( low[v] == order[v] )
+                    {
+                        int32_t w;
+                        do
+                        {
+                            w = stack.back();
+                            stack.pop_back();
+                            on_stack[w] = 0;
+                            out.component[w] = out.count;
+                        } while ( w != v );
+                        out.count++;
+                    }
+                    if ( !frames.empty() )
+                    {
+                        const int32_t parent = frames.back().v;
+                        low[parent] = std::min( low[parent], low[v] );
+                    }
+                }
+            }
+            
+            // Tarjan's algorithm completes components in reverse topological order
+            for ( auto& cur_component : out.component )
+            {
+                if ( cur_component >= 0 )
+                {
+                    cur_component = out.count - 1 - cur_component;
+                }
+            }
+            return out;
+        }
+        
+        /********************************************************************************/
+        
+        /**
+         * Renumbers components given by any labels in [0, count) in topological order.
+         */
+        template <typename Tgraph>
+        void order_components( const Tgraph& graph, scc_result& scc )
+        {
+            const int32_t num_vertices = graph.vertex_bound();
+            
+            // edges between components grouped by source component
+            std::vector<int32_t> offsets( scc.count + 1, 0 );
+            std::vector<int32_t> in_degree( scc.count, 0 );
+            for ( int32_t v = 0; v < num_vertices; v++ )
+            {
+                if ( scc.component[v] < 0 )
+                {
+                    continue;
+                }
+                graph.for_each_succ( v, [&]( int32_t w, const auto& )
+                                     {
+                                         if ( scc.component[w] != scc.component[v] )
+                                         {
+                                             offsets[ scc.component[v] + 1 ]++;
+                                             in_degree[ scc.component[w] ]++;
+                                         }
+                                         return true;
+                                     } );
+            }
+            for ( int32_t c = 0; c < scc.count; c++ )
+            {
+                offsets[c + 1] += offsets[c];
+            }
+            std::vector<int32_t> targets( offsets[scc.count] );
+            std::vector<int32_t> fill( offsets.begin(), offsets.end() - 1 );
+            for ( int32_t v = 0; v < num_vertices; v++ )
+            {
+                if ( scc.component[v] < 0 )
+                {
+                    continue;
+                }
+                graph.for_each_succ( v, [&]( int32_t w, const auto& )
+                                     {
+                                         if ( scc.component[w] != scc.component[v] )
+                                         {
+                                             targets[ fill[ scc.component[v] ]++ ] = scc.component[w];
+                                         }
+                                         return true;
+                                     } );
+            }
+            
+            // Kahn's algorithm over components
+            std::vector<int32_t> order;
+            order.reserve( scc.count );
+            for ( int32_t c = 0; c < scc.count; c++ )
+            {
+                if ( 0 == in_degree[c] )
+                {
+                    order.push_back( c );
+                }
+            }
+            for ( size_t i = 0; i < order.size(); i++ )
+            {
+                for ( int32_t pos = offsets[ order[i] ]; pos < offsets[ order[i] + 1 ]; pos++ )
+                {
+                    if ( 0 == --in_degree[ targets[pos] ] )
+                    {
+                        order.push_back( targets[pos] );
+                    }
+                }
+            }
+            
+            std::vector<int32_t> new_number( scc.count );
+            for ( int32_t i = 0; i < scc.count; i++ )
+            {
+                new_number[ order[i] ] = i;
+            }
+            for ( auto& cur_component : scc.component )
+            {
+                if ( cur_component >= 0 )
+                {
+                    cur_component = new_number[cur_component];
+                }
+            }
+            return;
+        }
+        
+        /**
+         * Finds strongly connected components in parallel.
+         * If pool is nullptr, it is Tarjan's algorithm.
+         */
+        template <typename Tgraph>
+        scc_result strongly_connected_components( const Tgraph& graph, ds::thread_pool::thread_pool *pool_p,
+                                                  int64_t grain = 256 )
+        {
+            if ( nullptr == pool_p )
+            {
+                return strongly_connected_components( graph );
+            }
+            
+            const int32_t num_vertices = graph.vertex_bound();
+            scc_result out;
+            out.component.assign( num_vertices, -1 );
+            
+            // label is component root while components are found, -1 for not found yet
+            std::vector< std::atomic<int32_t> > label( num_vertices );
+            std::vector< std::atomic<int32_t> > color( num_vertices );
+            for ( int32_t v = 0; v < num_vertices; v++ )
+            {
+                label[v].store( -1, std::memory_order_relaxed );
+            }
+            
+            std::vector<int32_t> active;
+            for ( int32_t v = 0; v < num_vertices; v++ )
+            {
+                if ( graph.is_vertex( v ) )
+                {
+                    active.push_back( v );
+                }
+            }
+            
+            const size_t num_workers = ds::thread_pool::workers_count( pool_p );
+            std::vector< std::vector<int32_t> > worker_roots( num_workers );
+            std::vector< std::vector<int32_t> > worker_stacks( num_workers );
+            std::vector<int32_t>                roots;
+            
+            while ( !active.empty() )
+            {
+                const int64_t num_active = (int64_t)active.size();
+                
+                // every vertex gets maximal color of vertices reaching it
+                ds::thread_pool::parallel_for( pool_p, 0, num_active, grain,
+                                               [&]( int64_t begin, int64_t end, size_t )
+                                               {
+                                                   for ( int64_t i = begin; i < end; i++ )
+                                                   {
+                                                       color[ active[i] ].store( active[i], std::memory_order_relaxed );
+                                                   }
+                                               } );
+                std::atomic<bool> changed( true );
+                while ( changed.load() )
+                {
+                    changed.store( false );
+                    ds::thread_pool::parallel_for(
+                        pool_p, 0, num_active, grain,
+                        [&]( int64_t begin, int64_t end, size_t )
+                        {
+                            bool local_changed = false;
+                            for ( int64_t i = begin; i < end; i++ )
+                            {
+                                const int32_t v = active[i];
+                                const int32_t cur_color = color[v].load( std::memory_order_relaxed );
+                                graph.for_each_succ( v, [&]( int32_t w, const auto& )
+                                                     {
+                                                         if ( label[w].load( std::memory_order_relaxed ) >= 0 )
+                                                         {
+                                                             return true;
+                                                         }
+                                                         int32_t w_color = color[w].load( std::memory_order_relaxed );
+                                                         while ( w_color < cur_color &&
+                                                                 !color[w].compare_exchange_weak(
+                                                                     w_color, cur_color, std::memory_order_relaxed ) )
+                                                         {
+                                                         }
+                                                         local_changed |= ( w_color < cur_color );
+                                                         return true;
+                                                     } );
+                            }
+                            if ( local_changed )
+                            {
+                                changed.store( true );
+                            }
+                        } );
+                }
+                
+                // vertex keeping its own color roots component: vertices of its color reaching it
+                for ( auto& cur_roots : worker_roots )
+                {
+                    cur_roots.clear();
+                }
+                ds::thread_pool::parallel_for( pool_p, 0, num_active, grain,
+                                               [&]( int64_t begin, int64_t end, size_t worker )
+                                               {
+                                                   for ( int64_t i = begin; i < end; i++ )
+                                                   {
+                                                       if ( color[ active[i] ].load( std::memory_order_relaxed ) == active[i] )
+                                                       {
+                                                           worker_roots[worker].push_back( active[i] );
+                                                       }
+                                                   }
+                                               } );
+                roots.clear();
+                for ( const auto& cur_roots : worker_roots )
+                {
+                    roots.insert( roots.end(), cur_roots.begin(), cur_roots.end() );
+                }
+                
+                ds::thread_pool::parallel_for(
+                    pool_p, 0, (int64_t)roots.size(), 1,
+                    [&]( int64_t begin, int64_t end, size_t worker )
+                    {
+                        std::vector<int32_t>& stack = worker_stacks[worker];
+                        for ( int64_t i = begin; i < end; i++ )
+                        {
+                            const int32_t root = roots[i];
+                            label[root].store( root, std::memory_order_relaxed );
+                            stack.push_back( root );
+                            while ( !stack.empty() )
+                            {
+                                const int32_t v = stack.back();
+                                stack.pop_back();
+                                graph.for_each_pred( v, [&]( int32_t u, const auto& )
+                                                     {
+                                                         // vertices of this color are touched by this worker only
+                                                         if ( color[u].load( std::memory_order_relaxed ) == root &&
+                                                              label[u].load( std::memory_order_relaxed ) < 0 )
+                                                         {
+                                                             label[u].store( root, std::memory_order_relaxed );
+                                                             stack.push_back( u );
+                                                         }
+                                                         return true;
+                                                     } );
+                            }
+                        }
+                    } );
+                
+                active.erase( std::remove_if( active.begin(), active.end(),
+                                              [&]( int32_t v )
+                                              {
+                                                  return ( label[v].load( std::memory_order_relaxed ) >= 0 );
+                                              } ),
+                              active.end() );
+            }
+            
+            // roots become dense component numbers
+            std::vector<int32_t> number_of_root( num_vertices, -1 );
+            for ( int32_t v = 0; v < num_vertices; v++ )
+            {
+                if ( graph.is_vertex( v ) )
+                {
+                    const int32_t root = label[v].load( std::memory_order_relaxed );
+                    if ( number_of_root[root] < 0 )
+                    {
+                        number_of_root[root] = out.count++;
+                    }
+                    out.component[v] = number_of_root[root];
+                }
+            }
+            order_components( graph, out );
+            return out;
+        }
+        
+        /********************************************************************************/
+        
+        /**
+         * DAG of strongly connected components. Is graph adapter:
+         * vertex is component, edge data is number of graph edges between components.
+         */
+        class condensation
+        {
+        public:
+            using edge_data = int32_t;
+        
+        private:
+            std::vector<int32_t> m_succ_offsets;
+            std::vector<int32_t> m_succ_targets;
+            std::vector<int32_t> m_succ_counts;
+            
+            std::vector<int32_t> m_pred_offsets;
+            std::vector<int32_t> m_pred_sources;
+            std::vector<int32_t> m_pred_counts;
+            
+            /**
+             * Groups ( from, to ) links by from and merges repeated ones.
+             */
+            static void build( int32_t num_components,
+                               const std::vector< std::pair<int32_t,int32_t> >& links,
+                               std::vector<int32_t>& offsets, std::vector<int32_t>& targets,
+                               std::vector<int32_t>& counts )
+            {
+                std::vector<int32_t> starts( num_components + 1, 0 );
+                for ( const auto& [from, to] : links )
+                {
+                    starts[from + 1]++;
+                }
+                for ( int32_t c = 0; c < num_components; c++ )
+                {
+                    starts[c + 1] += starts[c];
+                }
+                std::vector<int32_t> grouped( links.size() );
+                std::vector<int32_t> fill( starts.begin(), starts.end() - 1 );
+                for ( const auto& [from, to] : links )
+                {
+                    grouped[ fill[from]++ ] = to;
+                }
+                
+                // position of last link to target from current component
+                std::vector<int32_t> last_pos( num_components, -1 );
+                offsets.assign( 1, 0 );
+                targets.clear();
+                counts.clear();
+                for ( int32_t c = 0; c < num_components; c++ )
+                {
+                    for ( int32_t pos = starts[c]; pos < starts[c + 1]; pos++ )
+                    {
+                        const int32_t to = grouped[pos];
+                        if ( last_pos[to] >= offsets.back() )
+                        {
+                            counts[ last_pos[to] ]++;
+                        } else
+                        {
+                            last_pos[to] = (int32_t)targets.size();
+                            targets.push_back( to );
+                            counts.push_back( 1 );
+                        }
+                    }
+                    offsets.push_back( (int32_t)targets.size() );
+                }
+                return;
+            }
+        
+        public:
+            template <typename Tgraph>
+            condensation( const Tgraph& graph, const scc_result& scc )
+            {
+                std::vector< std::pair<int32_t,int32_t> > succ_links;
+                for ( int32_t v = 0; v < graph.vertex_bound(); v++ )
+                {
+                    if ( scc.component[v] < 0 )
+                    {
+                        continue;
+                    }
+                    graph.for_each_succ( v, [&]( int32_t w, const auto& )
+                                         {
+                                             if ( scc.component[w] != scc.component[v] )
+                                             {
+                                                 succ_links.emplace_back( scc.component[v], scc.component[w] );
+                                             }
+                                             return true;
+                                         } );
+                }
+                build( scc.count, succ_links, m_succ_offsets, m_succ_targets, m_succ_counts );
+                
+                std::vector< std::pair<int32_t,int32_t> > pred_links;
+                pred_links.reserve( succ_links.size() );
+                for ( const auto& [from, to] : succ_links )
+                {
+                    pred_links.emplace_back( to, from );
+                }
+                build( scc.count, pred_links, m_pred_offsets, m_pred_sources, m_pred_counts );
+            }
+            
+            int32_t vertex_bound() const
+            {
+                return (int32_t)m_succ_offsets.size() - 1;
+            }
+            
+            bool is_vertex( int32_t v ) const
+            {
+                return ( v >= 0 && v < vertex_bound() );
+            }
+            
+            int64_t edge_count() const
+            {
+                return (int64_t)m_succ_targets.size();
+            }
+            
+            int32_t out_degree( int32_t v ) const
+            {
+                return m_succ_offsets[v + 1] - m_succ_offsets[v];
+            }
+            
+            template <typename Tfunc>
+            void for_each_succ( int32_t v, Tfunc f ) const
+            {
+                for ( int32_t pos = m_succ_offsets[v]; pos < m_succ_offsets[v + 1]; pos++ )
+                {
+                    if ( !f( m_succ_targets[pos], m_succ_counts[pos] ) )
+                    {
+                        return;
+                    }
+                }
+                return;
+            }
+            
+            template <typename Tfunc>
+            void for_each_pred( int32_t v, Tfunc f ) const
+            {
+                for ( int32_t pos = m_pred_offsets[v]; pos < m_pred_offsets[v + 1]; pos++ )
+                {
+                    if ( !f( m_pred_sources[pos], m_pred_counts[pos] ) )
+                    {
+                        return;
+                    }
+                }
+                return;
+            }
+            
+            /**
+             * Raw access: succs of v are at positions [succ_begin(v), succ_end(v)).
+             */
+            int32_t succ_begin( int32_t v ) const
+            {
+                return m_succ_offsets[v];
+            }
+            
+            int32_t succ_end( int32_t v ) const
+            {
+                return m_succ_offsets[v + 1];
+            }
+            
+            int32_t succ_target( int32_t pos ) const
+            {
+                return m_succ_targets[pos];
+            }
+        };
+        
+        /********************************************************************************/
+        
+        /**
+         * Index answering reachability queries between vertices of graph.
+         * Is built once, graph changes are not tracked.
+         */
+        class reachability_index
+        {
+        private:
+            struct interval
+            {
+                int32_t low;
+                int32_t high;
+            };
+            
+            scc_result            m_scc;
+            std::vector<int32_t>  m_post;      // post-order number of component
+            std::vector<int32_t>  m_offsets;   // intervals of component c are [m_offsets[c], m_offsets[c + 1])
+            std::vector<interval> m_intervals;
+            
+            void label( const condensation& dag )
+            {
+                const int32_t num_components = dag.vertex_bound();
+                
+                // post-order numbers of spanning forest, subtree of c is [low[c], m_post[c]]
+                m_post.assign( num_components, -1 );
+                std::vector<int32_t> low( num_components, 0 );
+                std::vector<uint8_t> visited( num_components, 0 );
+                std::vector< std::pair<int32_t,int32_t> > stack; // ( component, next succ position )
+                int32_t next_post = 0;
+                for ( int32_t root = 0; root < num_components; root++ )
+                {
+                    if ( visited[root] )
+                    {
+                        continue;
+                    }
+                    visited[root] = 1;
+                    low[root] = next_post;
+                    stack.emplace_back( root, dag.succ_begin( root ) );
+                    while ( !stack.empty() )
+                    {
+                        // resumed component continues from its position, so every succ is seen once
+                        auto& [c, pos] = stack.back();
+                        const int32_t end = dag.succ_end( c );
+                        int32_t child = -1;
+                        while ( pos < end && child < 0 )
+                        {
+                            const int32_t w = dag.succ_target( pos++ );
+                            if ( !visited[w] )
+                            {
+                                child = w;
+                            }
+                        }
+                        if ( child >= 0 )
+                        {
+                            visited[child] = 1;
+                            low[child] = next_post;
+                            stack.emplace_back( child, dag.succ_begin( child ) );
+                        } else
+                        {
+                            m_post[c] = next_post++;
+                            stack.pop_back();
+                        }
+                    }
+                }
+                
+                // intervals of component merge its subtree and intervals of its succs,
+                // succs have bigger numbers, so components are labeled from the last one
+                std::vector< std::vector<interval> > intervals( num_components );
+                std::vector<interval> merged;
+                for ( int32_t c = num_components - 1; c >= 0; c-- )
+                {
+                    merged.clear();
+                    merged.push_back( interval{ low[c], m_post[c] } );
+                    dag.for_each_succ( c, [&]( int32_t w, const auto& )
+                                       {
+                                           merged.insert( merged.end(), intervals[w].begin(), intervals[w].end() );
+                                           return true;
+                                       } );
+                    std::sort( merged.begin(), merged.end(),
+                               []( const interval& a, const interval& b )
+                               {
+                                   return ( a.low < b.low );
+                               } );
+                    std::vector<interval>& out = intervals[c];
+                    for ( const auto& cur_interval : merged )
+                    {
+                        if ( !out.empty() && cur_interval.low <= out.back().high + 1 )
+                        {
+                            out.back().high = std::max( out.back().high, cur_interval.high );
+                        } else
+                        {
+                            out.push_back( cur_interval );
+                        }
+                    }
+                }
+                
+                m_offsets.assign( 1, 0 );
+                for ( int32_t c = 0; c < num_components; c++ )
+                {
+                    m_intervals.insert( m_intervals.end(), intervals[c].begin(), intervals[c].end() );
+                    m_offsets.push_back( (int32_t)m_intervals.size() );
+                }
+                return;
+            }
+        
+        public:
+            /**
+             * Builds index of graph, components are found in pool if it is given.
+             */
+            template <typename Tgraph>
+            explicit reachability_index( const Tgraph& graph, ds::thread_pool::thread_pool *pool_p = nullptr ) :
+                m_scc( strongly_connected_components( graph, pool_p ) )
+            {
+                label( condensation( graph, m_scc ) );
+            }
+            
+            /**
+             * Checks if there is path from vertex u to vertex v, vertex reaches itself.
+             * Holes (not vertices of graph) reach nothing and are not reached.
+             */
+            bool reaches( int32_t u, int32_t v ) const
+            {
+                const int32_t cu = m_scc.component[u];
+                const int32_t cv = m_scc.component[v];
+                if ( cu < 0 || cv < 0 )
+                {
+                    return false;
+                }
+                if ( cu == cv )
+                {
+                    return true;
+                }
+                if ( cu > cv )
+                {
+                    // components are in topological order
+                    return false;
+                }
+                
+                const int32_t post = m_post[cv];
+                const interval *begin_p = m_intervals.data() + m_offsets[cu];
+                const interval *end_p   = m_intervals.data() + m_offsets[cu + 1];
+                const interval *it = std::upper_bound( begin_p, end_p, post,
+                                                       []( int32_t value, const interval& cur_interval )
+                                                       {
+                                                           return ( value < cur_interval.low );
+                                                       } );
+                return ( it != begin_p && post <= ( it - 1 )->high );
+            }
+            
+            const scc_result& components() const
+            {
+                return m_scc;
+            }
+            
+            /**
+             * Number of intervals kept by index, tells its size.
+             */
+            size_t interval_count() const
+            {
+                return m_intervals.size();
+            }
+        };
+        
+        /********************************************************************************/
+    }
+}
+
+/****************************************************************************************/
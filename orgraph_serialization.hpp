@@ -0,0 +1,511 @@
+/**
+ * Binary serialization of oriented graph.
+ */
+#pragma once
+
+/****************************************************************************************/
+
+/**
+ * Graph is stored as its frozen CSR snapshot (see orgraph_csr.hpp): header and
+ * table of sections followed by arrays of snapshot, every array is aligned to 64 bytes.
+ * Arrays are written in native byte order, header tells if file is readable here.
+ *
+ * Payloads are stored by payload_codec<T>:
+ *      trivially copyable payloads are written as raw arrays;
+ *      others need specialization of payload_codec with encode/decode, they are
+ *      written as encoded blobs with array of offsets.
+ *
+ * map_csr( path ) maps file to memory and serves snapshot straight from mapping,
+ * nothing is copied or parsed except decoded payloads. Mapping is shared by copies
+ * of snapshot and is unmapped with the last of them. Many processes mapping one file
+ * share its pages.
+ *
+ * Usage:
+ *      ds::orgraph::save( graph, "graph.bin" );
+ *      ds::orgraph::csr_view<Tnode,Tedge> view = ds::orgraph::map_csr<Tnode,Tedge>( "graph.bin" );
+ *      ds::orgraph::read_graph( "graph.bin", other_graph );
+ *
+ * Note: mapping depends on POSIX mmap.
+ * Note: header and sizes of sections are checked, contents of arrays are trusted.
+ */
+
+/****************************************************************************************/
+
+#include <vector>
+#include <string>
+#include <stdexcept>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <cstring>
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "orgraph.hpp"
+#include "orgraph_csr.hpp"
+
+/****************************************************************************************/
+
+namespace ds
+{
+    namespace orgraph
+    {
+        /********************************************************************************/
+        
+        /**
+         * Codec of payloads of nodes or edges.
+         * Specialization for non trivially copyable type should have
+         *      static constexpr bool is_raw = false;
+         *      static void encode( const T& value, std::vector<char>& out ) - appends bytes;
+         *      static T    decode( const char *data_p, size_t size );
+         */
+        template <typename T, typename Tenable = void>
+        struct payload_codec;
+        
+        template <typename T>
+        struct payload_codec< T, std::enable_if_t< std::is_trivially_copyable<T>::value > >
+        {
+            static constexpr bool is_raw = true;
+        };
+        
+        template <>
+        struct payload_codec<std::string>
+        {
+            static constexpr bool is_raw = false;
+            
+            static void encode( const std::string& value, std::vector<char>& out )
+            {
+                out.insert( out.end(), value.begin(), value.end() );
+                return;
+            }
+            
+            static std::string decode( const char *data_p, size_t size )
+            {
+                return std::string( data_p, size );
+            }
+        };
+        
+        /********************************************************************************/
+        
+        /**
+         * Reading and writing of csr_view files.
+         */
+        template <typename Tnode, typename Tedge>
+        class csr_file
+        {
+            /*****************************************************************************
+                                            Inner types
+            *****************************************************************************/
+        private:
+            using view_type = csr_view<Tnode,Tedge>;
+            
+            enum section_kind
+            {
+                NODE_DATA = 0,
+                NODE_DATA_OFFSETS,
+                EDGE_DATA,
+                EDGE_DATA_OFFSETS,
+                SUCC_OFFSETS,
+                SUCC_TARGETS,
+                EDGE_SOURCES,
+                PRED_OFFSETS,
+                PRED_SOURCES,
+                PRED_EDGES,
+                NODE_IDS,
+                EDGE_IDS,
+                NODE_INDEX_OF_ID,
+                NUM_SECTIONS
+            };
+            
+            struct section
+            {
+                uint64_t offset; // from start of file
+                uint64_t size;   // in bytes
+            };
+            
+            struct header
+            {
+                char     magic[8];
+                uint32_t version;
+                uint32_t byte_order;
+                uint32_t node_data_size; // size of raw payload or 0 for encoded
+                uint32_t edge_data_size;
+                uint64_t node_count;
+                uint64_t edge_count;
+                section  sections[NUM_SECTIONS];
+            };
+            
+            static constexpr char     FILE_MAGIC[8]     = { 'D', 'S', 'O', 'R', 'G', 'R', 'P', 'H' };
+            static constexpr uint32_t FILE_VERSION      = 1;
+            static constexpr uint32_t BYTE_ORDER_MARK   = 0x01020304;
+            static constexpr uint64_t SECTION_ALIGNMENT = 64;
+            
+            /**
+             * Mapping of file, is unmapped in destructor.
+             */
+            struct mapping
+            {
+                void  *addr_p = nullptr;
+                size_t size   = 0;
+                
+                ~mapping()
+                {
+                    if ( nullptr != addr_p )
+                    {
+                        munmap( addr_p, size );
+                    }
+                }
+            };
+            
+            /**
+             * Owner of mapped snapshot: mapping and decoded payloads.
+             */
+            struct mapped_arrays
+            {
+                mapping            file;
+                std::vector<Tnode> node_data;
+                std::vector<Tedge> edge_data;
+            };
+            
+            /*****************************************************************************
+                                             Inner methods
+            *****************************************************************************/
+        private:
+            [[noreturn]] static void throw_bad_file( const std::string& path, const std::string& what )
+            {
+                throw std::runtime_error( "orgraph file " + path + ": " + what );
+            }
+            
+            /**
+             * Appends payloads to blob, raw or encoded.
+             */
+            template <typename T>
+            static void encode_payloads( const csr_array<T>& data, std::vector<char>& blob,
+                                         std::vector<uint64_t>& offsets )
+            {
+                if constexpr ( payload_codec<T>::is_raw )
+                {
+                    blob.resize( data.size() * sizeof( T ) );
+                    if ( data.size() > 0 )
+                    {
+                        std::memcpy( blob.data(), (const void*)data.data(), blob.size() );
+                    }
+                } else
+                {
+                    offsets.reserve( data.size() + 1 );
+                    offsets.push_back( 0 );
+                    for ( const auto& cur_value : data )
+                    {
+                        payload_codec<T>::encode( cur_value, blob );
+                        offsets.push_back( blob.size() );
+                    }
+                }
+                return;
+            }
+            
+            template <typename T>
+            static uint32_t raw_size()
+            {
+                if constexpr ( payload_codec<T>::is_raw )
+                {
+                    return (uint32_t)sizeof( T );
+                } else
+                {
+                    return 0;
+                }
+            }
+            
+            static void write_all( FILE *file_p, const void *data_p, size_t size, const std::string& path )
+            {
+                if ( size > 0 && fwrite( data_p, 1, size, file_p ) != size )
+                {
+                    fclose( file_p );
+                    throw_bad_file( path, "write failed" );
+                }
+                return;
+            }
+            
+            /**
+             * Gives view of section checking its bounds against file.
+             */
+            template <typename T>
+            static csr_array<T> section_array( const mapping& file, const header& head,
+                                               section_kind kind, size_t count,
+                                               const std::string& path )
+            {
+                const section& cur_section = head.sections[kind];
+                if ( cur_section.size != count * sizeof( T ) ||
+                     cur_section.offset % SECTION_ALIGNMENT != 0 ||
+                     cur_section.offset > file.size ||
+                     cur_section.size > file.size - cur_section.offset )
+                {
+                    throw_bad_file( path, "section " + std::to_string( (int)kind ) + " is broken" );
+                }
+                return csr_array<T>( reinterpret_cast<const T*>( (const char*)file.addr_p +
+                                                                 cur_section.offset ),
+                                     count );
+            }
+            
+            /**
+             * Gives payloads: mapped array, if they are raw, or decoded vector.
+             */
+            template <typename T>
+            static csr_array<T> map_payloads( const mapping& file, const header& head,
+                                              section_kind data_kind, section_kind offsets_kind,
+                                              size_t count, std::vector<T>& decoded,
+                                              const std::string& path )
+            {
+                if constexpr ( payload_codec<T>::is_raw )
+                {
+                    return section_array<T>( file, head, data_kind, count, path );
+                } else
+                {
+                    csr_array<uint64_t> offsets =
+                        section_array<uint64_t>( file, head, offsets_kind, count + 1, path );
+                    csr_array<char> blob =
+                        section_array<char>( file, head, data_kind, offsets[count], path );
+                    
+                    decoded.reserve( count );
+                    for ( size_t i = 0; i < count; i++ )
+                    {
+                        if ( offsets[i] > offsets[i + 1] || offsets[i + 1] > blob.size() )
+                        {
+                            throw_bad_file( path, "payload " + std::to_string( i ) + " is broken" );
+                        }
+                        decoded.push_back( payload_codec<T>::decode( blob.data() + offsets[i],
+                                                                     offsets[i + 1] - offsets[i] ) );
+                    }
+                    return decoded;
+                }
+            }
+            
+            /*****************************************************************************
+                                          Public interface
+            *****************************************************************************/
+        public:
+            /**
+             * Writes snapshot to file, file is overwritten.
+             */
+            static void save( const view_type& view, const std::string& path )
+            {
+                std::vector<char>     node_blob;
+                std::vector<uint64_t> node_offsets;
+                std::vector<char>     edge_blob;
+                std::vector<uint64_t> edge_offsets;
+                encode_payloads( view.m_node_data, node_blob, node_offsets );
+                encode_payloads( view.m_edge_data, edge_blob, edge_offsets );
+                
+                const void *data_p[NUM_SECTIONS] = {};
+                header head;
+                std::memset( (void*)&head, 0, sizeof( head ) );
+                std::memcpy( head.magic, FILE_MAGIC, sizeof( FILE_MAGIC ) );
+                head.version        = FILE_VERSION;
+                head.byte_order     = BYTE_ORDER_MARK;
+                head.node_data_size = raw_size<Tnode>();
+                head.edge_data_size = raw_size<Tedge>();
+                head.node_count     = view.node_count();
+                head.edge_count     = view.edge_count();
+                
+                auto set_section = [&]( section_kind kind, const void *cur_data_p, size_t size )
+                                   {
+                                       data_p[kind] = cur_data_p;
+                                       head.sections[kind].size = size;
+                                   };
+                auto set_array = [&]( section_kind kind, const auto& array )
+                                 {
+                                     set_section( kind, array.data(), array.size() * sizeof( array[0] ) );
+                                 };
+                set_section( NODE_DATA, node_blob.data(), node_blob.size() );
+                set_array( NODE_DATA_OFFSETS, node_offsets );
+                set_section( EDGE_DATA, edge_blob.data(), edge_blob.size() );
+                set_array( EDGE_DATA_OFFSETS, edge_offsets );
+                set_array( SUCC_OFFSETS, view.m_succ_offsets );
+                set_array( SUCC_TARGETS, view.m_succ_targets );
+                set_array( EDGE_SOURCES, view.m_edge_sources );
+                set_array( PRED_OFFSETS, view.m_pred_offsets );
+                set_array( PRED_SOURCES, view.m_pred_sources );
+                set_array( PRED_EDGES, view.m_pred_edges );
+                set_array( NODE_IDS, view.m_node_ids );
+                set_array( EDGE_IDS, view.m_edge_ids );
+                set_array( NODE_INDEX_OF_ID, view.m_node_index_of_id );
+                
+                uint64_t offset = sizeof( header );
+                for ( int kind = 0; kind < NUM_SECTIONS; kind++ )
+                {
+                    offset = ( offset + SECTION_ALIGNMENT - 1 ) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+                    head.sections[kind].offset = offset;
+                    offset += head.sections[kind].size;
+                }
+                
+                FILE *file_p = fopen( path.c_str(), "wb" );
+                if ( nullptr == file_p )
+                {
+                    throw_bad_file( path, "cannot be opened for writing" );
+                }
+                static const char padding[SECTION_ALIGNMENT] = {};
+                uint64_t written = 0;
+                write_all( file_p, &head, sizeof( head ), path );
+                written += sizeof( head );
+                for ( int kind = 0; kind < NUM_SECTIONS; kind++ )
+                {
+                    write_all( file_p, padding, head.sections[kind].offset - written, path );
+                    write_all( file_p, data_p[kind], head.sections[kind].size, path );
+                    written = head.sections[kind].offset + head.sections[kind].size;
+                }
+                if ( 0 != fclose( file_p ) )
+                {
+                    throw_bad_file( path, "write failed" );
+                }
+                return;
+            }
+            
+            /**
+             * Maps file and makes snapshot reading arrays from mapping.
+             */
+            static view_type map( const std::string& path )
+            {
+                auto arrays_p = std::make_shared<mapped_arrays>();
+                mapping& file = arrays_p->file;
+                
+                const int fd = open( path.c_str(), O_RDONLY );
+                if ( fd < 0 )
+                {
+                    throw_bad_file( path, "cannot be opened" );
+                }
+                struct stat file_stat;
+                if ( 0 != fstat( fd, &file_stat ) || (size_t)file_stat.st_size < sizeof( header ) )
+                {
+                    close( fd );
+                    throw_bad_file( path, "is too short" );
+                }
+                file.size = (size_t)file_stat.st_size;
+                void *addr_p = mmap( nullptr, file.size, PROT_READ, MAP_SHARED, fd, 0 );
+                close( fd );
+                if ( MAP_FAILED == addr_p )
+                {
+                    throw_bad_file( path, "cannot be mapped" );
+                }
+                file.addr_p = addr_p;
+                
+                header head;
+                std::memcpy( (void*)&head, file.addr_p, sizeof( head ) );
+                if ( 0 != std::memcmp( head.magic, FILE_MAGIC, sizeof( FILE_MAGIC ) ) )
+                {
+                    throw_bad_file( path, "is not orgraph file" );
+                }
+                if ( FILE_VERSION != head.version || BYTE_ORDER_MARK != head.byte_order )
+                {
+                    throw_bad_file( path, "has unsupported version or byte order" );
+                }
+                if ( raw_size<Tnode>() != head.node_data_size || raw_size<Tedge>() != head.edge_data_size )
+                {
+                    throw_bad_file( path, "has other payload types" );
+                }
+                
+                const size_t num_nodes = head.node_count;
+                const size_t num_edges = head.edge_count;
+                
+                view_type view;
+                view.m_node_data = map_payloads<Tnode>( file, head, NODE_DATA, NODE_DATA_OFFSETS,
+                                                        num_nodes, arrays_p->node_data, path );
+                view.m_edge_data = map_payloads<Tedge>( file, head, EDGE_DATA, EDGE_DATA_OFFSETS,
+                                                        num_edges, arrays_p->edge_data, path );
+                view.m_succ_offsets = section_array<int32_t>( file, head, SUCC_OFFSETS, num_nodes + 1, path );
+                view.m_succ_targets = section_array<int32_t>( file, head, SUCC_TARGETS, num_edges, path );
+                view.m_edge_sources = section_array<int32_t>( file, head, EDGE_SOURCES, num_edges, path );
+                view.m_pred_offsets = section_array<int32_t>( file, head, PRED_OFFSETS, num_nodes + 1, path );
+                view.m_pred_sources = section_array<int32_t>( file, head, PRED_SOURCES, num_edges, path );
+                view.m_pred_edges   = section_array<int32_t>( file, head, PRED_EDGES, num_edges, path );
+                view.m_node_ids     = section_array<node_id>( file, head, NODE_IDS, num_nodes, path );
+                view.m_edge_ids     = section_array<edge_id>( file, head, EDGE_IDS, num_edges, path );
+                view.m_node_index_of_id =
+                    section_array<int32_t>( file, head, NODE_INDEX_OF_ID,
+                                            head.sections[NODE_INDEX_OF_ID].size / sizeof( int32_t ), path );
+                
+                // cheap checks that offsets don't lead out of arrays
+                if ( view.m_succ_offsets[0] != 0 || view.m_succ_offsets[num_nodes] != (int32_t)num_edges ||
+                     view.m_pred_offsets[0] != 0 || view.m_pred_offsets[num_nodes] != (int32_t)num_edges )
+                {
+                    throw_bad_file( path, "adjacency is broken" );
+                }
+                
+                view.m_owner_p = std::move( arrays_p );
+                return view;
+            }
+        };
+        
+        /********************************************************************************/
+        
+        /**
+         * Writes snapshot to file.
+         */
+        template <typename Tnode, typename Tedge>
+        void save( const csr_view<Tnode,Tedge>& view, const std::string& path )
+        {
+            csr_file<Tnode,Tedge>::save( view, path );
+            return;
+        }
+        
+        /**
+         * Writes current state of graph to file.
+         */
+        template <typename Tnode, typename Tedge, typename Tstorage>
+        void save( const orgraph<Tnode,Tedge,Tstorage>& graph, const std::string& path )
+        {
+            csr_file<Tnode,Tedge>::save( freeze( graph ), path );
+            return;
+        }
+        
+        /**
+         * Maps file written by save as snapshot.
+         * Throws std::runtime_error if file is unreadable or is written for other types.
+         */
+        template <typename Tnode, typename Tedge>
+        csr_view<Tnode,Tedge> map_csr( const std::string& path )
+        {
+            return csr_file<Tnode,Tedge>::map( path );
+        }
+        
+        /**
+         * Adds nodes and edges of file to graph.
+         * Returns: refs to added nodes in order of node indices of file.
+         */
+        template <typename Tnode, typename Tedge, typename Tstorage>
+        std::vector< node_ref<Tnode,Tedge,Tstorage> > read_graph( const std::string& path,
+                                                                 orgraph<Tnode,Tedge,Tstorage>& graph )
+        {
+            const csr_view<Tnode,Tedge> view = map_csr<Tnode,Tedge>( path );
+            
+            std::vector<Tnode> nodes_data;
+            nodes_data.reserve( view.node_count() );
+            for ( int32_t n = 0; n < view.node_count(); n++ )
+            {
+                nodes_data.push_back( view.node_data( n ) );
+            }
+            std::vector< node_ref<Tnode,Tedge,Tstorage> > nodes = graph.add_nodes( nodes_data );
+            
+            using edge_tuple = std::tuple< Tedge, node_ref<Tnode,Tedge,Tstorage>,
+                                           node_ref<Tnode,Tedge,Tstorage> >;
+            std::vector<edge_tuple> edges_data;
+            edges_data.reserve( view.edge_count() );
+            for ( int32_t e = 0; e < view.edge_count(); e++ )
+            {
+                edges_data.emplace_back( view.edge_data( e ), nodes[ view.edge_source( e ) ],
+                                         nodes[ view.succ_target( e ) ] );
+            }
+            graph.add_edges( edges_data );
+            
+            return nodes;
+        }
+        
+        /********************************************************************************/
+    }
+}
+
+/****************************************************************************************/
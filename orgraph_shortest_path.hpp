@@ -0,0 +1,669 @@
+/**
+ * Shortest paths in oriented graph.
+ */
+#pragma once
+
+/****************************************************************************************/
+
+/**
+ * Algorithms work through graph adapters (see orgraph_traversal.hpp).
+ * Weight of edge is given by functor: weight( const edge_data& ) -> Tweight,
+ * weights should be non-negative.
+ *
+ * All buffers of query live in shortest_path_scratch<Tweight>, which is reused
+ * by next queries: only vertices touched by previous query are reset, so
+ * repeated queries don't allocate and don't pay O(V) for cleaning.
+ *
+ * Usage:
+ *      ds::orgraph::shortest_path_scratch<double> scratch;
+ *      ds::orgraph::dijkstra( graph, source, weight, scratch, target );
+ *      if ( scratch.reached( target ) )
+ *      {
+ *          ... scratch.distance( target ), scratch.path( target ) ...
+ *      }
+ *
+ * astar( graph, source, target, weight, heuristic, scratch ) is goal-directed search:
+ * heuristic( vertex ) -> Tweight is estimate of distance from vertex to target,
+ * path is shortest if estimate is never greater than real distance.
+ */
+
+/****************************************************************************************/
+
+#include <vector>
+#include <string>
+#include <stdexcept>
+#include <limits>
+#include <algorithm>
+#include <utility>
+
+#include <stdint.h>
+
+#include "orgraph_traversal.hpp"
+#include "thread_pool.hpp"
+
+/****************************************************************************************/
+
+namespace ds
+{
+    namespace orgraph
+    {
+        /********************************************************************************/
+        
+        /**
+         * D-ary min heap of vertices keyed by external array of keys.
+         * Keeps position of every vertex, so key of vertex in heap can be decreased.
+         * Wide nodes make heap shallow and keep children in one cache line.
+         */
+        template <typename Tkey, int32_t D = 4>
+        class indexed_dary_heap
+        {
+        private:
+            std::vector<int32_t> m_heap;
+            std::vector<int32_t> m_pos; // position in m_heap or -1
+            const Tkey          *m_keys_p = nullptr;
+            
+            void place( size_t i, int32_t v )
+            {
+                m_heap[i] = v;
+                m_pos[v] = (int32_t)i;
+                return;
+            }
+            
+            void sift_up( size_t i )
+            {
+                const int32_t v = m_heap[i];
+                const Tkey    key = m_keys_p[v];
+                while ( i > 0 )
+                {
+                    const size_t parent = ( i - 1 ) / D;
+                    if ( !( key < m_keys_p[ m_heap[parent] ] ) )
+                    {
+                        break;
+                    }
+                    place( i, m_heap[parent] );
+                    i = parent;
+                }
+                place( i, v );
+                return;
+            }
+            
+            void sift_down( size_t i )
+            {
+                const int32_t v = m_heap[i];
+                const Tkey    key = m_keys_p[v];
+                const size_t  size = m_heap.size();
+                for ( ;; )
+                {
+                    const size_t first_child = i * D + 1;
+                    if ( first_child >= size )
+                    {
+                        break;
+                    }
+                    const size_t last_child = std::min( first_child + D, size );
+                    
+                    size_t best = first_child;
+                    for ( size_t child = first_child + 1; child < last_child; child++ )
+                    {
+                        if ( m_keys_p[ m_heap[child] ] < m_keys_p[ m_heap[best] ] )
+                        {
+                            best = child;
+                        }
+                    }
+                    if ( !( m_keys_p[ m_heap[best] ] < key ) )
+                    {
+                        break;
+                    }
+                    place( i, m_heap[best] );
+                    i = best;
+                }
+                place( i, v );
+                return;
+            }
+        
+        public:
+            /**
+             * Prepares heap for vertices in [0, num_vertices) keyed by keys_p[vertex].
+             * Heap should be empty.
+             */
+            void prepare( int32_t num_vertices, const Tkey *keys_p )
+            {
+                m_keys_p = keys_p;
+                if ( (int32_t)m_pos.size() != num_vertices )
+                {
+                    m_pos.assign( num_vertices, -1 );
+                }
+                return;
+            }
+            
+            bool empty() const
+            {
+                return m_heap.empty();
+            }
+            
+            bool contains( int32_t v ) const
+            {
+                return ( m_pos[v] >= 0 );
+            }
+            
+            /**
+             * Inserts vertex or, if it is in heap, restores order after its key decreased.
+             */
+            void push_or_decrease( int32_t v )
+            {
+                if ( m_pos[v] < 0 )
+                {
+                    m_heap.push_back( v );
+                    m_pos[v] = (int32_t)m_heap.size() - 1;
+                }
+                sift_up( m_pos[v] );
+                return;
+            }
+            
+            int32_t pop()
+            {
+                const int32_t top = m_heap.front();
+                m_pos[top] = -1;
+                
+                const int32_t last = m_heap.back();
+                m_heap.pop_back();
+                if ( !m_heap.empty() )
+                {
+                    place( 0, last );
+                    sift_down( 0 );
+                }
+                return top;
+            }
+            
+            void clear()
+            {
+                for ( auto v : m_heap )
+                {
+                    m_pos[v] = -1;
+                }
+                m_heap.clear();
+                return;
+            }
+        };
+        
+        /********************************************************************************/
+        
+        /**
+         * Forward declarations.
+         */
+        template <typename Tweight> class shortest_path_scratch;
+        
+        template <typename Tadapter, typename Tweight_func, typename Tweight>
+        void dijkstra( const Tadapter& graph, int32_t source, Tweight_func weight,
+                       shortest_path_scratch<Tweight>& scratch, int32_t target = -1 );
+        
+        template <typename Tadapter, typename Tweight_func, typename Tweight>
+        void delta_stepping( const Tadapter& graph, int32_t source, Tweight_func weight,
+                             Tweight delta, shortest_path_scratch<Tweight>& scratch,
+                             ds::thread_pool::thread_pool *pool_p = nullptr );
+        
+        template <typename Texpand_func, typename Theuristic_func, typename Tweight>
+        void best_first_search( int32_t num_vertices, int32_t source, int32_t target, Texpand_func expand,
+                                Theuristic_func heuristic, shortest_path_scratch<Tweight>& scratch );
+        
+        /********************************************************************************/
+        
+        /**
+         * Reusable buffers and results of shortest path query.
+         */
+        template <typename Tweight>
+        class shortest_path_scratch
+        {
+            /*****************************************************************************
+                                    Inner types and friend types
+            *****************************************************************************/
+            template <typename Tadapter, typename Tweight_func, typename Tw>
+            friend void dijkstra( const Tadapter&, int32_t, Tweight_func,
+                                  shortest_path_scratch<Tw>&, int32_t );
+            
+            template <typename Tadapter, typename Tweight_func, typename Tw>
+            friend void delta_stepping( const Tadapter&, int32_t, Tweight_func, Tw,
+                                        shortest_path_scratch<Tw>&,
+                                        ds::thread_pool::thread_pool* );
+            
+            template <typename Texpand_func, typename Theuristic_func, typename Tw>
+            friend void best_first_search( int32_t, int32_t, int32_t, Texpand_func, Theuristic_func,
+                                           shortest_path_scratch<Tw>& );
+        
+        private:
+            /**
+             * Relaxation found by worker of delta-stepping.
+             */
+            struct relax_request
+            {
+                int32_t vertex;
+                int32_t parent;
+                Tweight dist;
+            };
+            
+            /*****************************************************************************
+                                                Data
+            *****************************************************************************/
+        private:
+            std::vector<Tweight> m_dist;
+            std::vector<int32_t> m_parent;
+            std::vector<int32_t> m_touched;
+            int32_t              m_source = -1;
+            
+            indexed_dary_heap<Tweight> m_heap;
+            
+            // best-first search: distance plus estimate of rest, key of heap
+            std::vector<Tweight> m_estimate;
+            
+            // delta-stepping buffers
+            std::vector<Tweight>                        m_expanded_dist;
+            std::vector< std::vector<int32_t> >         m_buckets;
+            std::vector< std::vector<relax_request> >   m_requests;
+            std::vector<int32_t>                        m_bucket_vertices;
+            std::vector<int32_t>                        m_settled;
+            
+            /*****************************************************************************
+                                Accessible by friend classes interface
+            *****************************************************************************/
+        private:
+            /**
+             * Resets results of previous query.
+             * Heap is emptied here too, as query which threw could leave it not empty.
+             */
+            void prepare( int32_t num_vertices, int32_t source )
+            {
+                m_heap.clear();
+                for ( auto& cur_requests : m_requests )
+                {
+                    cur_requests.clear();
+                }
+                if ( (int32_t)m_dist.size() != num_vertices )
+                {
+                    m_dist.assign( num_vertices, infinity() );
+                    m_parent.assign( num_vertices, -1 );
+                    m_expanded_dist.clear();
+                    m_estimate.clear();
+                } else
+                {
+                    for ( auto v : m_touched )
+                    {
+                        m_dist[v] = infinity();
+                        m_parent[v] = -1;
+                        if ( !m_expanded_dist.empty() )
+                        {
+                            m_expanded_dist[v] = infinity();
+                        }
+                        if ( !m_estimate.empty() )
+                        {
+                            m_estimate[v] = infinity();
+                        }
+                    }
+                }
+                m_touched.clear();
+                m_source = source;
+                return;
+            }
+            
+            /**
+             * Sets distance of vertex if it is shorter.
+             * Returns: true if distance was improved.
+             */
+            bool improve( int32_t v, int32_t parent, Tweight dist )
+            {
+                if ( !( dist < m_dist[v] ) )
+                {
+                    return false;
+                }
+                if ( infinity() == m_dist[v] )
+                {
+                    m_touched.push_back( v );
+                }
+                m_dist[v] = dist;
+                m_parent[v] = parent;
+                return true;
+            }
+            
+            static void check_weight( Tweight weight )
+            {
+                if ( weight < Tweight( 0 ) )
+                {
+                    throw std::invalid_argument( "edge weight is negative" );
+                }
+                return;
+            }
+            
+            /*****************************************************************************
+                                          Public interface
+            *****************************************************************************/
+        public:
+            static constexpr Tweight infinity()
+            {
+                return std::numeric_limits<Tweight>::has_infinity ?
+                       std::numeric_limits<Tweight>::infinity() :
+                       std::numeric_limits<Tweight>::max();
+            }
+            
+            /**
+             * Source of last query.
+             */
+            int32_t source() const
+            {
+                return m_source;
+            }
+            
+            bool reached( int32_t v ) const
+            {
+                return ( v >= 0 && v < (int32_t)m_dist.size() && infinity() != m_dist[v] );
+            }
+            
+            /**
+             * Distance from source, infinity() if vertex is not reached.
+             * Note: after dijkstra with target only distances not greater than
+             *       distance of target are final.
+             */
+            Tweight distance( int32_t v ) const
+            {
+                return m_dist.at( v );
+            }
+            
+            /**
+             * Previous vertex on shortest path, -1 for source and not reached vertices.
+             */
+            int32_t parent( int32_t v ) const
+            {
+                return m_parent.at( v );
+            }
+            
+            /**
+             * Vertices of shortest path from source to target, empty if target is not reached.
+             */
+            std::vector<int32_t> path( int32_t target ) const
+            {
+                std::vector<int32_t> out;
+                if ( !reached( target ) )
+                {
+                    return out;
+                }
+                for ( int32_t v = target; v >= 0; v = m_parent[v] )
+                {
+                    out.push_back( v );
+                }
+                std::reverse( out.begin(), out.end() );
+                return out;
+            }
+        };
+        
+        /********************************************************************************/
+        
+        /**
+         * Dijkstra search from source on d-ary heap.
+         * If target is given (not -1), search stops as soon as target is settled.
+         * Results are in scratch.
+         */
+        template <typename Tadapter, typename Tweight_func, typename Tweight>
+        void dijkstra( const Tadapter& graph, int32_t source, Tweight_func weight,
+                       shortest_path_scratch<Tweight>& scratch, int32_t target )
+        {
+            const int32_t num_vertices = graph.vertex_bound();
+            if ( source < 0 || source >= num_vertices || !graph.is_vertex( source ) )
+            {
+                throw std::out_of_range( "source vertex " + std::to_string( source ) +
+                                         " is not in graph" );
+            }
+            
+            scratch.prepare( num_vertices, source );
+            scratch.m_heap.prepare( num_vertices, scratch.m_dist.data() );
+            
+            scratch.improve( source, -1, Tweight( 0 ) );
+            scratch.m_heap.push_or_decrease( source );
+            
+            while ( !scratch.m_heap.empty() )
+            {
+                const int32_t u = scratch.m_heap.pop();
+                if ( u == target )
+                {
+                    break;
+                }
+                
+                const Tweight dist_u = scratch.m_dist[u];
+                graph.for_each_succ( u, [&]( int32_t w, const auto& edge )
+                                     {
+                                         const Tweight cur_weight = weight( edge );
+                                         shortest_path_scratch<Tweight>::check_weight( cur_weight );
+                                         if ( scratch.improve( w, u, dist_u + cur_weight ) )
+                                         {
+                                             scratch.m_heap.push_or_decrease( w );
+                                         }
+                                         return true;
+                                     } );
+            }
+            
+            scratch.m_heap.clear();
+            return;
+        }
+        
+        /********************************************************************************/
+        
+        /**
+         * Parallel delta-stepping search from source.
+         * Vertices are kept in buckets of width delta. Bucket is processed in phases:
+         * edges lighter than delta are relaxed until bucket stops refilling, then
+         * heavy edges of all vertices settled in bucket are relaxed once.
+         * Edges of bucket are scanned by workers of pool in parallel, found
+         * relaxations are applied by calling thread.
+         * Good delta is about average edge weight; too small delta gives many
+         * buckets, too big gives repeated relaxations.
+         * Results are in scratch.
+         */
+        template <typename Tadapter, typename Tweight_func, typename Tweight>
+        void delta_stepping( const Tadapter& graph, int32_t source, Tweight_func weight,
+                             Tweight delta, shortest_path_scratch<Tweight>& scratch,
+                             ds::thread_pool::thread_pool *pool_p )
+        {
+            const int32_t num_vertices = graph.vertex_bound();
+            if ( source < 0 || source >= num_vertices || !graph.is_vertex( source ) )
+            {
+                throw std::out_of_range( "source vertex " + std::to_string( source ) +
+                                         " is not in graph" );
+            }
+            if ( !( Tweight( 0 ) < delta ) )
+            {
+                throw std::invalid_argument( "delta should be positive" );
+            }
+            
+            using scratch_type = shortest_path_scratch<Tweight>;
+            
+            scratch.prepare( num_vertices, source );
+            if ( (int32_t)scratch.m_expanded_dist.size() != num_vertices )
+            {
+                scratch.m_expanded_dist.assign( num_vertices, scratch_type::infinity() );
+            }
+            scratch.m_requests.resize( ds::thread_pool::workers_count( pool_p ) );
+            for ( auto& cur_bucket : scratch.m_buckets )
+            {
+                cur_bucket.clear();
+            }
+            
+            auto bucket_of = [delta]( Tweight dist ) -> size_t
+            {
+                return (size_t)( dist / delta );
+            };
+            
+            auto relax = [&]( int32_t v, int32_t parent, Tweight dist )
+            {
+                if ( scratch.improve( v, parent, dist ) )
+                {
+                    const size_t bucket = bucket_of( dist );
+                    if ( bucket >= scratch.m_buckets.size() )
+                    {
+                        scratch.m_buckets.resize( bucket + 1 );
+                    }
+                    scratch.m_buckets[bucket].push_back( v );
+                }
+                return;
+            };
+            
+            // scan edges of vertices in parallel, light or heavy ones
+            auto scan = [&]( const std::vector<int32_t>& vertices, bool light )
+            {
+                ds::thread_pool::parallel_for(
+                    pool_p, 0, (int64_t)vertices.size(), 64,
+                    [&]( int64_t begin, int64_t end, size_t worker )
+                    {
+                        auto& out = scratch.m_requests[worker];
+                        for ( int64_t i = begin; i < end; i++ )
+                        {
+                            const int32_t u = vertices[i];
+                            const Tweight dist_u = scratch.m_dist[u];
+                            graph.for_each_succ( u, [&]( int32_t w, const auto& edge )
+                                                 {
+                                                     const Tweight cur_weight = weight( edge );
+                                                     scratch_type::check_weight( cur_weight );
+                                                     if ( ( cur_weight < delta ) == light &&
+                                                          dist_u + cur_weight < scratch.m_dist[w] )
+                                                     {
+                                                         out.push_back( { w, u, dist_u + cur_weight } );
+                                                     }
+                                                     return true;
+                                                 } );
+                        }
+                    } );
+                
+                for ( auto& cur_requests : scratch.m_requests )
+                {
+                    for ( const auto& cur_request : cur_requests )
+                    {
+                        relax( cur_request.vertex, cur_request.parent, cur_request.dist );
+                    }
+                    cur_requests.clear();
+                }
+                return;
+            };
+            
+            relax( source, -1, Tweight( 0 ) );
+            
+            for ( size_t cur = 0; cur < scratch.m_buckets.size(); cur++ )
+            {
+                scratch.m_settled.clear();
+                
+                while ( !scratch.m_buckets[cur].empty() )
+                {
+                    // take vertices which are still in this bucket and were not expanded
+                    // with their current distance
+                    scratch.m_bucket_vertices.clear();
+                    for ( auto v : scratch.m_buckets[cur] )
+                    {
+                        const Tweight dist_v = scratch.m_dist[v];
+                        if ( bucket_of( dist_v ) == cur && dist_v < scratch.m_expanded_dist[v] )
+                        {
+                            scratch.m_expanded_dist[v] = dist_v;
+                            scratch.m_bucket_vertices.push_back( v );
+                            scratch.m_settled.push_back( v );
+                        }
+                    }
+                    scratch.m_buckets[cur].clear();
+                    
+                    scan( scratch.m_bucket_vertices, true );
+                }
+                
+                // vertex could be expanded several times in bucket, heavy edges need it once
+                std::sort( scratch.m_settled.begin(), scratch.m_settled.end() );
+                scratch.m_settled.erase( std::unique( scratch.m_settled.begin(), scratch.m_settled.end() ),
+                                         scratch.m_settled.end() );
+                scan( scratch.m_settled, false );
+            }
+            
+            return;
+        }
+        
+        /********************************************************************************/
+        
+        /**
+         * Best-first search from source to target over implicit successors:
+         * expand( u, relax ) calls relax( w, weight ) for every succ w of u.
+         * Vertices are taken by distance plus heuristic( vertex ), search stops when
+         * target is taken. Vertex whose distance improves after it was taken is
+         * taken again, so search is right for any heuristic not exceeding real distance.
+         * It is engine of astar and of searches which make successors on the fly
+         * (jump point search of grids). Results are in scratch.
+         * Exceptions of expand and heuristic pass through, scratch stays reusable.
+         */
+        template <typename Texpand_func, typename Theuristic_func, typename Tweight>
+        void best_first_search( int32_t num_vertices, int32_t source, int32_t target, Texpand_func expand,
+                                Theuristic_func heuristic, shortest_path_scratch<Tweight>& scratch )
+        {
+            using scratch_type = shortest_path_scratch<Tweight>;
+            
+            scratch.prepare( num_vertices, source );
+            if ( (int32_t)scratch.m_estimate.size() != num_vertices )
+            {
+                scratch.m_estimate.assign( num_vertices, scratch_type::infinity() );
+            }
+            scratch.m_heap.prepare( num_vertices, scratch.m_estimate.data() );
+            
+            scratch.improve( source, -1, Tweight( 0 ) );
+            scratch.m_estimate[source] = heuristic( source );
+            scratch.m_heap.push_or_decrease( source );
+            
+            while ( !scratch.m_heap.empty() )
+            {
+                const int32_t u = scratch.m_heap.pop();
+                if ( u == target )
+                {
+                    break;
+                }
+                
+                const Tweight dist_u = scratch.m_dist[u];
+                expand( u, [&]( int32_t w, Tweight cur_weight )
+                           {
+                               scratch_type::check_weight( cur_weight );
+                               if ( scratch.improve( w, u, dist_u + cur_weight ) )
+                               {
+                                   scratch.m_estimate[w] = scratch.m_dist[w] + heuristic( w );
+                                   scratch.m_heap.push_or_decrease( w );
+                               }
+                           } );
+            }
+            
+            scratch.m_heap.clear();
+            return;
+        }
+        
+        /**
+         * A* search from source to target, heuristic( vertex ) -> Tweight estimates
+         * distance to target. With zero heuristic it is dijkstra with target.
+         * Results are in scratch.
+         */
+        template <typename Tadapter, typename Tweight_func, typename Theuristic_func, typename Tweight>
+        void astar( const Tadapter& graph, int32_t source, int32_t target, Tweight_func weight,
+                    Theuristic_func heuristic, shortest_path_scratch<Tweight>& scratch )
+        {
+            const int32_t num_vertices = graph.vertex_bound();
+            if ( source < 0 || source >= num_vertices || !graph.is_vertex( source ) )
+            {
+                throw std::out_of_range( "source vertex " + std::to_string( source ) +
+                                         " is not in graph" );
+            }
+            if ( target < 0 || target >= num_vertices || !graph.is_vertex( target ) )
+            {
+                throw std::out_of_range( "target vertex " + std::to_string( target ) +
+                                         " is not in graph" );
+            }
+            
+            best_first_search( num_vertices, source, target,
+                               [&]( int32_t u, auto&& relax )
+                               {
+                                   graph.for_each_succ( u, [&]( int32_t w, const auto& edge )
+                                                        {
+                                                            relax( w, (Tweight)weight( edge ) );
+                                                            return true;
+                                                        } );
+                               },
+                               heuristic, scratch );
+            return;
+        }
+        
+        /********************************************************************************/
+    }
+}
+
+/****************************************************************************************/
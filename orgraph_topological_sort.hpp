@@ -0,0 +1,472 @@
+/**
+ * Topological order of oriented graph.
+ */
+#pragma once
+
+/****************************************************************************************/
+
+/**
+ * topological_sort( graph ) works through graph adapter (see orgraph_traversal.hpp)
+ * and sorts whole graph once in O(V+E).
+ *
+ * incremental_topological_order keeps order of orgraph up to date while edges are
+ * added and removed. It is subscribed to graph as listener, so edges added directly
+ * by graph work too. Adding edge reorders only vertices between its ends
+ * (dynamic order by Pearce and Kelly), so DAG is not re-sorted after every update.
+ * Edges closing a cycle are either rejected by try_add_edge or, if added directly
+ * to graph, reported by cycle_edges() and left out of order until cycle is broken.
+ *
+ * Usage:
+ *      ds::orgraph::incremental_topological_order<Tnode,Tedge> topo( graph );
+ *      if ( !topo.try_add_edge( data, from, to ) )
+ *      {
+ *          ... edge would make a cycle ...
+ *      }
+ *      for ( auto cur_node_ref : topo.order() )
+ *      {
+ *          ...
+ *      }
+ */
+
+/****************************************************************************************/
+
+#include <vector>
+#include <optional>
+#include <algorithm>
+#include <utility>
+
+#include <stdint.h>
+
+#include "orgraph_traversal.hpp"
+
+/****************************************************************************************/
+
+namespace ds
+{
+    namespace orgraph
+    {
+        /********************************************************************************/
+        
+        /**
+         * Sorts vertices of graph so every edge goes from earlier vertex to later one.
+         * Returns: vertices in topological order or nullopt if graph has a cycle.
+         */
+        template <typename Tgraph>
+        std::optional< std::vector<int32_t> > topological_sort( const Tgraph& graph )
+        {
+            const int32_t num_vertices = graph.vertex_bound();
+            
+            // Kahn's algorithm: vertex is taken when all its preds are taken
+            std::vector<int32_t> in_degree( num_vertices, 0 );
+            std::vector<int32_t> order;
+            order.reserve( num_vertices );
+            for ( int32_t v = 0; v < num_vertices; v++ )
+            {
+                if ( !graph.is_vertex( v ) )
+                {
+                    continue;
+                }
+                graph.for_each_pred( v, [&]( int32_t, const auto& )
+                                     {
+                                         in_degree[v]++;
+                                         return true;
+                                     } );
+                if ( 0 == in_degree[v] )
+                {
+                    order.push_back( v );
+                }
+            }
+            
+            int32_t num_alive = 0;
+            for ( int32_t v = 0; v < num_vertices; v++ )
+            {
+                num_alive += graph.is_vertex( v ) ? 1 : 0;
+            }
+            
+            for ( size_t i = 0; i < order.size(); i++ )
+            {
+                graph.for_each_succ( order[i], [&]( int32_t w, const auto& )
+                                     {
+                                         in_degree[w]--;
+                                         if ( 0 == in_degree[w] )
+                                         {
+                                             order.push_back( w );
+                                         }
+                                         return true;
+                                     } );
+            }
+            
+            if ( (int32_t)order.size() != num_alive )
+            {
+                return std::nullopt;
+            }
+            return order;
+        }
+        
+        /********************************************************************************/
+        
+        /**
+         * Topological order of orgraph maintained incrementally.
+         * Every alive vertex has label, labels grow along every accepted edge.
+         * Edge x->y with label of y less than label of x is accepted by reordering:
+         * vertices reachable from y with labels up to label of x and vertices
+         * reaching x with labels from label of y get the same labels reassigned,
+         * ones reaching x first. If y reaches x edge closes a cycle.
+         *
+         * Object should not outlive graph, it unsubscribes itself in destructor.
+         */
+        template <typename Tnode, typename Tedge, typename Tstorage = map_storage>
+        class incremental_topological_order : public orgraph_listener<Tnode,Tedge,Tstorage>
+        {
+        public:
+            using graph_type = orgraph<Tnode,Tedge,Tstorage>;
+            using node_type  = node_ref<Tnode,Tedge,Tstorage>;
+            using edge_type  = edge_ref<Tnode,Tedge,Tstorage>;
+            
+            /*****************************************************************************
+                                                Data
+            *****************************************************************************/
+        private:
+            graph_type                &m_graph;
+            graph_adapter<graph_type>  m_adapter;
+            
+            // labels of vertices, -1 for holes
+            std::vector<int64_t> m_label;
+            int64_t              m_next_label = 0;
+            
+            // accepted edges, parallel edges are repeated
+            std::vector< std::vector<int32_t> > m_succs;
+            std::vector< std::vector<int32_t> > m_preds;
+            
+            // edges of graph closing a cycle, they are not in order
+            std::vector<edge_type> m_cycle_edges;
+            
+            // buffers of reordering
+            std::vector<uint8_t> m_mark;
+            std::vector<int32_t> m_stack;
+            std::vector<int32_t> m_forward;
+            std::vector<int32_t> m_backward;
+            std::vector<int64_t> m_labels_pool;
+            
+            /*****************************************************************************
+                                             Inner methods
+            *****************************************************************************/
+        private:
+            void grow( int32_t bound )
+            {
+                if ( (int32_t)m_label.size() < bound )
+                {
+                    m_label.resize( bound, -1 );
+                    m_succs.resize( bound );
+                    m_preds.resize( bound );
+                    m_mark.resize( bound, 0 );
+                }
+                return;
+            }
+            
+            /**
+             * Collects into out vertices reachable from start through links, which
+             * labels satisfy is_inside. Returns false if stop vertex is reached.
+             */
+            template <typename Tfunc>
+            bool collect( int32_t start, int32_t stop,
+                          const std::vector< std::vector<int32_t> >& links,
+                          Tfunc is_inside, std::vector<int32_t>& out )
+            {
+                m_stack.clear();
+                m_stack.push_back( start );
+                m_mark[start] = 1;
+                out.push_back( start );
+                while ( !m_stack.empty() )
+                {
+                    const int32_t v = m_stack.back();
+                    m_stack.pop_back();
+                    for ( auto w : links[v] )
+                    {
+                        if ( w == stop )
+                        {
+                            return false;
+                        }
+                        if ( m_mark[w] || !is_inside( m_label[w] ) )
+                        {
+                            continue;
+                        }
+                        m_mark[w] = 1;
+                        out.push_back( w );
+                        m_stack.push_back( w );
+                    }
+                }
+                return true;
+            }
+            
+            void clear_marks()
+            {
+                for ( auto v : m_forward )
+                {
+                    m_mark[v] = 0;
+                }
+                for ( auto v : m_backward )
+                {
+                    m_mark[v] = 0;
+                }
+                m_forward.clear();
+                m_backward.clear();
+                return;
+            }
+            
+            /**
+             * Makes label of x less than label of y.
+             * Returns: false if y reaches x, order is not changed then.
+             */
+            bool reorder( int32_t x, int32_t y )
+            {
+                if ( x == y )
+                {
+                    return false;
+                }
+                const int64_t upper = m_label[x];
+                const int64_t lower = m_label[y];
+                if ( lower > upper )
+                {
+                    return true;
+                }
+                
+                const bool acyclic = collect( y, x, m_succs,
+                                              [upper]( int64_t label ) { return ( label < upper ); },
+                                              m_forward );
+                if ( !acyclic )
+                {
+                    clear_marks();
+                    return false;
+                }
+                collect( x, y, m_preds,
+                         [lower]( int64_t label ) { return ( label > lower ); },
+                         m_backward );
+                
+                auto by_label = [this]( int32_t a, int32_t b )
+                                {
+                                    return ( m_label[a] < m_label[b] );
+                                };
+                std::sort( m_forward.begin(), m_forward.end(), by_label );
+                std::sort( m_backward.begin(), m_backward.end(), by_label );
+                
+                m_labels_pool.clear();
+                for ( auto v : m_backward )
+                {
+                    m_labels_pool.push_back( m_label[v] );
+                }
+                for ( auto v : m_forward )
+                {
+                    m_labels_pool.push_back( m_label[v] );
+                }
+                std::sort( m_labels_pool.begin(), m_labels_pool.end() );
+                
+                size_t next = 0;
+                for ( auto v : m_backward )
+                {
+                    m_label[v] = m_labels_pool[next++];
+                }
+                for ( auto v : m_forward )
+                {
+                    m_label[v] = m_labels_pool[next++];
+                }
+                
+                clear_marks();
+                return true;
+            }
+            
+            /**
+             * Adds edge to order or to cycle edges.
+             */
+            void insert( const edge_type& ref )
+            {
+                const int32_t x = m_adapter.vertex( ref.pred() );
+                const int32_t y = m_adapter.vertex( ref.succ() );
+                if ( !reorder( x, y ) )
+                {
+                    m_cycle_edges.push_back( ref );
+                    return;
+                }
+                m_succs[x].push_back( y );
+                m_preds[y].push_back( x );
+                return;
+            }
+            
+            static void erase_one( std::vector<int32_t>& links, int32_t v )
+            {
+                auto it = std::find( links.begin(), links.end(), v );
+                if ( it != links.end() )
+                {
+                    *it = links.back();
+                    links.pop_back();
+                }
+                return;
+            }
+            
+            /*****************************************************************************
+                                          Public interface
+            *****************************************************************************/
+        public:
+            /**
+             * Orders current graph and subscribes to its changes.
+             * Edges of current graph closing cycles go to cycle_edges().
+             */
+            explicit incremental_topological_order( graph_type& graph )
+                : m_graph( graph ), m_adapter( graph )
+            {
+                grow( m_adapter.vertex_bound() );
+                for ( int32_t v = 0; v < m_adapter.vertex_bound(); v++ )
+                {
+                    if ( m_adapter.is_vertex( v ) )
+                    {
+                        m_label[v] = m_next_label++;
+                    }
+                }
+                for ( const auto& cur_edge_ref : m_graph.edges() )
+                {
+                    insert( cur_edge_ref );
+                }
+                m_graph.subscribe( this );
+            }
+            
+            incremental_topological_order( const incremental_topological_order& ) = delete;
+            incremental_topological_order& operator=( const incremental_topological_order& ) = delete;
+            
+            ~incremental_topological_order() override
+            {
+                m_graph.unsubscribe( this );
+            }
+            
+            /**
+             * Adds edge to graph if it doesn't close a cycle.
+             * Returns: added edge or nullopt when edge is rejected.
+             */
+            std::optional<edge_type> try_add_edge( const Tedge& edge_data,
+                                                   const node_type& start,
+                                                   const node_type& end )
+            {
+                // reordering alone keeps order valid, so edge added below is accepted at once
+                if ( !reorder( m_adapter.vertex( start ), m_adapter.vertex( end ) ) )
+                {
+                    return std::nullopt;
+                }
+                return m_graph.add_edge( edge_data, start, end );
+            }
+            
+            /**
+             * Checks if edge from start to end would close a cycle.
+             */
+            bool would_close_cycle( const node_type& start, const node_type& end )
+            {
+                // reordering only, edge is not added
+                return !reorder( m_adapter.vertex( start ), m_adapter.vertex( end ) );
+            }
+            
+            /**
+             * Returns: true if start goes before end in current order.
+             * It doesn't mean that end is reachable from start.
+             */
+            bool precedes( const node_type& start, const node_type& end ) const
+            {
+                return ( m_label[ m_adapter.vertex( start ) ] < m_label[ m_adapter.vertex( end ) ] );
+            }
+            
+            /**
+             * Nodes of graph in topological order of edges not closing cycles.
+             */
+            std::vector<node_type> order() const
+            {
+                std::vector<int32_t> vertices;
+                for ( int32_t v = 0; v < (int32_t)m_label.size(); v++ )
+                {
+                    if ( m_label[v] >= 0 )
+                    {
+                        vertices.push_back( v );
+                    }
+                }
+                std::sort( vertices.begin(), vertices.end(),
+                           [this]( int32_t a, int32_t b )
+                           {
+                               return ( m_label[a] < m_label[b] );
+                           } );
+                
+                std::vector<node_type> out;
+                out.reserve( vertices.size() );
+                for ( auto v : vertices )
+                {
+                    out.push_back( m_adapter.node( v ) );
+                }
+                return out;
+            }
+            
+            /**
+             * Edges of graph closing cycles, empty if graph is DAG.
+             */
+            const std::vector<edge_type>& cycle_edges() const
+            {
+                return m_cycle_edges;
+            }
+            
+            bool is_acyclic() const
+            {
+                return m_cycle_edges.empty();
+            }
+            
+            /*****************************************************************************
+                                             Listener
+            *****************************************************************************/
+        public:
+            void on_add_node( const node_type& ref ) override
+            {
+                const int32_t v = m_adapter.vertex( ref );
+                grow( v + 1 );
+                m_label[v] = m_next_label++;
+                return;
+            }
+            
+            void on_add_edge( const edge_type& ref ) override
+            {
+                insert( ref );
+                return;
+            }
+            
+            void on_remove_node( const node_type& ref ) override
+            {
+                // edges of node are already removed
+                const int32_t v = m_adapter.vertex( ref );
+                m_label[v] = -1;
+                m_succs[v].clear();
+                m_preds[v].clear();
+                return;
+            }
+            
+            void on_remove_edge( const edge_type& ref ) override
+            {
+                auto it = std::find( m_cycle_edges.begin(), m_cycle_edges.end(), ref );
+                if ( it != m_cycle_edges.end() )
+                {
+                    m_cycle_edges.erase( it );
+                    return;
+                }
+                
+                const int32_t x = m_adapter.vertex( ref.pred() );
+                const int32_t y = m_adapter.vertex( ref.succ() );
+                erase_one( m_succs[x], y );
+                erase_one( m_preds[y], x );
+                
+                // removed edge may break cycles, so edges closing them are checked again
+                std::vector<edge_type> cycle_edges;
+                cycle_edges.swap( m_cycle_edges );
+                for ( const auto& cur_edge_ref : cycle_edges )
+                {
+                    insert( cur_edge_ref );
+                }
+                return;
+            }
+        };
+        
+        /********************************************************************************/
+    }
+}
+
+/****************************************************************************************/
@@ -0,0 +1,450 @@
+/**
+ * Traversal of oriented graph.
+ */
+#pragma once
+
+/****************************************************************************************/
+
+/**
+ * Algorithms don't work with graphs directly but through adapters giving
+ * dense int32_t vertices and adjacency callbacks. Adapter interface:
+ *
+ *      using edge_data = ...;                  - what is passed as edge to callbacks;
+ *      int32_t vertex_bound() const            - all vertices are in [0, vertex_bound());
+ *      bool    is_vertex( v ) const            - some indices below bound can be holes;
+ *      int64_t edge_count() const;
+ *      int32_t out_degree( v ) const;
+ *      for_each_succ( v, f ) const             - calls f( succ vertex, edge_data ) for
+ *                                                every succ edge of v while f returns true;
+ *      for_each_pred( v, f ) const             - same for pred edges, f gets pred vertex.
+ *
+ * There are adapters of orgraph (vertex is node id index) and of csr_view
+ * (vertex is node index of snapshot), adapt( graph ) makes them.
+ * Adapters of csr_view are much faster as adjacency lies in flat arrays.
+ *
+ * Adapter keeps pointer to graph, graph should not be changed while adapter is used.
+ */
+
+/****************************************************************************************/
+
+#include <vector>
+#include <string>
+#include <stdexcept>
+#include <atomic>
+#include <utility>
+#include <algorithm>
+
+#include <stdint.h>
+
+#include "orgraph.hpp"
+#include "orgraph_csr.hpp"
+#include "thread_pool.hpp"
+
+#ifdef DEBUG_DS_ORGRAPH
+#include <assert.h>
+#endif /* DEBUG_DS_ORGRAPH */
+
+/****************************************************************************************/
+
+namespace ds
+{
+    namespace orgraph
+    {
+        /********************************************************************************/
+        
+        /**
+         * Adapter of mutable orgraph.
+         * Vertex is index of node id. For map storage every access is O(log n).
+         */
+        template <typename Tnode, typename Tedge, typename Tstorage>
+        class graph_adapter< orgraph<Tnode,Tedge,Tstorage> >
+        {
+        public:
+            using graph_type = orgraph<Tnode,Tedge,Tstorage>;
+            using edge_data  = Tedge;
+        
+        private:
+            graph_type *m_graph_p;
+        
+        public:
+            explicit graph_adapter( graph_type& graph ) : m_graph_p( &graph ) {}
+            
+            int32_t vertex_bound() const
+            {
+                return m_graph_p->m_nodes.id_bound();
+            }
+            
+            bool is_vertex( int32_t v ) const
+            {
+                return ( nullptr != m_graph_p->m_nodes.find_by_index( v ) );
+            }
+            
+            int64_t edge_count() const
+            {
+                return (int64_t)m_graph_p->m_edges.size();
+            }
+            
+            int32_t out_degree( int32_t v ) const
+            {
+                return (int32_t)m_graph_p->m_nodes.find_by_index( v )->succs().size();
+            }
+            
+            template <typename Tfunc>
+            void for_each_succ( int32_t v, Tfunc f ) const
+            {
+                for ( const auto& cur_edge_id : m_graph_p->m_nodes.find_by_index( v )->succs() )
+                {
+                    const auto& cur_edge = m_graph_p->m_edges.at( cur_edge_id );
+                    if ( !f( cur_edge.succ()(), cur_edge.data() ) )
+                    {
+                        return;
+                    }
+                }
+                return;
+            }
+            
+            template <typename Tfunc>
+            void for_each_pred( int32_t v, Tfunc f ) const
+            {
+                for ( const auto& cur_edge_id : m_graph_p->m_nodes.find_by_index( v )->preds() )
+                {
+                    const auto& cur_edge = m_graph_p->m_edges.at( cur_edge_id );
+                    if ( !f( cur_edge.pred()(), cur_edge.data() ) )
+                    {
+                        return;
+                    }
+                }
+                return;
+            }
+            
+            /**
+             * Conversions between refs and vertices.
+             */
+            int32_t vertex( const node_ref<Tnode,Tedge,Tstorage>& ref ) const
+            {
+                return ref.id()();
+            }
+            
+            node_ref<Tnode,Tedge,Tstorage> node( int32_t v ) const
+            {
+                return m_graph_p->m_nodes.find_by_index( v )->make_ref();
+            }
+        };
+        
+        /********************************************************************************/
+        
+        /**
+         * Adapter of frozen CSR snapshot.
+         * Vertex is node index of snapshot.
+         */
+        template <typename Tnode, typename Tedge>
+        class graph_adapter< csr_view<Tnode,Tedge> >
+        {
+        public:
+            using graph_type = csr_view<Tnode,Tedge>;
+            using edge_data  = Tedge;
+        
+        private:
+            const graph_type *m_view_p;
+        
+        public:
+            explicit graph_adapter( const graph_type& view ) : m_view_p( &view ) {}
+            
+            int32_t vertex_bound() const
+            {
+                return m_view_p->node_count();
+            }
+            
+            bool is_vertex( int32_t v ) const
+            {
+                return ( v >= 0 && v < m_view_p->node_count() );
+            }
+            
+            int64_t edge_count() const
+            {
+                return m_view_p->edge_count();
+            }
+            
+            int32_t out_degree( int32_t v ) const
+            {
+                return m_view_p->succ_end( v ) - m_view_p->succ_begin( v );
+            }
+            
+            template <typename Tfunc>
+            void for_each_succ( int32_t v, Tfunc f ) const
+            {
+                const int32_t e_end = m_view_p->succ_end( v );
+                for ( int32_t e = m_view_p->succ_begin( v ); e < e_end; e++ )
+                {
+                    if ( !f( m_view_p->succ_target( e ), m_view_p->edge_data( e ) ) )
+                    {
+                        return;
+                    }
+                }
+                return;
+            }
+            
+            template <typename Tfunc>
+            void for_each_pred( int32_t v, Tfunc f ) const
+            {
+                const int32_t pos_end = m_view_p->pred_end( v );
+                for ( int32_t pos = m_view_p->pred_begin( v ); pos < pos_end; pos++ )
+                {
+                    if ( !f( m_view_p->pred_source( pos ),
+                             m_view_p->edge_data( m_view_p->pred_edge( pos ) ) ) )
+                    {
+                        return;
+                    }
+                }
+                return;
+            }
+            
+            /**
+             * Conversions between refs and vertices.
+             */
+            int32_t vertex( const csr_node_ref<Tnode,Tedge>& ref ) const
+            {
+                return ref.index();
+            }
+            
+            csr_node_ref<Tnode,Tedge> node( int32_t v ) const
+            {
+                return m_view_p->node( v );
+            }
+        };
+        
+        /********************************************************************************/
+        
+        /**
+         * Makes adapter of graph for algorithms.
+         */
+        template <typename Tnode, typename Tedge, typename Tstorage>
+        graph_adapter< orgraph<Tnode,Tedge,Tstorage> > adapt( orgraph<Tnode,Tedge,Tstorage>& graph )
+        {
+            return graph_adapter< orgraph<Tnode,Tedge,Tstorage> >( graph );
+        }
+        
+        template <typename Tnode, typename Tedge>
+        graph_adapter< csr_view<Tnode,Tedge> > adapt( const csr_view<Tnode,Tedge>& view )
+        {
+            return graph_adapter< csr_view<Tnode,Tedge> >( view );
+        }
+        
+        /********************************************************************************/
+        
+        /**
+         * Set of vertices as bitmap.
+         * set() is atomic, so many threads can mark vertices at once.
+         */
+        class vertex_bitmap
+        {
+        private:
+            std::vector< std::atomic<uint64_t> > m_words;
+        
+        public:
+            explicit vertex_bitmap( int32_t num_vertices = 0 ) :
+                m_words( ( (size_t)num_vertices + 63 ) / 64 )
+            {}
+            
+            bool test( int32_t v ) const
+            {
+                return ( m_words[v >> 6].load( std::memory_order_relaxed ) >> ( v & 63 ) ) & 1;
+            }
+            
+            /**
+             * Marks vertex.
+             * Returns: true if vertex was not marked before.
+             */
+            bool set( int32_t v )
+            {
+                const uint64_t bit = (uint64_t)1 << ( v & 63 );
+                return !( m_words[v >> 6].fetch_or( bit, std::memory_order_relaxed ) & bit );
+            }
+            
+            void clear()
+            {
+                for ( auto& cur_word : m_words )
+                {
+                    cur_word.store( 0, std::memory_order_relaxed );
+                }
+                return;
+            }
+        };
+        
+        /********************************************************************************/
+        
+        /**
+         * Options of breadth-first search.
+         */
+        struct bfs_options
+        {
+            // pool to run levels on, nullptr means calling thread only
+            ds::thread_pool::thread_pool *pool_p = nullptr;
+            
+            // switch between top-down and bottom-up steps by frontier size
+            bool direction_optimizing = true;
+            
+            // top-down -> bottom-up when edges of frontier > unexplored edges / alpha,
+            // bottom-up -> top-down when vertices of frontier < vertices / beta
+            int64_t alpha = 14;
+            int64_t beta  = 24;
+            
+            // vertices per chunk of parallel work
+            int64_t grain = 256;
+        };
+        
+        /********************************************************************************/
+        
+        /**
+         * Level-synchronous breadth-first search from source vertex.
+         * Every reached vertex is passed once to visitor( vertex, parent, level ),
+         * source has parent -1 and level 0. Visitor is called only on calling thread,
+         * level by level; inside level order of vertices is not specified if
+         * pool is used.
+         * Levels are expanded either top-down (from frontier by succ edges) or
+         * bottom-up (unvisited vertices look for pred in frontier), whichever
+         * is cheaper for current frontier.
+         */
+        template <typename Tadapter, typename Tvisitor>
+        void bfs( const Tadapter& graph, int32_t source, Tvisitor visitor,
+                  const bfs_options& options = bfs_options() )
+        {
+            const int32_t num_vertices = graph.vertex_bound();
+            if ( source < 0 || source >= num_vertices || !graph.is_vertex( source ) )
+            {
+                throw std::out_of_range( "source vertex " + std::to_string( source ) +
+                                         " is not in graph" );
+            }
+            
+            ds::thread_pool::thread_pool *pool_p = options.pool_p;
+            const size_t num_workers = ds::thread_pool::workers_count( pool_p );
+            
+            vertex_bitmap visited( num_vertices );
+            vertex_bitmap in_frontier( options.direction_optimizing ? num_vertices : 0 );
+            
+            // ( vertex, parent ) pairs of current frontier and of next one found by workers
+            std::vector< std::pair<int32_t,int32_t> > frontier;
+            std::vector< std::vector< std::pair<int32_t,int32_t> > > found( num_workers );
+            
+            visited.set( source );
+            frontier.emplace_back( source, -1 );
+            visitor( source, -1, 0 );
+            
+            int64_t frontier_edges   = graph.out_degree( source );
+            int64_t unexplored_edges = graph.edge_count() - frontier_edges;
+            bool    bottom_up        = false;
+            
+            // bottom-up chunks are multiples of 64 vertices, so they don't share bitmap words
+            const int64_t bottom_up_grain = std::max<int64_t>( 64, ( options.grain + 63 ) / 64 * 64 );
+            
+            for ( int32_t level = 1; !frontier.empty(); level++ )
+            {
+                if ( options.direction_optimizing )
+                {
+                    if ( !bottom_up && frontier_edges > unexplored_edges / options.alpha )
+                    {
+                        bottom_up = true;
+                    } else if ( bottom_up &&
+                                (int64_t)frontier.size() < num_vertices / options.beta )
+                    {
+                        bottom_up = false;
+                    }
+                }
+                
+                if ( !bottom_up )
+                {
+                    ds::thread_pool::parallel_for(
+                        pool_p, 0, (int64_t)frontier.size(), options.grain,
+                        [&]( int64_t begin, int64_t end, size_t worker )
+                        {
+                            auto& out = found[worker];
+                            for ( int64_t i = begin; i < end; i++ )
+                            {
+                                const int32_t u = frontier[i].first;
+                                graph.for_each_succ( u, [&]( int32_t w, const auto& )
+                                                     {
+                                                         if ( !visited.test( w ) && visited.set( w ) )
+                                                         {
+                                                             out.emplace_back( w, u );
+                                                         }
+                                                         return true;
+                                                     } );
+                            }
+                        } );
+                } else
+                {
+                    in_frontier.clear();
+                    for ( const auto& [v, parent] : frontier )
+                    {
+                        in_frontier.set( v );
+                    }
+                    
+                    ds::thread_pool::parallel_for(
+                        pool_p, 0, num_vertices, bottom_up_grain,
+                        [&]( int64_t begin, int64_t end, size_t worker )
+                        {
+                            auto& out = found[worker];
+                            for ( int32_t v = (int32_t)begin; v < (int32_t)end; v++ )
+                            {
+                                if ( visited.test( v ) || !graph.is_vertex( v ) )
+                                {
+                                    continue;
+                                }
+                                graph.for_each_pred( v, [&]( int32_t u, const auto& )
+                                                     {
+                                                         if ( in_frontier.test( u ) )
+                                                         {
+                                                             visited.set( v );
+                                                             out.emplace_back( v, u );
+                                                             return false;
+                                                         }
+                                                         return true;
+                                                     } );
+                            }
+                        } );
+                }
+                
+                frontier.clear();
+                for ( auto& cur_found : found )
+                {
+                    frontier.insert( frontier.end(), cur_found.begin(), cur_found.end() );
+                    cur_found.clear();
+                }
+                
+                frontier_edges = 0;
+                for ( const auto& [v, parent] : frontier )
+                {
+                    visitor( v, parent, level );
+                    frontier_edges += graph.out_degree( v );
+                }
+                unexplored_edges -= frontier_edges;
+            }
+            
+            return;
+        }
+        
+        /********************************************************************************/
+        
+        /**
+         * Breadth-first search giving level of every vertex.
+         * Returns: vector of vertex_bound() levels, -1 for not reached vertices.
+         */
+        template <typename Tadapter>
+        std::vector<int32_t> bfs_levels( const Tadapter& graph, int32_t source,
+                                         const bfs_options& options = bfs_options() )
+        {
+            std::vector<int32_t> levels( graph.vertex_bound(), -1 );
+            bfs( graph, source,
+                 [&]( int32_t v, int32_t, int32_t level )
+                 {
+                     levels[v] = level;
+                 },
+                 options );
+            return levels;
+        }
+        
+        /********************************************************************************/
+    }
+}
+
+/****************************************************************************************/
@@ -1,5 +1,11 @@
 #include <string>
+#include <vector>
+#include <tuple>
 #include <stdexcept>
+#include <memory_resource>
+#include <unordered_set>
+#include <algorithm>
+#include <type_traits>
 
 #include <stdio.h>
 
@@ -88,5 +94,225 @@ int main( void )
     printf( "Num printed: %d\n\n", num_printed );
     // Num printed: 0
     
+    num_printed = 0;
+    for ( auto e : start.succ_edges_range() )
+    {
+        printf( "Succ of start: edge %d to node %d\n", *e, *e.succ() );
+        num_printed++;
+    }
+    for ( auto n : n3.pred_nodes_range() )
+    {
+        printf( "Pred of n3: node %d\n", *n );
+        num_printed++;
+    }
+    printf( "Num printed: %d\n\n", num_printed );
+    // Succ of start: edge 20 to node 3
+    // Pred of n3: node 1
+    // Num printed: 2
+    
+    og.enable_node_index();
+    ds::orgraph::node_ref<int,int> n5 = og.add_node( 3 );
+    printf( "Nodes with data 3: %d\n", (int)og.find_nodes( 3 ).size() );
+    *n5 = 5;
+    printf( "Nodes with data 3: %d\n", (int)og.find_nodes( 3 ).size() );
+    printf( "Node with data 5 is found: %d\n", (int)og.find_node( 5 ).has_value() );
+    og.remove_node( n5 );
+    printf( "Node with data 5 is found: %d\n\n", (int)og.find_node( 5 ).has_value() );
+    // Nodes with data 3: 2
+    // Nodes with data 3: 1
+    // Node with data 5 is found: 1
+    // Node with data 5 is found: 0
+    
+    ds::orgraph::orgraph<int,int> bg;
+    bg.reserve( 3, 3 );
+    
+    std::vector<int> bulk_nodes = { 1, 2, 3 };
+    std::vector< ds::orgraph::node_ref<int,int> > bn = bg.add_nodes( bulk_nodes );
+    
+    std::vector< std::tuple< int, ds::orgraph::node_ref<int,int>, ds::orgraph::node_ref<int,int> > >
+        bulk_edges = { { 31, bn[2], bn[0] }, { 12, bn[0], bn[1] }, { 13, bn[0], bn[2] } };
+    bg.add_edges( bulk_edges );
+    
+    num_printed = 0;
+    for ( auto e : bn[0].succ_edges_range() )
+    {
+        printf( "Succ of bulk node 1: edge %d\n", *e );
+        num_printed++;
+    }
+    for ( auto e : bn[0].pred_edges_range() )
+    {
+        printf( "Pred of bulk node 1: edge %d\n", *e );
+        num_printed++;
+    }
+    printf( "Num printed: %d\n\n", num_printed );
+    // Succ of bulk node 1: edge 12
+    // Succ of bulk node 1: edge 13
+    // Pred of bulk node 1: edge 31
+    // Num printed: 3
+    
+    ds::orgraph::orgraph<std::string,std::string> strg;
+    ds::orgraph::node_ref<std::string,std::string> sa = strg.emplace_node( 3, 'a' );
+    std::string heavy = "bbb";
+    ds::orgraph::node_ref<std::string,std::string> sb = strg.add_node( std::move( heavy ) );
+    strg.emplace_edge( sa, sb, "a->b" );
+    for ( auto e : sa.succ_edges_range() )
+    {
+        printf( "Succ of %s: edge %s to node %s\n\n",
+                ( *sa ).c_str(), ( *e ).c_str(), ( *e.succ() ).c_str() );
+    }
+    // Succ of aaa: edge a->b to node bbb
+    
+    ds::orgraph::orgraph<int,int,ds::orgraph::slot_map_storage> sg;
+    
+    ds::orgraph::node_ref<int,int,ds::orgraph::slot_map_storage> s1 = sg.add_node( 1 );
+    ds::orgraph::node_ref<int,int,ds::orgraph::slot_map_storage> s2 = sg.add_node( 2 );
+    sg.add_edge( 12, s1, s2 );
+    sg.remove_node( s2 );
+    
+    // slot of removed node is reused, old ref is detected as stale
+    ds::orgraph::node_ref<int,int,ds::orgraph::slot_map_storage> s3 = sg.add_node( 3 );
+    sg.add_edge( 13, s1, s3 );
+    try
+    {
+        printf( "Stale node: %d\n", *s2 );
+    } catch ( const std::out_of_range& oor )
+    {
+        printf( "Stale node: %s\n", oor.what() );
+    }
+    // Stale node: id 1:0 is not in slot map
+    
+    num_printed = 0;
+    for ( auto& n : s1.succ_nodes() )
+    {
+        printf( "Succ of s1: node %d\n", *n );
+        num_printed++;
+    }
+    printf( "Num printed: %d\n\n", num_printed );
+    // Succ of s1: node 3
+    // Num printed: 1
+    
+    // payloads copied from the same graph survive reallocation of slots
+    ds::orgraph::orgraph<std::string,std::string,ds::orgraph::slot_map_storage> cg;
+    auto long_node = cg.add_node( std::string( 100, 'n' ) );
+    auto long_edge = cg.add_edge( std::string( 100, 'e' ), long_node, long_node );
+    int num_whole = 0;
+    for ( int i = 0; i < 20; i++ )
+    {
+        auto node_copy = cg.add_node( *long_node );
+        auto edge_copy = cg.add_edge( *long_edge, long_node, node_copy );
+        num_whole += (int)( ( *node_copy ).size() == 100 ) + (int)( ( *edge_copy ).size() == 100 );
+    }
+    printf( "Whole copies: %d of 40\n\n", num_whole );
+    // Whole copies: 40 of 40
+    
+    // hub has more edges than are kept inline in node
+    ds::orgraph::orgraph<int,int> hg;
+    std::vector< ds::orgraph::node_ref<int,int> > hn;
+    hn.push_back( hg.add_node( 0 ) );
+    std::vector< ds::orgraph::edge_ref<int,int> > he;
+    for ( int i = 1; i <= 10; i++ )
+    {
+        hn.push_back( hg.add_node( i ) );
+        he.push_back( hg.add_edge( i, hn[0], hn[i] ) );
+    }
+    for ( int i = 0; i < 10; i += 2 )
+    {
+        hg.remove_edge( he[i] );
+    }
+    hg.remove_node( hn[8] );
+    printf( "Succs of hub:" );
+    for ( auto n : hn[0].succ_nodes_range() )
+    {
+        printf( " %d", *n );
+    }
+    printf( "\n\n" );
+    // Succs of hub: 2 4 6 10
+    
+    // handles are plain values
+    static_assert( std::is_trivially_copyable<ds::orgraph::node_id>::value &&
+                   sizeof( ds::orgraph::node_id ) == 8, "node handle is 8-byte value" );
+    static_assert( !std::is_convertible<int32_t,ds::orgraph::node_id>::value &&
+                   !std::is_convertible<int32_t,ds::orgraph::edge_id>::value, "index is not taken as handle" );
+    std::vector< ds::orgraph::node_ref<int,int> > sorted_refs = { hn[3], hn[1], hn[2] };
+    std::sort( sorted_refs.begin(), sorted_refs.end() );
+    sorted_refs[0] = hn[9];
+    std::unordered_set<ds::orgraph::node_id> handles;
+    for ( const auto& cur_ref : sorted_refs )
+    {
+        handles.insert( cur_ref.id() );
+    }
+    printf( "Handles %d, contains 2: %d, contains 8: %d, data of ref: %d\n\n",
+            (int)handles.size(), (int)handles.count( hn[2].id() ), (int)hg.contains( hn[8].id() ),
+            *hg.ref( sorted_refs[2].id() ) );
+    // Handles 3, contains 2: 1, contains 8: 0, data of ref: 3
+    
+    // whole graph lives in buffer, upstream resource fails on any allocation
+    static char arena_buffer[64 * 1024];
+    std::pmr::monotonic_buffer_resource arena( arena_buffer, sizeof( arena_buffer ),
+                                               std::pmr::null_memory_resource() );
+    {
+        ds::orgraph::orgraph<int,int,ds::orgraph::pmr_slot_map_storage> ag( &arena );
+        ag.reserve( 100, 99 );
+        std::vector< ds::orgraph::node_ref<int,int,ds::orgraph::pmr_slot_map_storage> > an;
+        an.push_back( ag.add_node( 0 ) );
+        for ( int i = 1; i < 100; i++ )
+        {
+            an.push_back( ag.add_node( i ) );
+            ag.add_edge( i, an[i - 1], an[i] );
+        }
+        printf( "Arena graph: %d nodes, %d edges, from arena %d\n\n",
+                (int)ag.nodes().size(), (int)ag.edges().size(),
+                (int)( ag.get_allocator().resource() == &arena ) );
+    }
+    // Arena graph: 100 nodes, 99 edges, from arena 1
+    
+    // bulk removal: hub with self loop and ring of nodes around it
+    ds::orgraph::orgraph<int,int,ds::orgraph::slot_map_storage> rg;
+    std::vector< ds::orgraph::node_ref<int,int,ds::orgraph::slot_map_storage> > rn;
+    for ( int i = 0; i < 8; i++ )
+    {
+        rn.push_back( rg.add_node( i ) );
+    }
+    rg.add_edge( 0, rn[0], rn[0] );
+    for ( int i = 1; i < 8; i++ )
+    {
+        rg.add_edge( i, rn[0], rn[i] );
+        rg.add_edge( 10 * i, rn[i], rn[0] );
+        rg.add_edge( 100 * i, rn[i], rn[ i % 7 + 1 ] );
+    }
+    rg.enable_edge_index();
+    rg.remove_node( rn[0] );
+    printf( "After hub removal: %d nodes, %d edges, edge 100 is found: %d\n",
+            (int)rg.nodes().size(), (int)rg.edges().size(), (int)rg.find_edge( 100 ).has_value() );
+
+    std::vector< ds::orgraph::node_ref<int,int,ds::orgraph::slot_map_storage> > rm_nodes =
+        { rn[1], rn[2], rn[1] };
+    rg.remove_nodes( rm_nodes.begin(), rm_nodes.end() );
+    printf( "After removal of nodes 1, 2: %d nodes, %d edges\n", (int)rg.nodes().size(), (int)rg.edges().size() );
+
+    std::vector< ds::orgraph::edge_ref<int,int,ds::orgraph::slot_map_storage> > rm_edges = rn[3].succ_edges();
+    rm_edges.push_back( rm_edges[0] );
+    rg.remove_edges( rm_edges.begin(), rm_edges.end() );
+    printf( "Succs of node 3: %d, preds of node 4: %d\n", (int)rn[3].succ_edges().size(), (int)rn[4].pred_edges().size() );
+
+    // lazy removal: tombstones stay in adjacency until compaction, so adjacency is read before and after it
+    auto rn6_succ = rn[6].succ_edges()[0];
+    rg.defer_compaction();
+    rg.remove_node( rn[5] );
+    rg.remove_edge( rn6_succ );
+    auto rn8 = rg.add_node( 8 );
+    rg.add_edge( 800, rn8, rn[4] );
+    rg.compact();
+    printf( "After compaction: %d nodes, %d edges, preds of node 4:", (int)rg.nodes().size(), (int)rg.edges().size() );
+    for ( auto e : rn[4].pred_edges() )
+    {
+        printf( " %d", *e );
+    }
+    printf( ", succs of node 6: %d\n\n", (int)rn[6].succ_edges().size() );
+    // After hub removal: 7 nodes, 7 edges, edge 100 is found: 1
+    // After removal of nodes 1, 2: 5 nodes, 4 edges
+    // Succs of node 3: 0, preds of node 4: 0
+    // After compaction: 5 nodes, 1 edges, preds of node 4: 800, succs of node 6: 0
+
     return 0;
 }
@@ -0,0 +1,199 @@
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+#include <stdio.h>
+
+#include "orgraph_changelog.hpp"
+
+/**
+ * Keeps out-degree of every node by deltas.
+ */
+class degree_counter : public ds::orgraph::orgraph_change_subscriber
+{
+public:
+    std::unordered_map<ds::orgraph::node_id,int> out_degree;
+    int writes = 0;
+    int batches = 0;
+
+    void on_changes( const std::vector<ds::orgraph::orgraph_change>& batch ) override
+    {
+        batches++;
+        for ( const auto& cur_change : batch )
+        {
+            switch ( cur_change.kind )
+            {
+            case ds::orgraph::change_kind::add_node:
+                out_degree[cur_change.node] = 0;
+                break;
+            case ds::orgraph::change_kind::remove_node:
+                out_degree.erase( cur_change.node );
+                break;
+            case ds::orgraph::change_kind::add_edge:
+                out_degree[cur_change.pred]++;
+                break;
+            case ds::orgraph::change_kind::remove_edge:
+                out_degree[cur_change.pred]--;
+                break;
+            case ds::orgraph::change_kind::write_node:
+            case ds::orgraph::change_kind::write_edge:
+                writes++;
+                break;
+            }
+        }
+    }
+};
+
+/**
+ * Takes one batch, then swaps subscribers: unsubscribes itself and other, subscribes next.
+ */
+class one_shot : public ds::orgraph::orgraph_change_subscriber
+{
+public:
+    ds::orgraph::orgraph_changelog<int,int> *log_p = nullptr;
+    ds::orgraph::orgraph_change_subscriber *other_p = nullptr;
+    ds::orgraph::orgraph_change_subscriber *next_p = nullptr;
+    int batches = 0;
+    size_t nested = 0;
+
+    void on_changes( const std::vector<ds::orgraph::orgraph_change>& ) override
+    {
+        batches++;
+        nested = log_p->dispatch();
+        log_p->unsubscribe( this );
+        log_p->unsubscribe( other_p );
+        log_p->subscribe( next_p );
+    }
+};
+
+/**
+ * On first added node destroys log and unsubscribes itself.
+ */
+class log_killer : public ds::orgraph::orgraph_listener<int,int>
+{
+public:
+    ds::orgraph::orgraph<int,int> *graph_p = nullptr;
+    std::unique_ptr< ds::orgraph::orgraph_changelog<int,int> > log_p;
+    int calls = 0;
+
+    void on_add_node( const ds::orgraph::node_ref<int,int>& ) override
+    {
+        calls++;
+        log_p.reset();
+        graph_p->unsubscribe( this );
+    }
+};
+
+int main( void )
+{
+    ds::orgraph::orgraph<int,int> og;
+    ds::orgraph::orgraph_changelog<int,int> log( og );
+    degree_counter counter;
+    log.subscribe( &counter );
+
+    std::vector< ds::orgraph::node_ref<int,int> > n;
+    for ( int i = 0; i < 4; i++ )
+    {
+        n.push_back( og.add_node( i ) );
+    }
+    og.add_edge( 1, n[0], n[1] );
+    og.add_edge( 1, n[0], n[2] );
+    og.add_edge( 1, n[1], n[2] );
+    auto e = og.add_edge( 1, n[2], n[3] );
+    printf( "Recorded changes: %zu\n", log.changes().size() );
+    printf( "Dispatched changes: %zu\n", log.dispatch() );
+    for ( int i = 0; i < 4; i++ )
+    {
+        printf( "Out-degree of node %d: %d\n", i, counter.out_degree[ n[i].id() ] );
+    }
+    printf( "\n" );
+    // Recorded changes: 8
+    // Dispatched changes: 8
+    // Out-degree of node 0: 2
+    // Out-degree of node 1: 1
+    // Out-degree of node 2: 1
+    // Out-degree of node 3: 0
+
+    // repeated writes in a row are recorded once
+    *n[3] = 30;
+    *n[3] += 1;
+    *e = 5;
+    *n[3] += 1;
+    printf( "Recorded writes: %zu\n", log.changes().size() );
+    log.dispatch();
+    printf( "Counted writes: %d\n", counter.writes );
+    printf( "\n" );
+    // Recorded writes: 3
+    // Counted writes: 3
+
+    // reads are not recorded
+    int read_sum = n[3].read();
+    for ( auto cur_edge : n[0].succ_edges() )
+    {
+        read_sum += cur_edge.read();
+    }
+    printf( "Read sum: %d, recorded changes: %zu\n", read_sum, log.changes().size() );
+    printf( "\n" );
+    // Read sum: 34, recorded changes: 0
+
+    // removed node brings removals of its edges first
+    og.remove_node( n[2] );
+    for ( const auto& cur_change : log.changes() )
+    {
+        printf( "Change %d\n", (int)cur_change.kind );
+    }
+    log.dispatch();
+    printf( "Out-degree of node 0: %d\n", counter.out_degree[ n[0].id() ] );
+    printf( "Out-degree of node 1: %d\n", counter.out_degree[ n[1].id() ] );
+    printf( "Nodes counted: %zu\n", counter.out_degree.size() );
+    printf( "\n" );
+    // Change 3
+    // Change 3
+    // Change 3
+    // Change 2
+    // Out-degree of node 0: 1
+    // Out-degree of node 1: 0
+    // Nodes counted: 3
+
+    // empty log dispatches nothing, unsubscribed counter gets nothing
+    printf( "Dispatched changes: %zu\n", log.dispatch() );
+    log.unsubscribe( &counter );
+    og.add_node( 4 );
+    log.dispatch();
+    printf( "Batches: %d\n", counter.batches );
+    // Dispatched changes: 0
+    // Batches: 3
+
+    // subscribers changed from on_changes take effect from the next batch
+    one_shot shot;
+    degree_counter other;
+    shot.log_p = &log;
+    shot.other_p = &other;
+    shot.next_p = &counter;
+    log.subscribe( &shot );
+    log.subscribe( &other );
+    og.add_node( 5 );
+    og.add_node( 6 );
+    printf( "Dispatched changes: %zu", log.dispatch() );
+    printf( ", nested dispatch: %zu\n", shot.nested );
+    og.add_node( 7 );
+    log.dispatch();
+    printf( "Batches of one shot: %d, other: %d, counter: %d\n", shot.batches, other.batches, counter.batches );
+    // Dispatched changes: 2, nested dispatch: 0
+    // Batches of one shot: 1, other: 0, counter: 4
+
+    // listeners unsubscribed by callback of graph, even destroyed, are not called
+    ds::orgraph::orgraph<int,int> kg;
+    log_killer killer;
+    killer.graph_p = &kg;
+    kg.subscribe( &killer );
+    killer.log_p.reset( new ds::orgraph::orgraph_changelog<int,int>( kg ) );
+    ds::orgraph::orgraph_changelog<int,int> kept( kg );
+    kg.add_node( 1 );
+    kg.add_node( 2 );
+    printf( "Killer calls: %d, log is destroyed: %d, kept changes: %zu\n", killer.calls, (int)!killer.log_p,
+            kept.changes().size() );
+    // Killer calls: 1, log is destroyed: 1, kept changes: 2
+
+    return 0;
+}
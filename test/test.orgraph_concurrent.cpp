@@ -0,0 +1,77 @@
+#include <vector>
+#include <thread>
+#include <atomic>
+
+#include <stdio.h>
+
+#include "orgraph_concurrent.hpp"
+
+int main( void )
+{
+    ds::orgraph::concurrent_orgraph<int,int> cg;
+    printf( "Epoch %d: %d nodes\n\n", (int)cg.epoch(), (int)cg.read()->view.node_count() );
+    // Epoch 1: 0 nodes
+    
+    // writer grows chain by batches of 10 nodes, every snapshot is a whole chain
+    std::vector< ds::orgraph::node_ref<int,int> > chain;
+    std::atomic<bool> done( false );
+    std::atomic<int>  num_broken( 0 );
+    
+    std::vector<std::thread> readers;
+    for ( int i = 0; i < 4; i++ )
+    {
+        readers.emplace_back( [&]
+                              {
+                                  uint64_t last_epoch = 0;
+                                  while ( !done.load() )
+                                  {
+                                      auto snapshot_p = cg.read();
+                                      const auto& view = snapshot_p->view;
+                                      if ( snapshot_p->epoch < last_epoch ||
+                                           ( view.node_count() > 0 &&
+                                             view.edge_count() != view.node_count() - 1 ) )
+                                      {
+                                          num_broken++;
+                                      }
+                                      last_epoch = snapshot_p->epoch;
+                                  }
+                              } );
+    }
+    
+    for ( int batch = 0; batch < 50; batch++ )
+    {
+        cg.write( [&]( ds::orgraph::orgraph<int,int>& master )
+                  {
+                      for ( int i = 0; i < 10; i++ )
+                      {
+                          chain.push_back( master.add_node( (int)chain.size() ) );
+                          if ( chain.size() > 1 )
+                          {
+                              master.add_edge( 0, chain[chain.size() - 2], chain.back() );
+                          }
+                      }
+                  } );
+    }
+    done = true;
+    for ( auto& reader : readers )
+    {
+        reader.join();
+    }
+    
+    auto snapshot_p = cg.read();
+    printf( "Epoch %d: %d nodes, %d edges, broken snapshots %d\n",
+            (int)snapshot_p->epoch, (int)snapshot_p->view.node_count(),
+            (int)snapshot_p->view.edge_count(), num_broken.load() );
+    // Epoch 51: 500 nodes, 499 edges, broken snapshots 0
+    
+    // held snapshot doesn't see next batch
+    cg.write( [&]( ds::orgraph::orgraph<int,int>& master )
+              {
+                  master.remove_node( chain.back() );
+              } );
+    printf( "Held snapshot: %d nodes, current: %d nodes\n",
+            (int)snapshot_p->view.node_count(), (int)cg.read()->view.node_count() );
+    // Held snapshot: 500 nodes, current: 499 nodes
+    
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include <string>
+#include <stdexcept>
+
+#include <stdio.h>
+
+#include "orgraph_csr.hpp"
+
+int main( void )
+{
+    ds::orgraph::orgraph<int,int> og;
+    
+    ds::orgraph::node_ref<int,int> start = og.add_node( 1 );
+    ds::orgraph::node_ref<int,int> n2    = og.add_node( 2 );
+    ds::orgraph::node_ref<int,int> n3    = og.add_node( 3 );
+    ds::orgraph::node_ref<int,int> stop  = og.add_node( 4 );
+    
+    og.add_edge( 10, start, n2 );
+    og.add_edge( 20, start, n3 );
+    og.add_edge( 30, n2, stop );
+    ds::orgraph::edge_ref<int,int> e4 = og.add_edge( 40, n3, stop );
+    og.add_edge( 50, stop, start );
+    
+    og.remove_edge( e4 );
+    
+    ds::orgraph::csr_view<int,int> csr = ds::orgraph::freeze( og );
+    printf( "Nodes: %d, edges: %d\n\n", csr.node_count(), csr.edge_count() );
+    // Nodes: 4, edges: 4
+    
+    // changes of graph are not visible through snapshot
+    og.add_edge( 60, n3, n2 );
+    *start = 100;
+    
+    ds::orgraph::csr_node_ref<int,int> cstart = *csr.find( start );
+    for ( auto e : cstart.succ_edges() )
+    {
+        printf( "Succ of start: edge %d to node %d\n", *e, *e.succ() );
+    }
+    printf( "\n" );
+    // Succ of start: edge 10 to node 2
+    // Succ of start: edge 20 to node 3
+    
+    ds::orgraph::csr_node_ref<int,int> cstop = *csr.find( stop );
+    for ( auto n : cstop.pred_nodes() )
+    {
+        printf( "Pred of stop: node %d\n", *n );
+    }
+    for ( auto n : cstop.succ_nodes() )
+    {
+        printf( "Succ of stop: node %d\n", *n );
+    }
+    printf( "\n" );
+    // Pred of stop: node 2
+    // Succ of stop: node 1
+    
+    for ( auto n : csr.nodes() )
+    {
+        printf( "Node %d: %d pred, %d succ\n", *n, n.pred_count(), n.succ_count() );
+    }
+    printf( "\n" );
+    // Node 1: 1 pred, 2 succ
+    // Node 2: 1 pred, 1 succ
+    // Node 3: 1 pred, 0 succ
+    // Node 4: 1 pred, 1 succ
+    
+    printf( "Origin of first node: %d\n", *csr.origin( og, csr.node( 0 ) ) );
+    // Origin of first node: 100
+    
+    ds::orgraph::node_ref<int,int> late = og.add_node( 5 );
+    printf( "Late node is in snapshot: %d\n", (int)csr.find( late ).has_value() );
+    // Late node is in snapshot: 0
+    
+    return 0;
+}
@@ -0,0 +1,214 @@
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <cmath>
+
+#include <stdio.h>
+
+#include "orgraph_grid.hpp"
+#include "orgraph_traversal.hpp"
+
+using ds::vector2d::vector2d;
+using ds::vector2d::point2d;
+
+const double diagonal_cost = 1.4142135623730951;
+
+double MapCost( char cell, bool diagonal )
+{
+    return ( '#' == cell ) ? -1.0 : ( diagonal ? diagonal_cost : 1.0 );
+}
+
+double CostlyDiagonal( char cell, bool diagonal )
+{
+    return ( '#' == cell ) ? -1.0 : ( diagonal ? 3.0 : 1.0 );
+}
+
+double TerrainCost( int cell, bool diagonal )
+{
+    return ( cell < 0 ) ? -1.0 : ( diagonal ? diagonal_cost : 1.0 ) * cell;
+}
+
+int main( void )
+{
+    const char *rows[] = { "..........",
+                           ".####.###.",
+                           "....#...#.",
+                           ".##.###.#.",
+                           "..#.....#.",
+                           "..######..",
+                           ".........." };
+    vector2d<char> map( 10, 7 );
+    for ( int32_t y = 0; y < map.size().y; y++ )
+    {
+        for ( int32_t x = 0; x < map.size().x; x++ )
+        {
+            map( x, y ) = rows[y][x];
+        }
+    }
+    
+    // 4-connected grid through traversal and shortest path engines
+    auto grid4 = ds::orgraph::adapt( map, ds::orgraph::grid_connectivity::four, MapCost );
+    const int32_t from = grid4.vertex( point2d( 0, 0 ) );
+    const int32_t to = grid4.vertex( point2d( 5, 4 ) );
+    std::vector<int32_t> levels = ds::orgraph::bfs_levels( grid4, from );
+    printf( "Cells: %d, edges: %d, bfs level of (5,4): %d, of wall (1,1): %d\n", (int)grid4.vertex_bound(),
+            (int)grid4.edge_count(), levels[to], levels[grid4.vertex( point2d( 1, 1 ) )] );
+    
+    ds::orgraph::shortest_path_scratch<double> scratch;
+    ds::orgraph::dijkstra( grid4, from, grid4.weight(), scratch );
+    const double dijkstra_4 = scratch.distance( to );
+    ds::orgraph::astar( grid4, from, to, grid4.weight(), grid4.heuristic( to, 1.0, 1.0 ), scratch );
+    printf( "4-connected distance: dijkstra %g, astar %g\n", dijkstra_4, scratch.distance( to ) );
+    // Cells: 70, edges: 102, bfs level of (5,4): 9, of wall (1,1): -1
+    // 4-connected distance: dijkstra 9, astar 9
+    
+    // 8-connected: astar and jump point search find paths of the same length
+    auto grid8 = ds::orgraph::adapt( map, ds::orgraph::grid_connectivity::eight, MapCost );
+    const int32_t far = grid8.vertex( point2d( 9, 6 ) );
+    ds::orgraph::astar( grid8, from, far, grid8.weight(), grid8.heuristic( far, 1.0, diagonal_cost ), scratch );
+    std::vector<int32_t> astar_path = scratch.path( far );
+    const double astar_8 = scratch.distance( far );
+    ds::orgraph::jump_point_search( grid8, from, far, scratch );
+    std::vector<int32_t> jump_points = scratch.path( far );
+    std::vector<int32_t> jps_path = ds::orgraph::expand_jump_path( grid8, jump_points );
+    printf( "8-connected distance: astar %.4f (%d cells), jps %.4f (%d jump points, %d cells)\n",
+            astar_8, (int)astar_path.size(), scratch.distance( far ), (int)jump_points.size(), (int)jps_path.size() );
+    vector2d<char> drawn = map;
+    for ( auto v : jps_path )
+    {
+        drawn.at_unchecked( grid8.position( v ) ) = '*';
+    }
+    for ( int32_t y = 0; y < drawn.size().y; y++ )
+    {
+        for ( int32_t x = 0; x < drawn.size().x; x++ )
+        {
+            printf( "%c", drawn( x, y ) );
+        }
+        printf( "\n" );
+    }
+    // 8-connected distance: astar 14.4142 (15 cells), jps 14.4142 (7 jump points, 15 cells)
+    // *.........
+    // *####.###.
+    // *...#...#.
+    // *##.###.#.
+    // *.#.....#.
+    // .*######..
+    // .*********
+    
+    // random terrain: all searches agree
+    vector2d<int> terrain( 120, 90 );
+    vector2d<char> walls( terrain.size() );
+    uint32_t seed = 11;
+    for ( int32_t y = 0; y < terrain.size().y; y++ )
+    {
+        for ( int32_t x = 0; x < terrain.size().x; x++ )
+        {
+            seed = seed * 1103515245 + 12345;
+            const bool is_wall = ( ( seed >> 8 ) % 100 < 25 );
+            seed = seed * 1103515245 + 12345;
+            terrain( x, y ) = is_wall ? -1 : 1 + (int)( ( seed >> 8 ) % 5 );
+            walls( x, y ) = is_wall ? '#' : '.';
+        }
+    }
+    auto weighted = ds::orgraph::adapt( terrain, ds::orgraph::grid_connectivity::eight, TerrainCost );
+    auto uniform = ds::orgraph::adapt( walls, ds::orgraph::grid_connectivity::eight, MapCost );
+    ds::orgraph::shortest_path_scratch<double> other;
+    int num_queries = 0;
+    int num_weighted_same = 0;
+    int num_uniform_same = 0;
+    int num_reached = 0;
+    while ( num_queries < 40 )
+    {
+        seed = seed * 1103515245 + 12345;
+        const int32_t source = ( seed >> 8 ) % weighted.vertex_bound();
+        seed = seed * 1103515245 + 12345;
+        const int32_t target = ( seed >> 8 ) % weighted.vertex_bound();
+        if ( !weighted.is_vertex( source ) || !weighted.is_vertex( target ) )
+        {
+            continue;
+        }
+        num_queries++;
+        
+        ds::orgraph::dijkstra( weighted, source, weighted.weight(), scratch, target );
+        ds::orgraph::astar( weighted, source, target, weighted.weight(),
+                            weighted.heuristic( target, 1.0, diagonal_cost ), other );
+        num_weighted_same += ( scratch.distance( target ) == other.distance( target ) ||
+                               std::fabs( scratch.distance( target ) - other.distance( target ) ) < 1e-9 );
+        
+        ds::orgraph::astar( uniform, source, target, uniform.weight(),
+                            uniform.heuristic( target, 1.0, diagonal_cost ), scratch );
+        ds::orgraph::jump_point_search( uniform, source, target, other );
+        num_uniform_same += ( scratch.distance( target ) == other.distance( target ) ||
+                              std::fabs( scratch.distance( target ) - other.distance( target ) ) < 1e-9 );
+        num_reached += (int)scratch.reached( target );
+    }
+    printf( "Queries: %d, weighted dijkstra = astar: %d, uniform astar = jps: %d, reached: %d\n",
+            num_queries, num_weighted_same, num_uniform_same, num_reached );
+    // Queries: 40, weighted dijkstra = astar: 40, uniform astar = jps: 40, reached: 40
+    
+    // diagonal dearer than two straight steps: heuristic still doesn't overestimate
+    auto costly = ds::orgraph::adapt( walls, ds::orgraph::grid_connectivity::eight, CostlyDiagonal );
+    int num_costly_queries = 0;
+    int num_costly_same = 0;
+    while ( num_costly_queries < 20 )
+    {
+        seed = seed * 1103515245 + 12345;
+        const int32_t source = ( seed >> 8 ) % costly.vertex_bound();
+        seed = seed * 1103515245 + 12345;
+        const int32_t target = ( seed >> 8 ) % costly.vertex_bound();
+        if ( !costly.is_vertex( source ) || !costly.is_vertex( target ) )
+        {
+            continue;
+        }
+        num_costly_queries++;
+        ds::orgraph::dijkstra( costly, source, costly.weight(), scratch, target );
+        ds::orgraph::astar( costly, source, target, costly.weight(), costly.heuristic( target, 1.0, 3.0 ), other );
+        num_costly_same += ( scratch.distance( target ) == other.distance( target ) );
+    }
+    printf( "Costly diagonals, dijkstra = astar: %d of 20\n", num_costly_same );
+    // Costly diagonals, dijkstra = astar: 20 of 20
+    
+    // errors
+    try
+    {
+        ds::orgraph::jump_point_search( grid4, from, to, scratch );
+    } catch ( const std::invalid_argument& ia )
+    {
+        printf( "Invalid argument: %s\n", ia.what() );
+    }
+    try
+    {
+        ds::orgraph::astar( grid8, from, grid8.vertex( point2d( 1, 1 ) ), grid8.weight(),
+                            grid8.heuristic( 0, 1.0, 1.0 ), scratch );
+    } catch ( const std::out_of_range& oor )
+    {
+        printf( "Out of Range error: %s\n", oor.what() );
+    }
+    // Invalid argument: jump point search needs 8-connected grid
+    // Out of Range error: target vertex 11 is not in graph
+    
+    // scratch is reusable after search, which threw with vertices in heap
+    int num_estimates = 0;
+    try
+    {
+        ds::orgraph::astar( uniform, 0, uniform.vertex_bound() - 1, uniform.weight(),
+                            [&]( int32_t ) -> double
+                            {
+                                if ( ++num_estimates > 100 )
+                                {
+                                    throw std::runtime_error( "heuristic failed" );
+                                }
+                                return 0.0;
+                            },
+                            scratch );
+    } catch ( const std::runtime_error& re )
+    {
+        printf( "Runtime error: %s\n", re.what() );
+    }
+    ds::orgraph::jump_point_search( grid8, from, far, scratch );
+    printf( "After error: jps %.4f\n", scratch.distance( far ) );
+    // Runtime error: heuristic failed
+    // After error: jps 14.4142
+    
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include <stdio.h>
+
+#include "orgraph_ingest.hpp"
+
+int main( void )
+{
+    const char *path = "test.orgraph_ingest.txt";
+    FILE *file_p = fopen( path, "w" );
+    fprintf( file_p, "# source target weight\n" );
+    for ( int i = 0; i < 1000; i++ )
+    {
+        fprintf( file_p, "%d %d %d\n", i, ( i + 1 ) % 1000, i % 7 );
+    }
+    fprintf( file_p, "\nbroken line\n5 500\r\n" );
+    fclose( file_p );
+
+    ds::orgraph::orgraph<int,int> og;
+    ds::orgraph::edge_list_importer<int,int,int64_t> importer( og );
+
+    // tiny chunks make many lines cross chunk borders
+    ds::orgraph::ingest_options options;
+    options.chunk_bytes  = 64;
+    options.queue_chunks = 2;
+    options.num_parsers  = 3;
+
+    file_p = fopen( path, "r" );
+    ds::orgraph::ingest_stats stats =
+        importer.import( file_p, ds::orgraph::whitespace_edge_parser<int>{ -1 },
+                         []( int64_t key ) { return (int)key; }, options );
+    fclose( file_p );
+    printf( "Lines %d, skipped %d, nodes %d, edges %d\n",
+            (int)stats.lines, (int)stats.skipped, (int)stats.nodes, (int)stats.edges );
+    printf( "Graph: %d nodes, %d edges\n", (int)og.nodes().size(), (int)og.edges().size() );
+    // Lines 1004, skipped 3, nodes 1000, edges 1001
+    // Graph: 1000 nodes, 1001 edges
+
+    auto n5 = importer.find( 5 );
+    printf( "Succs of 5:" );
+    for ( auto e : n5->succ_edges_range() )
+    {
+        printf( " %d (weight %d)", *e.succ(), *e );
+    }
+    printf( "\n" );
+    // Succs of 5: 6 (weight 5) 500 (weight -1)
+
+    // next import extends the same nodes
+    file_p = fopen( path, "w" );
+    fprintf( file_p, "999 1000 9\n" );
+    fclose( file_p );
+    file_p = fopen( path, "r" );
+    stats = importer.import( file_p, ds::orgraph::whitespace_edge_parser<int>(),
+                             []( int64_t key ) { return (int)key; } );
+    fclose( file_p );
+    printf( "Added nodes %d, edges %d, preds of 999: %d\n\n",
+            (int)stats.nodes, (int)stats.edges, (int)importer.find( 999 )->pred_edges().size() );
+    // Added nodes 1, edges 1, preds of 999: 1
+
+    // exception of parser stops import
+    file_p = fopen( path, "r" );
+    try
+    {
+        importer.import( file_p,
+                         []( const char*, const char*, ds::orgraph::edge_record<int64_t,int>& ) -> bool
+                         {
+                             throw std::runtime_error( "bad line" );
+                         },
+                         []( int64_t key ) { return (int)key; } );
+    } catch ( const std::runtime_error& err )
+    {
+        printf( "Import failed: %s\n", err.what() );
+    }
+    fclose( file_p );
+    // Import failed: bad line
+
+    // error of reading is not taken as end of file
+    file_p = fopen( path, "a" );
+    try
+    {
+        importer.import( file_p, ds::orgraph::whitespace_edge_parser<int>(),
+                         []( int64_t key ) { return (int)key; } );
+    } catch ( const std::runtime_error& err )
+    {
+        printf( "Import failed: %s\n", err.what() );
+    }
+    fclose( file_p );
+    // Import failed: error of reading edge list after 0 chunks
+
+    remove( path );
+
+    return 0;
+}
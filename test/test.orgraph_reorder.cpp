@@ -0,0 +1,75 @@
+#include <vector>
+#include <stdexcept>
+
+#include <stdio.h>
+
+#include "orgraph_reorder.hpp"
+
+int main( void )
+{
+    // path 0 - 5 - 2 - 7 - 4 - 9 - 1 - 6 - 3 - 8 with hub 10 linked to 2 and 6,
+    // insertion order scatters neighbours
+    ds::orgraph::orgraph<int,int> og;
+    std::vector< ds::orgraph::node_ref<int,int> > n;
+    for ( int i = 0; i <= 10; i++ )
+    {
+        n.push_back( og.add_node( i ) );
+    }
+    const int path[] = { 0, 5, 2, 7, 4, 9, 1, 6, 3, 8 };
+    for ( int i = 0; i + 1 < 10; i++ )
+    {
+        og.add_edge( i, n[ path[i] ], n[ path[i + 1] ] );
+    }
+    og.add_edge( 100, n[10], n[2] );
+    og.add_edge( 101, n[10], n[6] );
+
+    ds::orgraph::csr_view<int,int> csr = ds::orgraph::freeze( og );
+    printf( "Bandwidth of insertion order: %d\n", ds::orgraph::bandwidth( csr ) );
+
+    const ds::orgraph::reorder_kind kinds[] = { ds::orgraph::reorder_kind::rcm,
+                                                ds::orgraph::reorder_kind::bfs,
+                                                ds::orgraph::reorder_kind::degree };
+    const char *names[] = { "rcm", "bfs", "degree" };
+    for ( int k = 0; k < 3; k++ )
+    {
+        ds::orgraph::csr_view<int,int> reordered = ds::orgraph::reorder( csr, kinds[k] );
+        printf( "Order %s:", names[k] );
+        for ( auto cur_node : reordered.nodes() )
+        {
+            printf( " %d", *cur_node );
+        }
+        printf( ", bandwidth %d\n", ds::orgraph::bandwidth( reordered ) );
+    }
+    printf( "\n" );
+    // Bandwidth of insertion order: 8
+    // Order rcm: 8 1 3 9 6 4 10 7 2 5 0, bandwidth 3
+    // Order bfs: 0 5 2 7 10 4 6 9 3 1 8, bandwidth 3
+    // Order degree: 2 6 1 3 4 5 7 9 10 0 8, bandwidth 8
+
+    // permuted snapshot maps nodes and edges back to graph
+    ds::orgraph::csr_view<int,int> rcm = ds::orgraph::reorder( csr, ds::orgraph::reorder_kind::rcm );
+    auto cur_node = *rcm.find( n[7] );
+    printf( "Node 7 has index %d, origin %d, succs:", cur_node.index(), *rcm.origin( og, cur_node ) );
+    for ( auto cur_edge : cur_node.succ_edges() )
+    {
+        printf( " %d by edge %d", *cur_edge.succ(), *rcm.origin( og, cur_edge ) );
+    }
+    printf( ", preds:" );
+    for ( auto cur_pred : cur_node.pred_nodes() )
+    {
+        printf( " %d", *cur_pred );
+    }
+    printf( "\n" );
+    try
+    {
+        csr.permuted( { 0, 1, 1, 2, 3, 4, 5, 6, 7, 8, 9 } );
+    }
+    catch ( const std::invalid_argument& e )
+    {
+        printf( "Bad order: %s\n", e.what() );
+    }
+    // Node 7 has index 7, origin 7, succs: 4 by edge 3, preds: 2
+    // Bad order: order is not a permutation of nodes
+
+    return 0;
+}
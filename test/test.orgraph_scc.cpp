@@ -0,0 +1,161 @@
+#include <vector>
+
+#include <stdio.h>
+
+#include "orgraph_scc.hpp"
+
+int main( void )
+{
+    ds::orgraph::orgraph<int,int> og;
+
+    std::vector< ds::orgraph::node_ref<int,int> > n;
+    for ( int i = 0; i < 7; i++ )
+    {
+        n.push_back( og.add_node( i ) );
+    }
+    // components { 0, 1, 2 } -> { 3, 4 } -> { 5 }, { 6 } alone
+    og.add_edge( 1, n[0], n[1] );
+    og.add_edge( 1, n[1], n[2] );
+    og.add_edge( 1, n[2], n[0] );
+    og.add_edge( 1, n[2], n[3] );
+    og.add_edge( 1, n[1], n[4] );
+    og.add_edge( 1, n[3], n[4] );
+    og.add_edge( 1, n[4], n[3] );
+    og.add_edge( 1, n[4], n[5] );
+
+    auto graph = ds::orgraph::adapt( og );
+    ds::orgraph::scc_result scc = ds::orgraph::strongly_connected_components( graph );
+    printf( "Components: %d\n", scc.count );
+    for ( int i = 0; i < 7; i++ )
+    {
+        printf( "Node %d is in component %d\n", i, scc.component[ graph.vertex( n[i] ) ] );
+    }
+    printf( "\n" );
+    // Components: 4
+    // Node 0 is in component 1
+    // Node 1 is in component 1
+    // Node 2 is in component 1
+    // Node 3 is in component 2
+    // Node 4 is in component 2
+    // Node 5 is in component 3
+    // Node 6 is in component 0
+
+    ds::orgraph::condensation dag( graph, scc );
+    for ( int32_t c = 0; c < dag.vertex_bound(); c++ )
+    {
+        dag.for_each_succ( c, [&]( int32_t w, int32_t count )
+                           {
+                               printf( "Component %d -> %d by %d edges\n", c, w, count );
+                               return true;
+                           } );
+    }
+    printf( "\n" );
+    // Component 1 -> 2 by 2 edges
+    // Component 2 -> 3 by 1 edges
+
+    ds::orgraph::reachability_index index( graph );
+    printf( "0 reaches 5: %d\n", index.reaches( graph.vertex( n[0] ), graph.vertex( n[5] ) ) );
+    printf( "4 reaches 3: %d\n", index.reaches( graph.vertex( n[4] ), graph.vertex( n[3] ) ) );
+    printf( "5 reaches 0: %d\n", index.reaches( graph.vertex( n[5] ), graph.vertex( n[0] ) ) );
+    printf( "6 reaches 0: %d\n", index.reaches( graph.vertex( n[6] ), graph.vertex( n[0] ) ) );
+    printf( "\n" );
+    // 0 reaches 5: 1
+    // 4 reaches 3: 1
+    // 5 reaches 0: 0
+    // 6 reaches 0: 0
+
+    // hole left by removed node is not vertex of any component
+    og.remove_node( n[6] );
+    scc = ds::orgraph::strongly_connected_components( ds::orgraph::adapt( og ) );
+    printf( "Components after removal: %d\n", scc.count );
+    ds::orgraph::reachability_index holed_index( ds::orgraph::adapt( og ) );
+    const int32_t hole = graph.vertex( n[6] );
+    printf( "Hole reaches itself: %d, 0 reaches hole: %d\n", holed_index.reaches( hole, hole ),
+            holed_index.reaches( graph.vertex( n[0] ), hole ) );
+    printf( "\n" );
+    // Components after removal: 3
+    // Hole reaches itself: 0, 0 reaches hole: 0
+
+    // hub with huge fan-out is labeled in linear time
+    ds::orgraph::orgraph<int,int> star;
+    auto hub = star.add_node( -1 );
+    ds::orgraph::node_ref<int,int> last_leaf = hub;
+    for ( int i = 0; i < 200000; i++ )
+    {
+        last_leaf = star.add_node( i );
+        star.add_edge( 1, hub, last_leaf );
+    }
+    auto star_graph = ds::orgraph::adapt( star );
+    ds::orgraph::reachability_index star_index( star_graph );
+    printf( "Hub reaches leaf: %d, leaf reaches hub: %d\n\n",
+            star_index.reaches( star_graph.vertex( hub ), star_graph.vertex( last_leaf ) ),
+            star_index.reaches( star_graph.vertex( last_leaf ), star_graph.vertex( hub ) ) );
+    // Hub reaches leaf: 1, leaf reaches hub: 0
+
+    // big graph: parallel components and index agree with Tarjan's components and search
+    ds::orgraph::orgraph<int,int> big;
+    std::vector< ds::orgraph::node_ref<int,int> > bn;
+    const int num_big = 3000;
+    for ( int i = 0; i < num_big; i++ )
+    {
+        bn.push_back( big.add_node( i ) );
+    }
+    uint32_t seed = 1;
+    for ( int i = 0; i < num_big + num_big / 4; i++ )
+    {
+        seed = seed * 1103515245 + 12345;
+        int from = ( seed >> 8 ) % num_big;
+        seed = seed * 1103515245 + 12345;
+        int to = ( seed >> 8 ) % num_big;
+        big.add_edge( 1, bn[from], bn[to] );
+    }
+
+    auto big_graph = ds::orgraph::adapt( big );
+    ds::thread_pool::thread_pool pool( 4 );
+    ds::orgraph::scc_result serial = ds::orgraph::strongly_connected_components( big_graph );
+    ds::orgraph::scc_result parallel = ds::orgraph::strongly_connected_components( big_graph, &pool, 64 );
+
+    // same partition: components match one to one
+    bool same = ( serial.count == parallel.count );
+    std::vector<int32_t> match( serial.count, -1 );
+    for ( int32_t v = 0; same && v < big_graph.vertex_bound(); v++ )
+    {
+        int32_t& cur_match = match[ serial.component[v] ];
+        if ( cur_match < 0 )
+        {
+            cur_match = parallel.component[v];
+        }
+        same = ( cur_match == parallel.component[v] );
+    }
+    printf( "Parallel components are the same: %d\n", same );
+
+    // both orders are topological
+    bool ordered = true;
+    for ( int32_t v = 0; v < big_graph.vertex_bound(); v++ )
+    {
+        big_graph.for_each_succ( v, [&]( int32_t w, const int& )
+                                 {
+                                     ordered &= ( serial.component[v] <= serial.component[w] );
+                                     ordered &= ( parallel.component[v] <= parallel.component[w] );
+                                     return true;
+                                 } );
+    }
+    printf( "Components are in topological order: %d\n", ordered );
+
+    ds::orgraph::reachability_index big_index( big_graph, &pool );
+    bool agree = true;
+    for ( int source = 0; source < num_big; source += 97 )
+    {
+        std::vector<int32_t> levels = ds::orgraph::bfs_levels( big_graph, source );
+        for ( int32_t v = 0; v < big_graph.vertex_bound(); v++ )
+        {
+            agree &= ( big_index.reaches( source, v ) == ( levels[v] >= 0 ) );
+        }
+    }
+    printf( "Index agrees with search: %d\n", agree );
+    // Parallel components are the same: 1
+    // Components are in topological order: 1
+    // Index agrees with search: 1
+
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include <stdio.h>
+
+#include "orgraph_serialization.hpp"
+
+int main( void )
+{
+    ds::orgraph::orgraph<int,double> og;
+    
+    std::vector< ds::orgraph::node_ref<int,double> > n;
+    for ( int i = 0; i < 4; i++ )
+    {
+        n.push_back( og.add_node( 10 * i ) );
+    }
+    og.add_edge( 0.5, n[0], n[1] );
+    og.add_edge( 1.5, n[1], n[2] );
+    og.add_edge( 2.5, n[0], n[3] );
+    
+    ds::orgraph::save( og, "test.orgraph_serialization.graph" );
+    
+    // raw payloads are read straight from mapping
+    ds::orgraph::csr_view<int,double> view =
+        ds::orgraph::map_csr<int,double>( "test.orgraph_serialization.graph" );
+    printf( "Mapped: %d nodes, %d edges\n", view.node_count(), view.edge_count() );
+    for ( auto e : view.edges() )
+    {
+        printf( "Edge %g: %d -> %d\n", *e, *e.pred(), *e.succ() );
+    }
+    auto found = view.find( n[3] );
+    printf( "Node 3 is found %d, preds %d\n\n", (int)found.has_value(), found->pred_count() );
+    // Mapped: 4 nodes, 3 edges
+    // Edge 0.5: 0 -> 10
+    // Edge 2.5: 0 -> 30
+    // Edge 1.5: 10 -> 20
+    // Node 3 is found 1, preds 1
+    
+    // encoded payloads
+    ds::orgraph::orgraph<std::string,std::string> sg;
+    auto sa = sg.add_node( "alpha" );
+    auto sb = sg.add_node( "" );
+    sg.add_edge( "alpha->empty", sa, sb );
+    ds::orgraph::save( sg, "test.orgraph_serialization.graph" );
+    
+    ds::orgraph::orgraph<std::string,std::string> loaded;
+    auto loaded_nodes = ds::orgraph::read_graph( "test.orgraph_serialization.graph", loaded );
+    for ( auto e : loaded_nodes[0].succ_edges_range() )
+    {
+        printf( "Loaded edge %s: '%s' -> '%s'\n",
+                ( *e ).c_str(), ( *e.pred() ).c_str(), ( *e.succ() ).c_str() );
+    }
+    // Loaded edge alpha->empty: 'alpha' -> ''
+    
+    // file of other types is rejected
+    try
+    {
+        ds::orgraph::map_csr<int,double>( "test.orgraph_serialization.graph" );
+    } catch ( const std::runtime_error& err )
+    {
+        printf( "Rejected: %s\n", err.what() );
+    }
+    // Rejected: orgraph file test.orgraph_serialization.graph: has other payload types
+    
+    remove( "test.orgraph_serialization.graph" );
+    
+    return 0;
+}
@@ -0,0 +1,138 @@
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include <stdio.h>
+
+#include "orgraph_shortest_path.hpp"
+
+int main( void )
+{
+    ds::orgraph::orgraph<int,int> og;
+    
+    std::vector< ds::orgraph::node_ref<int,int> > n;
+    for ( int i = 0; i < 5; i++ )
+    {
+        n.push_back( og.add_node( i ) );
+    }
+    og.add_edge( 10, n[0], n[1] );
+    og.add_edge(  3, n[0], n[2] );
+    og.add_edge(  4, n[2], n[1] );
+    og.add_edge(  2, n[1], n[3] );
+    og.add_edge( 20, n[2], n[3] );
+    
+    auto graph = ds::orgraph::adapt( og );
+    auto weight = []( const int& edge ) { return (double)edge; };
+    
+    ds::orgraph::shortest_path_scratch<double> scratch;
+    ds::orgraph::dijkstra( graph, graph.vertex( n[0] ), weight, scratch );
+    for ( int i = 0; i < 5; i++ )
+    {
+        if ( scratch.reached( graph.vertex( n[i] ) ) )
+        {
+            printf( "Distance to node %d: %g\n", i, scratch.distance( graph.vertex( n[i] ) ) );
+        } else
+        {
+            printf( "Node %d is not reached\n", i );
+        }
+    }
+    printf( "Path to node 3:" );
+    for ( auto v : scratch.path( graph.vertex( n[3] ) ) )
+    {
+        printf( " %d", *graph.node( v ) );
+    }
+    printf( "\n\n" );
+    // Distance to node 0: 0
+    // Distance to node 1: 7
+    // Distance to node 2: 3
+    // Distance to node 3: 9
+    // Node 4 is not reached
+    // Path to node 3: 0 2 1 3
+    
+    // scratch is reused by next query
+    ds::orgraph::csr_view<int,int> csr = ds::orgraph::freeze( og );
+    auto csr_graph = ds::orgraph::adapt( csr );
+    ds::orgraph::dijkstra( csr_graph, csr.find( n[2] )->index(), weight, scratch );
+    printf( "From node 2: to node 3 %g, node 0 is reached %d\n\n",
+            scratch.distance( csr.find( n[3] )->index() ),
+            (int)scratch.reached( csr.find( n[0] )->index() ) );
+    // From node 2: to node 3 6, node 0 is reached 0
+    
+    // scratch is reusable after query, which threw with vertices in heap
+    ds::orgraph::orgraph<int,int> neg;
+    auto m0 = neg.add_node( 0 );
+    auto m1 = neg.add_node( 1 );
+    auto m2 = neg.add_node( 2 );
+    neg.add_edge( 1, m0, m1 );
+    neg.add_edge( 5, m0, m2 );
+    neg.add_edge( -3, m1, m2 );
+    auto neg_graph = ds::orgraph::adapt( neg );
+    try
+    {
+        ds::orgraph::dijkstra( neg_graph, neg_graph.vertex( m0 ), weight, scratch );
+    } catch ( const std::invalid_argument& ia )
+    {
+        printf( "Invalid argument: %s\n", ia.what() );
+    }
+    ds::orgraph::orgraph<int,int> pair;
+    auto p0 = pair.add_node( 0 );
+    auto p1 = pair.add_node( 1 );
+    pair.add_edge( 4, p0, p1 );
+    auto pair_graph = ds::orgraph::adapt( pair );
+    ds::orgraph::dijkstra( pair_graph, pair_graph.vertex( p0 ), weight, scratch );
+    printf( "After error: distance %g\n\n", scratch.distance( pair_graph.vertex( p1 ) ) );
+    // Invalid argument: edge weight is negative
+    // After error: distance 4
+    
+    // delta-stepping gives the same distances as Dijkstra on big graph
+    ds::orgraph::orgraph<int,int> big;
+    std::vector< ds::orgraph::node_ref<int,int> > bn;
+    const int num_big = 5000;
+    for ( int i = 0; i < num_big; i++ )
+    {
+        bn.push_back( big.add_node( i ) );
+    }
+    uint32_t seed = 7;
+    for ( int i = 0; i < num_big * 6; i++ )
+    {
+        seed = seed * 1103515245 + 12345;
+        int from = ( seed >> 8 ) % num_big;
+        seed = seed * 1103515245 + 12345;
+        int to = ( seed >> 8 ) % num_big;
+        seed = seed * 1103515245 + 12345;
+        big.add_edge( 1 + ( seed >> 8 ) % 100, bn[from], bn[to] );
+    }
+    ds::orgraph::csr_view<int,int> big_csr = ds::orgraph::freeze( big );
+    auto big_graph = ds::orgraph::adapt( big_csr );
+    auto int_weight = []( const int& edge ) { return (int64_t)edge; };
+    
+    ds::orgraph::shortest_path_scratch<int64_t> dijkstra_scratch;
+    ds::orgraph::shortest_path_scratch<int64_t> delta_scratch;
+    ds::thread_pool::thread_pool pool( 4 );
+    
+    bool match = true;
+    for ( int32_t source = 0; source < 3; source++ )
+    {
+        ds::orgraph::dijkstra( big_graph, source, int_weight, dijkstra_scratch );
+        ds::orgraph::delta_stepping( big_graph, source, int_weight, (int64_t)50, delta_scratch, &pool );
+        for ( int32_t v = 0; v < num_big; v++ )
+        {
+            match = match && ( dijkstra_scratch.distance( v ) == delta_scratch.distance( v ) );
+        }
+    }
+    printf( "Delta-stepping matches Dijkstra: %d\n", (int)match );
+    // Delta-stepping matches Dijkstra: 1
+    
+    // astar with zero heuristic is dijkstra with target
+    bool astar_match = true;
+    for ( int32_t target = 0; target < 200; target++ )
+    {
+        ds::orgraph::astar( big_graph, 0, target, int_weight, []( int32_t ) { return (int64_t)0; }, delta_scratch );
+        ds::orgraph::dijkstra( big_graph, 0, int_weight, dijkstra_scratch, target );
+        astar_match = astar_match && ( dijkstra_scratch.distance( target ) == delta_scratch.distance( target ) );
+    }
+    printf( "A* matches Dijkstra: %d\n", (int)astar_match );
+    // A* matches Dijkstra: 1
+    
+    return 0;
+}
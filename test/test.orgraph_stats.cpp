@@ -0,0 +1,49 @@
+#define STATS_DS_ORGRAPH
+
+#include <stdio.h>
+
+#include "orgraph.hpp"
+
+int main( void )
+{
+    ds::orgraph::orgraph<int,int,ds::orgraph::slot_map_storage> og;
+    auto hub = og.add_node( 0 );
+    for ( int i = 1; i <= 8; i++ )
+    {
+        og.add_edge( i, hub, og.add_node( i ) );
+    }
+
+    // hub adjacency outgrows inline ids: 4 -> 8 ids
+    ds::orgraph::orgraph_stats stats = ds::orgraph::get_stats();
+    printf( "Adjacency allocations: %d of %d bytes\n",
+            (int)stats.adjacency_allocations, (int)stats.adjacency_bytes );
+
+    ds::orgraph::reset_stats();
+    og.find_node( 5 );
+    og.find_nodes( 7 );
+    stats = ds::orgraph::get_stats();
+    printf( "Scans: %d, scanned: %d\n", (int)stats.find_scans, (int)stats.find_scanned );
+
+    ds::orgraph::reset_stats();
+    int sum = 0;
+    for ( auto e : hub.succ_edges() )
+    {
+        sum += *e;
+    }
+    stats = ds::orgraph::get_stats();
+    printf( "Ref vectors: %d, lookups: %d, sum %d\n", (int)stats.ref_vectors, (int)stats.lookups, sum );
+
+    ds::orgraph::reset_stats();
+    for ( auto e : hub.succ_edges_range() )
+    {
+        sum += *e;
+    }
+    stats = ds::orgraph::get_stats();
+    printf( "Ref vectors of range: %d\n", (int)stats.ref_vectors );
+    // Adjacency allocations: 1 of 64 bytes
+    // Scans: 2, scanned: 15
+    // Ref vectors: 1, lookups: 17, sum 36
+    // Ref vectors of range: 0
+
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+
+#include "orgraph_topological_sort.hpp"
+
+template <typename Ttopo>
+void print_order( const Ttopo& topo )
+{
+    printf( "Order:" );
+    for ( auto cur_node_ref : topo.order() )
+    {
+        printf( " %s", ( *cur_node_ref ).c_str() );
+    }
+    printf( "\n" );
+    return;
+}
+
+int main( void )
+{
+    ds::orgraph::orgraph<std::string,int> og;
+    
+    auto a = og.add_node( "a" );
+    auto b = og.add_node( "b" );
+    auto c = og.add_node( "c" );
+    auto d = og.add_node( "d" );
+    auto cb = og.add_edge( 0, c, b );
+    og.add_edge( 0, b, a );
+    
+    auto order = ds::orgraph::topological_sort( ds::orgraph::adapt( og ) );
+    printf( "Sorted:" );
+    for ( auto v : *order )
+    {
+        printf( " %s", ( *ds::orgraph::adapt( og ).node( v ) ).c_str() );
+    }
+    printf( "\n\n" );
+    // Sorted: c d b a
+    
+    ds::orgraph::incremental_topological_order<std::string,int> topo( og );
+    print_order( topo );
+    // Order: c b a d
+    
+    og.add_edge( 0, d, c );
+    print_order( topo );
+    // Order: d c b a
+    
+    // a -> d closes cycle a -> d -> c -> b -> a
+    printf( "Would close cycle: %d\n", (int)topo.would_close_cycle( a, d ) );
+    printf( "Rejected: %d\n", (int)!topo.try_add_edge( 0, a, d ) );
+    printf( "Edges: %d\n\n", (int)og.edges().size() );
+    // Would close cycle: 1
+    // Rejected: 1
+    // Edges: 3
+    
+    // edge added to graph directly is reported
+    auto cycle_edge = og.add_edge( 1, a, c );
+    printf( "Acyclic: %d, cycle edges: %d\n", (int)topo.is_acyclic(), (int)topo.cycle_edges().size() );
+    printf( "Sort finds cycle: %d\n",
+            (int)!ds::orgraph::topological_sort( ds::orgraph::adapt( og ) ) );
+    // Acyclic: 0, cycle edges: 1
+    // Sort finds cycle: 1
+    
+    // removing edge of cycle accepts reported edge
+    og.remove_edge( cb );
+    printf( "Acyclic: %d, a before c: %d\n", (int)topo.is_acyclic(), (int)topo.precedes( a, c ) );
+    print_order( topo );
+    printf( "\n" );
+    // Acyclic: 1, a before c: 1
+    // Order: d b a c
+    
+    // removing reported edge just forgets it
+    og.add_edge( 2, c, b );
+    printf( "Cycle edges: %d\n", (int)topo.cycle_edges().size() );
+    og.remove_edge( cycle_edge );
+    printf( "Cycle edges: %d\n", (int)topo.cycle_edges().size() );
+    og.remove_node( d );
+    print_order( topo );
+    // Cycle edges: 1
+    // Cycle edges: 0
+    // Order: c b a
+    
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include <stdio.h>
+
+#include "orgraph_traversal.hpp"
+
+int main( void )
+{
+    ds::orgraph::orgraph<int,int> og;
+    
+    std::vector< ds::orgraph::node_ref<int,int> > n;
+    for ( int i = 0; i < 6; i++ )
+    {
+        n.push_back( og.add_node( i ) );
+    }
+    og.add_edge( 1, n[0], n[1] );
+    og.add_edge( 1, n[0], n[2] );
+    og.add_edge( 1, n[1], n[3] );
+    og.add_edge( 1, n[2], n[3] );
+    og.add_edge( 1, n[3], n[4] );
+    og.add_edge( 1, n[4], n[0] );
+    
+    auto graph = ds::orgraph::adapt( og );
+    ds::orgraph::bfs( graph, graph.vertex( n[0] ),
+                      [&]( int32_t v, int32_t parent, int32_t level )
+                      {
+                          printf( "Visited node %d from %d at level %d\n",
+                                  *graph.node( v ), ( parent < 0 ) ? -1 : *graph.node( parent ), level );
+                      } );
+    printf( "\n" );
+    // Visited node 0 from -1 at level 0
+    // Visited node 1 from 0 at level 1
+    // Visited node 2 from 0 at level 1
+    // Visited node 3 from 1 at level 2
+    // Visited node 4 from 3 at level 3
+    
+    ds::orgraph::csr_view<int,int> csr = ds::orgraph::freeze( og );
+    auto csr_graph = ds::orgraph::adapt( csr );
+    std::vector<int32_t> levels = ds::orgraph::bfs_levels( csr_graph, csr.find( n[3] )->index() );
+    for ( auto l : levels )
+    {
+        printf( "Level from node 3: %d\n", l );
+    }
+    printf( "\n" );
+    // Level from node 3: 2
+    // Level from node 3: 3
+    // Level from node 3: 3
+    // Level from node 3: 0
+    // Level from node 3: 1
+    // Level from node 3: -1
+    
+    // big graph: parallel direction-optimizing search gives the same levels as serial one
+    ds::orgraph::orgraph<int,int> big;
+    std::vector< ds::orgraph::node_ref<int,int> > bn;
+    const int num_big = 20000;
+    for ( int i = 0; i < num_big; i++ )
+    {
+        bn.push_back( big.add_node( i ) );
+    }
+    uint32_t seed = 1;
+    for ( int i = 0; i < num_big * 8; i++ )
+    {
+        seed = seed * 1103515245 + 12345;
+        int from = ( seed >> 8 ) % num_big;
+        seed = seed * 1103515245 + 12345;
+        int to = ( seed >> 8 ) % num_big;
+        big.add_edge( 1, bn[from], bn[to] );
+    }
+    
+    ds::orgraph::csr_view<int,int> big_csr = ds::orgraph::freeze( big );
+    ds::thread_pool::thread_pool pool( 4 );
+    
+    ds::orgraph::bfs_options serial_options;
+    serial_options.direction_optimizing = false;
+    ds::orgraph::bfs_options parallel_options;
+    parallel_options.pool_p = &pool;
+    
+    std::vector<int32_t> serial_levels =
+        ds::orgraph::bfs_levels( ds::orgraph::adapt( big ), 0, serial_options );
+    std::vector<int32_t> parallel_levels =
+        ds::orgraph::bfs_levels( ds::orgraph::adapt( big_csr ), 0, parallel_options );
+    printf( "Levels match: %d\n", (int)( serial_levels == parallel_levels ) );
+    // Levels match: 1
+    
+    return 0;
+}
@@ -12,3 +12,48 @@ g++ -g -Og -std=c++17 -I$PROJECT_PATH/.. -o test.vector2d.bin ./test.vector2d.cp
 
 g++ -g -Og -std=c++17 -I$PROJECT_PATH/.. -o test.orgraph.bin ./test.orgraph.cpp
 ./test.orgraph.bin
+
+g++ -g -Og -std=c++17 -I$PROJECT_PATH/.. -o test.orgraph_csr.bin ./test.orgraph_csr.cpp
+./test.orgraph_csr.bin
+
+g++ -g -Og -std=c++17 -pthread -I$PROJECT_PATH/.. -o test.orgraph_traversal.bin ./test.orgraph_traversal.cpp
+./test.orgraph_traversal.bin
+
+g++ -g -Og -std=c++17 -pthread -I$PROJECT_PATH/.. -o test.orgraph_shortest_path.bin ./test.orgraph_shortest_path.cpp
+./test.orgraph_shortest_path.bin
+
+g++ -g -Og -std=c++17 -I$PROJECT_PATH/.. -o test.orgraph_topological_sort.bin ./test.orgraph_topological_sort.cpp
+./test.orgraph_topological_sort.bin
+
+g++ -g -Og -std=c++17 -pthread -I$PROJECT_PATH/.. -o test.orgraph_concurrent.bin ./test.orgraph_concurrent.cpp
+./test.orgraph_concurrent.bin
+
+g++ -g -Og -std=c++17 -I$PROJECT_PATH/.. -o test.orgraph_serialization.bin ./test.orgraph_serialization.cpp
+./test.orgraph_serialization.bin
+
+g++ -g -Og -std=c++17 -pthread -I$PROJECT_PATH/.. -o test.orgraph_ingest.bin ./test.orgraph_ingest.cpp
+./test.orgraph_ingest.bin
+
+g++ -g -Og -std=c++17 -pthread -I$PROJECT_PATH/.. -o test.orgraph_scc.bin ./test.orgraph_scc.cpp
+./test.orgraph_scc.bin
+
+g++ -g -Og -std=c++17 -I$PROJECT_PATH/.. -o test.orgraph_changelog.bin ./test.orgraph_changelog.cpp
+./test.orgraph_changelog.bin
+
+g++ -g -Og -std=c++17 -I$PROJECT_PATH/.. -o test.orgraph_reorder.bin ./test.orgraph_reorder.cpp
+./test.orgraph_reorder.bin
+
+g++ -g -Og -std=c++17 -I$PROJECT_PATH/.. -o test.orgraph_stats.bin ./test.orgraph_stats.cpp
+./test.orgraph_stats.bin
+
+g++ -g -Og -std=c++17 -I$PROJECT_PATH/.. -o test.vector2d_simd.bin ./test.vector2d_simd.cpp
+./test.vector2d_simd.bin
+
+g++ -g -Og -std=c++17 -pthread -I$PROJECT_PATH/.. -o test.vector2d_parallel.bin ./test.vector2d_parallel.cpp
+./test.vector2d_parallel.bin
+
+g++ -g -Og -std=c++17 -I$PROJECT_PATH/.. -o test.vector2d_sparse.bin ./test.vector2d_sparse.cpp
+./test.vector2d_sparse.bin
+
+g++ -g -Og -std=c++17 -I$PROJECT_PATH/.. -o test.orgraph_grid.bin ./test.orgraph_grid.cpp
+./test.orgraph_grid.bin
@@ -18,6 +18,69 @@ void Set( ds::vector2d::vector2d<int> &v, int32_t x, int32_t y, int val )
     return;
 }
 
+template <typename Tlayout>
+void FillLayout( ds::vector2d::vector2d<int,Tlayout> &v )
+{
+    for ( int32_t y = 0; y < v.size().y; y++ )
+    {
+        for ( int32_t x = 0; x < v.size().x; x++ )
+        {
+            v( x, y ) = 10 * y + x;
+        }
+    }
+    return;
+}
+
+template <typename Tlayout>
+void PrintLayout( const char *name_p, const ds::vector2d::vector2d<int,Tlayout> &v )
+{
+    printf( "%s:", name_p );
+    for ( auto val : v )
+    {
+        printf( " %d", val );
+    }
+    printf( "\n" );
+    return;
+}
+
+/**
+ * Resizes grid of Tlayout and row major grid randomly, compares all elements.
+ */
+template <typename Tlayout>
+bool ResizesMatch()
+{
+    ds::vector2d::vector2d<int,Tlayout> grid( 0, 0 );
+    ds::vector2d::vector2d<int> expected( 0, 0 );
+    uint32_t seed = 11;
+    int next_value = 1;
+    bool same = true;
+    for ( int step = 0; step < 100; step++ )
+    {
+        seed = seed * 1103515245 + 12345;
+        ds::vector2d::point2d new_size( ( seed >> 8 ) % 13, ( seed >> 16 ) % 11 );
+        grid.resize( new_size );
+        expected.resize( new_size );
+        int count = 0;
+        for ( auto it = grid.begin(); it != grid.end(); ++it )
+        {
+            count++;
+        }
+        same &= ( count == new_size.x * new_size.y );
+        for ( int32_t y = 0; y < new_size.y; y++ )
+        {
+            for ( int32_t x = 0; x < new_size.x; x++ )
+            {
+                same &= ( grid( x, y ) == expected( x, y ) );
+                if ( 0 == step % 2 )
+                {
+                    grid( x, y ) = expected( x, y ) = next_value++;
+                }
+            }
+        }
+    }
+    return same;
+}
+
 int main( void )
 {
     ds::vector2d::vector2d<int> v(3,2);
@@ -35,6 +98,240 @@ int main( void )
     {
         printf( "    %d\n", val );
     }
+    // Out of Range error at(2,2): index (2,2) is out of size (3,2)
+    // Values of vector2d:
+    //     0
+    //     2
+    //     4
+    //     1
+    //     3
+    //     5
+    
+    // stencil over rows: every inner cell gets sum of its row neighbours
+    ds::vector2d::vector2d<float> grid( 5, 3 );
+    for ( int32_t y = 0; y < grid.size().y; y++ )
+    {
+        ds::vector2d::row_span<float> cur_row = grid.row( y );
+        for ( int32_t x = 0; x < cur_row.size(); x++ )
+        {
+            cur_row[x] = (float)( 10 * y + x );
+        }
+    }
+    ds::vector2d::vector2d<float> sums( grid.size() );
+    for ( int32_t y = 0; y < grid.size().y; y++ )
+    {
+        const ds::vector2d::vector2d<float>& cgrid = grid;
+        ds::vector2d::row_span<const float> in = cgrid.row_unchecked( y );
+        ds::vector2d::row_span<float> out = sums.row_unchecked( y );
+        for ( int32_t x = 1; x + 1 < in.size(); x++ )
+        {
+            out[x] = in[x - 1] + in[x + 1];
+        }
+    }
+    printf( "Sums of row 2:" );
+    for ( auto val : sums.row( 2 ) )
+    {
+        printf( " %g", val );
+    }
+    printf( "\n" );
+    
+    // raw storage with stride
+    const float *raw_p = grid.data();
+    printf( "Stride %d, cell (3,1) is %g, unchecked %g\n",
+            grid.stride(), raw_p[ 1 * grid.stride() + 3 ], grid.at_unchecked( 3, 1 ) );
+    try
+    {
+        grid.row( 3 );
+    } catch ( const std::out_of_range& oor )
+    {
+        printf( "Out of Range error: %s\n", oor.what() );
+    }
+    // Sums of row 2: 0 42 44 46 0
+    // Stride 5, cell (3,1) is 13, unchecked 13
+    // Out of Range error: row 3 is out of size (5,3)
+    
+    // resize keeps elements inside both sizes, new ones are empty
+    ds::vector2d::vector2d<std::string> names( 3, 2 );
+    for ( int32_t y = 0; y < 2; y++ )
+    {
+        for ( int32_t x = 0; x < 3; x++ )
+        {
+            names( x, y ) = std::to_string( 10 * y + x );
+        }
+    }
+    names.reserve( ds::vector2d::point2d( 4, 4 ) );
+    names.resize( 4, 3 );
+    names.resize( 2, 4 );
+    printf( "Resized size %s:\n", ( (std::string)names.size() ).c_str() );
+    for ( int32_t y = 0; y < names.size().y; y++ )
+    {
+        printf( "   " );
+        for ( auto cur_name : names.row( y ) )
+        {
+            printf( " [%s]", cur_name.c_str() );
+        }
+        printf( "\n" );
+    }
+    // Resized size (2,4):
+    //     [0] [1]
+    //     [10] [11]
+    //     [] []
+    //     [] []
+    
+    // random resizes with and without reserved capacity match copying by hand
+    ds::vector2d::vector2d<int> grown( 0, 0 );
+    int32_t next_value = 1;
+    uint32_t seed = 7;
+    bool same = true;
+    for ( int step = 0; step < 200; step++ )
+    {
+        seed = seed * 1103515245 + 12345;
+        ds::vector2d::point2d new_size( ( seed >> 8 ) % 9, ( seed >> 16 ) % 9 );
+        if ( 0 == step % 3 )
+        {
+            grown.reserve( ds::vector2d::point2d( 8, 8 ) );
+        }
+        
+        ds::vector2d::vector2d<int> expected( new_size );
+        for ( int32_t y = 0; y < std::min( new_size.y, grown.size().y ); y++ )
+        {
+            for ( int32_t x = 0; x < std::min( new_size.x, grown.size().x ); x++ )
+            {
+                expected( x, y ) = grown( x, y );
+            }
+        }
+        grown.resize( new_size );
+        same &= ( grown.size() == new_size );
+        for ( int32_t y = 0; y < new_size.y; y++ )
+        {
+            for ( int32_t x = 0; x < new_size.x; x++ )
+            {
+                same &= ( grown( x, y ) == expected( x, y ) );
+                if ( 0 == grown( x, y ) )
+                {
+                    grown( x, y ) = next_value++;
+                }
+            }
+        }
+    }
+    printf( "Random resizes are right: %d\n", (int)same );
+    // Random resizes are right: 1
+    
+    // layouts keep indexing by positions, iterators go in storage order
+    ds::vector2d::vector2d<int,ds::vector2d::column_major> by_columns( 3, 2 );
+    ds::vector2d::vector2d<int,ds::vector2d::tiled<2>> by_tiles( 3, 3 );
+    ds::vector2d::vector2d<int,ds::vector2d::morton> by_z( 4, 2 );
+    FillLayout( by_columns );
+    FillLayout( by_tiles );
+    FillLayout( by_z );
+    PrintLayout( "Column major", by_columns );
+    PrintLayout( "Tiles 2x2", by_tiles );
+    PrintLayout( "Morton", by_z );
+    printf( "Tiled storage: %d elements, cell (2,1) is %d\n",
+            (int)by_tiles.layout().storage_size(), by_tiles( 2, 1 ) );
+    // Column major: 0 10 1 11 2 12
+    // Tiles 2x2: 0 1 10 11 2 12 20 21 22
+    // Morton: 0 1 10 11 2 3 12 13
+    // Tiled storage: 16 elements, cell (2,1) is 12
+    
+    // random resizes of every layout match row major
+    printf( "Random resizes of layouts are right: %d %d %d %d\n",
+            (int)ResizesMatch<ds::vector2d::column_major>(), (int)ResizesMatch<ds::vector2d::tiled<4,2>>(),
+            (int)ResizesMatch<ds::vector2d::tiled<8>>(), (int)ResizesMatch<ds::vector2d::morton>() );
+    // Random resizes of layouts are right: 1 1 1 1
+    
+    // views of rectangles share storage, views of views too
+    ds::vector2d::vector2d<int> canvas( 6, 5 );
+    FillLayout( canvas );
+    ds::vector2d::vector2d_view<int> roi = canvas.view( ds::vector2d::rect2d( ds::vector2d::point2d( 1, 1 ),
+                                                                              ds::vector2d::point2d( 4, 3 ) ) );
+    ds::vector2d::vector2d_view<int> inner = roi.subview( ds::vector2d::point2d( 1, 1 ), ds::vector2d::point2d( 2, 2 ) );
+    for ( auto& val : inner )
+    {
+        val = -val;
+    }
+    ds::vector2d::vector2d_view<const int> whole = canvas;
+    printf( "View %s of stride %d, roi(1,1) is %d, inner row 1:",
+            ( (std::string)roi.size() ).c_str(), roi.stride(), roi( 1, 1 ) );
+    for ( auto val : inner.row( 1 ) )
+    {
+        printf( " %d", val );
+    }
+    printf( "\n" );
+    printf( "Canvas row 2:" );
+    for ( auto val : whole.row( 2 ) )
+    {
+        printf( " %d", val );
+    }
+    printf( "\n" );
+    try
+    {
+        roi.subview( ds::vector2d::point2d( 2, 2 ), ds::vector2d::point2d( 3, 1 ) );
+    } catch ( const std::out_of_range& oor )
+    {
+        printf( "Out of Range error: %s\n", oor.what() );
+    }
+    try
+    {
+        inner( 2, 0 );
+    } catch ( const std::out_of_range& oor )
+    {
+        printf( "Out of Range error: %s\n", oor.what() );
+    }
+    int view_count = 0;
+    for ( auto val : roi.subview( ds::vector2d::point2d( 0, 3 ), ds::vector2d::point2d( 4, 0 ) ) )
+    {
+        view_count += val;
+    }
+    printf( "Elements of empty view: %d\n", view_count );
+    int corner_count = 0;
+    int corner_sum = 0;
+    // bottom of view is last row of storage, so rows end before end of storage
+    ds::vector2d::vector2d_view<int> corner = canvas.view( ds::vector2d::rect2d( ds::vector2d::point2d( 3, 3 ),
+                                                                                 ds::vector2d::point2d( 3, 2 ) ) );
+    for ( auto val : corner )
+    {
+        corner_count++;
+        corner_sum += val;
+    }
+    printf( "Elements of bottom right view: %d, sum: %d\n", corner_count, corner_sum );
+    // View (4,3) of stride 6, roi(1,1) is -22, inner row 1: -32 -33
+    // Canvas row 2: 20 21 -22 -23 24 25
+    // Out of Range error: rect (2,2)+(3,1) is out of size (4,3)
+    // Out of Range error: index (2,0) is out of size (2,2)
+    // Elements of empty view: 0
+    // Elements of bottom right view: 6, sum: 168
+    
+    // construction without initialization, with fill value and from buffer
+    ds::vector2d::vector2d<int> raw( 4, 3, ds::vector2d::default_init );
+    FillLayout( raw );
+    ds::vector2d::vector2d<std::string> filled( ds::vector2d::point2d( 2, 2 ), std::string( "ab" ) );
+    filled.resize( 3, 2 );
+    printf( "Raw (3,2) is %d, filled: [%s] [%s] [%s]\n",
+            raw( 3, 2 ), filled( 0, 0 ).c_str(), filled( 1, 1 ).c_str(), filled( 2, 1 ).c_str() );
+    
+    ds::vector2d::vector2d<int>::storage_type buffer;
+    for ( int i = 0; i < 6; i++ )
+    {
+        buffer.push_back( i );
+    }
+    const int *buffer_p = buffer.data();
+    ds::vector2d::vector2d<int> adopted( ds::vector2d::point2d( 3, 2 ), std::move( buffer ) );
+    printf( "Adopted (2,1) is %d, same memory: %d\n", adopted( 2, 1 ), (int)( adopted.data() == buffer_p ) );
+    ds::vector2d::vector2d<int>::storage_type released = adopted.release();
+    printf( "Released %d elements, same memory: %d, size left %s\n", (int)released.size(),
+            (int)( released.data() == buffer_p ), ( (std::string)adopted.size() ).c_str() );
+    try
+    {
+        ds::vector2d::vector2d<int> wrong( ds::vector2d::point2d( 2, 2 ), std::move( released ) );
+    } catch ( const std::invalid_argument& ia )
+    {
+        printf( "Invalid argument: %s\n", ia.what() );
+    }
+    // Raw (3,2) is 23, filled: [ab] [ab] []
+    // Adopted (2,1) is 5, same memory: 1
+    // Released 6 elements, same memory: 1, size left (0,0)
+    // Invalid argument: buffer of 6 elements doesn't fit size (2,2)
     
     return 0;
 }
@@ -0,0 +1,189 @@
+#include <atomic>
+#include <vector>
+#include <stdexcept>
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "vector2d_parallel.hpp"
+
+using ds::vector2d::vector2d;
+using ds::vector2d::point2d;
+using ds::vector2d::rect2d;
+
+std::atomic<int> next_worker_id( 0 );
+
+int WorkerId()
+{
+    thread_local int id = next_worker_id++;
+    return id;
+}
+
+/**
+ * Element of size, which doesn't divide cache line.
+ */
+struct rgb
+{
+    int32_t r = 0;
+    int32_t g = 0;
+    int32_t b = 0;
+};
+
+int main( void )
+{
+    ds::thread_pool::thread_pool pool( 4 );
+    
+    // every element is visited once
+    vector2d<int> image( 300, 200 );
+    ds::vector2d::parallel_for( &pool, image,
+                                [&]( const point2d& pos, int& value )
+                                {
+                                    value += 1000 * pos.y + pos.x + 1;
+                                } );
+    bool right = true;
+    for ( int32_t y = 0; y < image.size().y; y++ )
+    {
+        for ( int32_t x = 0; x < image.size().x; x++ )
+        {
+            right &= ( image( x, y ) == 1000 * y + x + 1 );
+        }
+    }
+    printf( "Filled in parallel: %d\n", (int)right );
+    
+    // cache lines of storage are written by one worker each
+    vector2d<int32_t> owner( 301, 97 );
+    ds::vector2d::parallel_for( &pool, owner, rect2d( point2d( 3, 1 ), point2d( 298, 95 ) ),
+                                [&]( const point2d& pos, int32_t& value )
+                                {
+                                    // some work, so every worker gets chunks
+                                    volatile int32_t work = pos.x;
+                                    for ( int i = 0; i < 200; i++ )
+                                    {
+                                        work = work + i;
+                                    }
+                                    value = WorkerId() + 1;
+                                } );
+    bool one_owner = true;
+    int32_t line_owner = 0;
+    for ( size_t i = 0; i < owner.layout().storage_size(); i++ )
+    {
+        const int32_t *cur_p = owner.data() + i;
+        if ( 0 == reinterpret_cast<uintptr_t>( cur_p ) % 64 )
+        {
+            line_owner = 0;
+        }
+        if ( 0 != *cur_p )
+        {
+            one_owner &= ( 0 == line_owner || *cur_p == line_owner );
+            line_owner = *cur_p;
+        }
+    }
+    printf( "Cache lines written by one worker: %d\n", (int)one_owner );
+    
+    // the same for elements crossing cache lines
+    vector2d<rgb> pixels( 301, 97 );
+    ds::vector2d::parallel_for( &pool, pixels,
+                                [&]( const point2d& pos, rgb& value )
+                                {
+                                    volatile int32_t work = pos.x;
+                                    for ( int i = 0; i < 200; i++ )
+                                    {
+                                        work = work + i;
+                                    }
+                                    value.r = WorkerId() + 1;
+                                } );
+    const uintptr_t first_line = reinterpret_cast<uintptr_t>( pixels.data() ) / 64;
+    std::vector<int32_t> owners( pixels.layout().storage_size() * sizeof( rgb ) / 64 + 2, 0 );
+    bool one_pixel_owner = true;
+    for ( size_t i = 0; i < pixels.layout().storage_size(); i++ )
+    {
+        const uintptr_t begin = reinterpret_cast<uintptr_t>( pixels.data() + i );
+        for ( uintptr_t cur_line = begin / 64; cur_line <= ( begin + sizeof( rgb ) - 1 ) / 64; cur_line++ )
+        {
+            int32_t& cur_owner = owners[cur_line - first_line];
+            one_pixel_owner &= ( 0 == cur_owner || pixels.data()[i].r == cur_owner );
+            cur_owner = pixels.data()[i].r;
+        }
+    }
+    printf( "Cache lines of 12-byte elements written by one worker: %d\n", (int)one_pixel_owner );
+    // Filled in parallel: 1
+    // Cache lines written by one worker: 1
+    // Cache lines of 12-byte elements written by one worker: 1
+    
+    // rectangle of tiled layout
+    vector2d<int,ds::vector2d::tiled<8>> tiles( 100, 90 );
+    ds::vector2d::parallel_for( &pool, tiles, rect2d( point2d( 10, 20 ), point2d( 50, 30 ) ),
+                                [&]( const point2d&, int& value )
+                                {
+                                    value++;
+                                } );
+    int inside = 0;
+    int outside = 0;
+    for ( int32_t y = 0; y < tiles.size().y; y++ )
+    {
+        for ( int32_t x = 0; x < tiles.size().x; x++ )
+        {
+            const bool in_rect = ( x >= 10 && x < 60 && y >= 20 && y < 50 );
+            ( in_rect ? inside : outside ) += tiles( x, y );
+        }
+    }
+    printf( "Rect of tiles: %d inside, %d outside\n", inside, outside );
+    
+    // transform between layouts and read-only pass
+    vector2d<int,ds::vector2d::morton> squares( image.size() );
+    ds::vector2d::transform( &pool, image, squares,
+                             []( int value )
+                             {
+                                 return ( value % 100 ) * ( value % 100 );
+                             } );
+    std::atomic<int64_t> total( 0 );
+    ds::vector2d::parallel_for( &pool, (const vector2d<int,ds::vector2d::morton>&)squares,
+                                [&]( const point2d&, const int& value )
+                                {
+                                    total += value;
+                                } );
+    int64_t expected = 0;
+    for ( auto value : image )
+    {
+        expected += ( value % 100 ) * ( value % 100 );
+    }
+    printf( "Transform sum is right: %d, squares(5,3) = %d\n", (int)( total == expected ), squares( 5, 3 ) );
+    
+    // without pool
+    vector2d<float> small( 5, 3 );
+    ds::vector2d::transform( nullptr, small, rect2d( point2d( 1, 1 ), point2d( 3, 2 ) ), small,
+                             []( float value )
+                             {
+                                 return value + 0.5f;
+                             } );
+    printf( "Inline:" );
+    for ( auto value : small )
+    {
+        printf( " %g", value );
+    }
+    printf( "\n" );
+    // Rect of tiles: 1500 inside, 0 outside
+    // Transform sum is right: 1, squares(5,3) = 36
+    // Inline: 0 0 0 0 0 0 0.5 0.5 0.5 0 0 0.5 0.5 0.5 0
+    
+    // errors
+    try
+    {
+        ds::vector2d::parallel_for( &pool, small, rect2d( point2d( 2, 0 ), point2d( 4, 1 ) ),
+                                    []( const point2d&, float& ) {} );
+    } catch ( const std::out_of_range& oor )
+    {
+        printf( "Out of Range error: %s\n", oor.what() );
+    }
+    try
+    {
+        ds::vector2d::transform( &pool, small, image, []( float value ) { return (int)value; } );
+    } catch ( const std::invalid_argument& ia )
+    {
+        printf( "Invalid argument: %s\n", ia.what() );
+    }
+    // Out of Range error: rect (2,0)+(4,1) is out of size (5,3)
+    // Invalid argument: size (300,200) differs from size (5,3)
+    
+    return 0;
+}
@@ -0,0 +1,185 @@
+#include <vector>
+#include <stdexcept>
+
+#include <stdio.h>
+
+#include "vector2d_simd.hpp"
+
+using ds::vector2d::vector2d;
+using ds::vector2d::simd_isa;
+
+template <typename T>
+vector2d<T> Make( int32_t x, int32_t y, int seed )
+{
+    vector2d<T> out( x, y );
+    for ( int32_t j = 0; j < y; j++ )
+    {
+        for ( int32_t i = 0; i < x; i++ )
+        {
+            // integer values, so float results don't depend on order of additions
+            out( i, j ) = (T)( ( ( i * 7 + j * 13 + seed ) % 19 ) - 9 );
+        }
+    }
+    return out;
+}
+
+/**
+ * Runs every operation, returns all results as one array to compare.
+ */
+template <typename T>
+std::vector<double> RunAll( int32_t x, int32_t y )
+{
+    const auto a = Make<T>( x, y, 1 );
+    const auto b = Make<T>( x, y, 5 );
+    const auto c = Make<T>( x, y, 11 );
+    vector2d<T> out( x, y );
+    std::vector<double> results;
+    auto push_grid = [&]( const vector2d<T>& v )
+                     {
+                         for ( auto val : v )
+                         {
+                             results.push_back( (double)val );
+                         }
+                     };
+    auto push_vector = [&]( const auto& v )
+                       {
+                           for ( auto val : v )
+                           {
+                               results.push_back( (double)val );
+                           }
+                       };
+    
+    ds::vector2d::add( a, b, out );
+    push_grid( out );
+    ds::vector2d::subtract( a, b, out );
+    push_grid( out );
+    ds::vector2d::multiply( a, b, out );
+    push_grid( out );
+    ds::vector2d::elementwise_min( a, b, out );
+    push_grid( out );
+    ds::vector2d::elementwise_max( a, b, out );
+    push_grid( out );
+    ds::vector2d::scale( a, (T)3, out );
+    push_grid( out );
+    ds::vector2d::fma( a, b, c, out );
+    push_grid( out );
+    ds::vector2d::threshold( a, (T)2, (T)0, (T)1, out );
+    push_grid( out );
+    
+    results.push_back( (double)ds::vector2d::sum( a ) );
+    results.push_back( (double)ds::vector2d::min_value( a ) );
+    results.push_back( (double)ds::vector2d::max_value( a ) );
+    push_vector( ds::vector2d::row_sums( a ) );
+    push_vector( ds::vector2d::column_sums( a ) );
+    push_vector( ds::vector2d::row_min( a ) );
+    push_vector( ds::vector2d::row_max( a ) );
+    push_vector( ds::vector2d::column_min( b ) );
+    push_vector( ds::vector2d::column_max( b ) );
+    return results;
+}
+
+// active set is first asked by static initializer, before main
+const simd_isa initial_isa = ds::vector2d::active_simd_isa();
+
+int main( void )
+{
+    const simd_isa all_sets[] = { simd_isa::sse41, simd_isa::avx2, simd_isa::neon };
+    const ds::vector2d::point2d sizes[] = { { 1, 1 }, { 3, 5 }, { 8, 2 }, { 17, 9 }, { 64, 3 }, { 31, 33 } };
+    const simd_isa detected = initial_isa;
+    
+    // every supported set gives the same results as scalar code, including tails
+    bool all_match = true;
+    int checked = 0;
+    for ( const auto& size : sizes )
+    {
+        ds::vector2d::set_simd_isa( simd_isa::scalar );
+        const auto scalar_float = RunAll<float>( size.x, size.y );
+        const auto scalar_int = RunAll<int32_t>( size.x, size.y );
+        for ( auto isa : all_sets )
+        {
+            try
+            {
+                ds::vector2d::set_simd_isa( isa );
+            } catch ( const std::invalid_argument& )
+            {
+                continue;
+            }
+            if ( RunAll<float>( size.x, size.y ) != scalar_float || RunAll<int32_t>( size.x, size.y ) != scalar_int )
+            {
+                printf( "Mismatch of %s at size %s\n", ds::vector2d::simd_isa_name( isa ),
+                        ( (std::string)size ).c_str() );
+                all_match = false;
+            }
+        }
+        checked++;
+    }
+    ds::vector2d::set_simd_isa( detected );
+    printf( "Sizes checked: %d, all sets match scalar: %s\n", checked, all_match ? "yes" : "no" );
+    printf( "Detected set is active: %s\n", ( detected == ds::vector2d::detect_simd_isa() ) ? "yes" : "no" );
+    
+    // small example
+    vector2d<float> image( 5, 2 );
+    vector2d<float> weights( 5, 2 );
+    vector2d<float> bias( 5, 2 );
+    for ( int32_t y = 0; y < 2; y++ )
+    {
+        for ( int32_t x = 0; x < 5; x++ )
+        {
+            image( x, y ) = (float)( 10 * y + x );
+            weights( x, y ) = 2.0f;
+            bias( x, y ) = 0.5f;
+        }
+    }
+    ds::vector2d::fma( weights, image, bias, image );
+    printf( "Image:" );
+    for ( auto val : image )
+    {
+        printf( " %.1f", val );
+    }
+    printf( "\n" );
+    printf( "Sum: %.1f, min: %.1f, max: %.1f\n", ds::vector2d::sum( image ), ds::vector2d::min_value( image ),
+            ds::vector2d::max_value( image ) );
+    const auto rows = ds::vector2d::row_sums( image );
+    const auto columns = ds::vector2d::column_max( image );
+    printf( "Row sums: %.1f %.1f, column maxima: %.1f .. %.1f\n", rows[0], rows[1], columns[0], columns[4] );
+    
+    // wrapping of int32_t and 64-bit sum
+    vector2d<int32_t> big( 9, 1 );
+    for ( auto& val : big )
+    {
+        val = 2000000000;
+    }
+    vector2d<int32_t> doubled( 9, 1 );
+    ds::vector2d::add( big, big, doubled );
+    printf( "Sum: %lld, wrapped: %d\n", (long long)ds::vector2d::sum( big ), doubled( 8, 0 ) );
+    
+    // errors
+    try
+    {
+        ds::vector2d::add( image, weights, bias );
+        vector2d<float> other( 4, 2 );
+        ds::vector2d::add( image, other, image );
+    } catch ( const std::invalid_argument& ia )
+    {
+        printf( "Invalid argument: %s\n", ia.what() );
+    }
+    try
+    {
+        ds::vector2d::min_value( vector2d<int32_t>( 0, 3 ) );
+    } catch ( const std::invalid_argument& ia )
+    {
+        printf( "Invalid argument: %s\n", ia.what() );
+    }
+    printf( "Sum of empty: %lld\n", (long long)ds::vector2d::sum( vector2d<int32_t>( 0, 3 ) ) );
+    // Sizes checked: 6, all sets match scalar: yes
+    // Detected set is active: yes
+    // Image: 0.5 2.5 4.5 6.5 8.5 20.5 22.5 24.5 26.5 28.5
+    // Sum: 145.0, min: 0.5, max: 28.5
+    // Row sums: 22.5 122.5, column maxima: 20.5 .. 28.5
+    // Sum: 18000000000, wrapped: -294967296
+    // Invalid argument: size (4,2) differs from size (5,2)
+    // Invalid argument: vector2d of size (0,3) is empty
+    // Sum of empty: 0
+    
+    return 0;
+}
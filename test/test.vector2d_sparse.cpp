@@ -0,0 +1,70 @@
+#include <stdexcept>
+
+#include <stdio.h>
+
+#include "vector2d_sparse.hpp"
+
+using ds::vector2d::point2d;
+
+int main( void )
+{
+    // huge grid keeps only written tiles
+    ds::vector2d::sparse_vector2d<float> world( 1000000, 1000000, -1.0f );
+    world( 123456, 654321 ) = 5.0f;
+    world( 123457, 654321 ) = 6.0f;
+    world.set( point2d( 999999, 999999 ), 7.0f );
+    printf( "Tiles: %d, cells: %g %g %g, untouched: %g\n", (int)world.tile_count(),
+            world.get( point2d( 123456, 654321 ) ), world( 123457, 654321 ), world( 999999, 999999 ),
+            world.get( point2d( 5, 5 ) ) );
+    
+    // reads don't allocate
+    const ds::vector2d::sparse_vector2d<float>& cworld = world;
+    float sum = 0.0f;
+    for ( int32_t x = 0; x < 1000; x++ )
+    {
+        sum += cworld( x, 500000 );
+    }
+    printf( "Sum of untouched row part: %g, tiles: %d, contains (5,5): %d, contains (123500,654300): %d\n",
+            sum, (int)world.tile_count(), (int)world.contains( point2d( 5, 5 ) ),
+            (int)world.contains( point2d( 123500, 654300 ) ) );
+    // Tiles: 2, cells: 5 6 7, untouched: -1
+    // Sum of untouched row part: -1000, tiles: 2, contains (5,5): 0, contains (123500,654300): 1
+    
+    // iteration over allocated tiles is clipped to size
+    ds::vector2d::sparse_vector2d<int,4> small( 6, 5 );
+    small( 5, 4 ) = 3;
+    small( 0, 0 ) = 1;
+    int num_cells = 0;
+    int total = 0;
+    small.for_each( [&]( const point2d&, int& value )
+                    {
+                        num_cells++;
+                        total += value;
+                    } );
+    printf( "Cells of allocated tiles: %d, total %d\n", num_cells, total );
+    
+    // copies are deep, tiles of default values are freed by compact
+    ds::vector2d::sparse_vector2d<int,4> copy = small;
+    copy( 0, 0 ) = 100;
+    small( 5, 4 ) = 0;
+    const size_t num_freed = small.compact();
+    printf( "Original (0,0): %d, copy (0,0): %d, freed: %d, tiles left: %d\n",
+            small( 0, 0 ), copy( 0, 0 ), (int)num_freed, (int)small.tile_count() );
+    ds::vector2d::sparse_vector2d<int,4> moved = std::move( copy );
+    moved( 1, 1 ) = 2;
+    printf( "Moved (0,0): %d, (1,1): %d, tiles: %d\n", moved( 0, 0 ), moved( 1, 1 ), (int)moved.tile_count() );
+    // Cells of allocated tiles: 18, total 4
+    // Original (0,0): 1, copy (0,0): 100, freed: 1, tiles left: 1
+    // Moved (0,0): 100, (1,1): 2, tiles: 2
+    
+    try
+    {
+        world( 1000000, 0 ) = 1.0f;
+    } catch ( const std::out_of_range& oor )
+    {
+        printf( "Out of Range error: %s\n", oor.what() );
+    }
+    // Out of Range error: index (1000000,0) is out of size (1000000,1000000)
+    
+    return 0;
+}
@@ -0,0 +1,272 @@
+/**
+ * Thread pool.
+ */
+#pragma once
+
+/****************************************************************************************/
+
+/**
+ * Pool of workers running one job at a time on all of them.
+ * Calling thread takes part in every job as worker 0, so pool of size 1
+ * has no threads and runs everything inline.
+ *
+ * Usage:
+ *      ds::thread_pool::thread_pool pool( 4 );
+ *      pool.parallel_for( 0, n, 1024, [&]( int64_t begin, int64_t end, size_t worker )
+ *                                     {
+ *                                         ...
+ *                                     } );
+ *
+ * Note: jobs must not run other jobs of the same pool.
+ */
+
+/****************************************************************************************/
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+#include <algorithm>
+
+#include <stdint.h>
+
+/****************************************************************************************/
+
+namespace ds
+{
+    namespace thread_pool
+    {
+        /********************************************************************************/
+        
+        class thread_pool
+        {
+            /*****************************************************************************
+                                                Data
+            *****************************************************************************/
+        private:
+            std::vector<std::thread> m_threads;
+            
+            std::mutex              m_mutex;
+            std::condition_variable m_job_cv;
+            std::condition_variable m_done_cv;
+            
+            // job being run, is set once per run under mutex
+            const std::function<void( size_t )> *m_job_p = nullptr;
+            uint64_t                             m_job_generation = 0;
+            size_t                               m_num_running    = 0;
+            bool                                 m_stop           = false;
+            std::exception_ptr                   m_error;
+            
+            /*****************************************************************************
+                                             Inner methods
+            *****************************************************************************/
+        private:
+            void worker_loop( size_t worker )
+            {
+                uint64_t seen_generation = 0;
+                
+                for ( ;; )
+                {
+                    const std::function<void( size_t )> *job_p = nullptr;
+                    {
+                        std::unique_lock<std::mutex> lock( m_mutex );
+                        m_job_cv.wait( lock, [&]
+                                       {
+                                           return ( m_stop || m_job_generation != seen_generation );
+                                       } );
+                        if ( m_stop )
+                        {
+                            return;
+                        }
+                        seen_generation = m_job_generation;
+                        job_p = m_job_p;
+                    }
+                    
+                    run_guarded( *job_p, worker );
+                    
+                    {
+                        std::lock_guard<std::mutex> lock( m_mutex );
+                        m_num_running--;
+                        if ( 0 == m_num_running )
+                        {
+                            m_done_cv.notify_one();
+                        }
+                    }
+                }
+            }
+            
+            void run_guarded( const std::function<void( size_t )>& job, size_t worker )
+            {
+                try
+                {
+                    job( worker );
+                } catch ( ... )
+                {
+                    std::lock_guard<std::mutex> lock( m_mutex );
+                    if ( !m_error )
+                    {
+                        m_error = std::current_exception();
+                    }
+                }
+                return;
+            }
+            
+            /*****************************************************************************
+                                          Public interface
+            *****************************************************************************/
+        public:
+            /**
+             * Makes pool of num_workers workers, calling thread is one of them.
+             */
+            explicit thread_pool( size_t num_workers = std::thread::hardware_concurrency() )
+            {
+                num_workers = std::max<size_t>( num_workers, 1 );
+                m_threads.reserve( num_workers - 1 );
+                for ( size_t worker = 1; worker < num_workers; worker++ )
+                {
+                    m_threads.emplace_back( [this, worker] { worker_loop( worker ); } );
+                }
+            }
+            
+            thread_pool( const thread_pool& ) = delete;
+            thread_pool& operator=( const thread_pool& ) = delete;
+            
+            ~thread_pool()
+            {
+                {
+                    std::lock_guard<std::mutex> lock( m_mutex );
+                    m_stop = true;
+                }
+                m_job_cv.notify_all();
+                for ( auto& cur_thread : m_threads )
+                {
+                    cur_thread.join();
+                }
+            }
+            
+            /**
+             * Number of workers including calling thread.
+             */
+            size_t size() const
+            {
+                return m_threads.size() + 1;
+            }
+            
+            /**
+             * Runs job( worker ) on every worker, worker is in [0, size()).
+             * Returns when all workers are done. First exception thrown by job
+             * is rethrown here.
+             */
+            void run( const std::function<void( size_t )>& job )
+            {
+                if ( m_threads.empty() )
+                {
+                    job( 0 );
+                    return;
+                }
+                
+                {
+                    std::lock_guard<std::mutex> lock( m_mutex );
+                    m_job_p = &job;
+                    m_num_running = m_threads.size();
+                    m_error = nullptr;
+                    m_job_generation++;
+                }
+                m_job_cv.notify_all();
+                
+                run_guarded( job, 0 );
+                
+                std::exception_ptr error;
+                {
+                    std::unique_lock<std::mutex> lock( m_mutex );
+                    m_done_cv.wait( lock, [&] { return ( 0 == m_num_running ); } );
+                    m_job_p = nullptr;
+                    error = m_error;
+                    m_error = nullptr;
+                }
+                if ( error )
+                {
+                    std::rethrow_exception( error );
+                }
+                return;
+            }
+            
+            /**
+             * Splits [begin, end) into chunks of grain size and runs
+             * f( chunk_begin, chunk_end, worker ) for every chunk.
+             * Chunks are taken by workers dynamically, so uneven chunks are balanced.
+             */
+            template <typename Tfunc>
+            void parallel_for( int64_t begin, int64_t end, int64_t grain, Tfunc f )
+            {
+                if ( begin >= end )
+                {
+                    return;
+                }
+                grain = std::max<int64_t>( grain, 1 );
+                
+                if ( m_threads.empty() || end - begin <= grain )
+                {
+                    for ( int64_t cur = begin; cur < end; cur += grain )
+                    {
+                        f( cur, std::min( cur + grain, end ), (size_t)0 );
+                    }
+                    return;
+                }
+                
+                std::atomic<int64_t> next_chunk( begin );
+                run( [&]( size_t worker )
+                     {
+                         for ( ;; )
+                         {
+                             const int64_t cur = next_chunk.fetch_add( grain );
+                             if ( cur >= end )
+                             {
+                                 return;
+                             }
+                             f( cur, std::min( cur + grain, end ), worker );
+                         }
+                     } );
+                return;
+            }
+        };
+        
+        /********************************************************************************/
+        
+        /**
+         * Runs f( chunk_begin, chunk_end, worker ) over [begin, end) in pool
+         * or, if pool is nullptr, inline as worker 0.
+         */
+        template <typename Tfunc>
+        void parallel_for( thread_pool *pool_p, int64_t begin, int64_t end, int64_t grain, Tfunc f )
+        {
+            if ( nullptr == pool_p )
+            {
+                grain = std::max<int64_t>( grain, 1 );
+                for ( int64_t cur = begin; cur < end; cur += grain )
+                {
+                    f( cur, std::min( cur + grain, end ), (size_t)0 );
+                }
+                return;
+            }
+            
+            pool_p->parallel_for( begin, end, grain, f );
+            return;
+        }
+        
+        /**
+         * Number of workers of pool, 1 if pool is nullptr.
+         */
+        inline size_t workers_count( const thread_pool *pool_p )
+        {
+            return ( nullptr == pool_p ) ? 1 : pool_p->size();
+        }
+        
+        /********************************************************************************/
+    }
+}
+
+/****************************************************************************************/
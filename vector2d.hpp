@@ -6,8 +6,13 @@
 /****************************************************************************************/
 
 #include <vector>
+#include <memory>
+#include <new>
 #include <string>
 #include <stdexcept>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
 
 #include <iterator> // For std::forward_iterator_tag
 #include <cstddef>  // For std::ptrdiff_t
@@ -80,67 +85,642 @@ namespace ds
             return !( p0 != p1 );
         }
         
+        /**
+         * Rectangle of positions [origin, origin + size).
+         */
+        struct rect2d
+        {
+            point2d origin = point2d( 0, 0 );
+            point2d size   = point2d( 0, 0 );
+            
+            rect2d( const point2d& new_origin, const point2d& new_size ) : origin( new_origin ), size( new_size ) {}
+            
+            bool empty() const
+            {
+                return ( size.x <= 0 || size.y <= 0 );
+            }
+            
+            /**
+             * Rectangle is inside area [0, area_size).
+             */
+            bool inside( const point2d& area_size ) const
+            {
+                return ( origin.x >= 0 && origin.y >= 0 && size.x >= 0 && size.y >= 0 &&
+                         (int64_t)origin.x + size.x <= area_size.x && (int64_t)origin.y + size.y <= area_size.y );
+            }
+            
+            inline operator std::string() const
+            {
+                std::string out = (std::string)origin + "+" + (std::string)size;
+                return out;
+            }
+        };
+        
         /********************************************************************************/
         
         /**
-         * 2d vector.
+         * View of one row of vector2d, doesn't own memory.
+         * Is valid while vector2d is not resized.
          */
         template <typename T>
+        class row_span
+        {
+        private:
+            T       *m_data_p = nullptr;
+            int32_t  m_size   = 0;
+        
+        public:
+            row_span() = default;
+            row_span( T *data_p, int32_t size ) : m_data_p( data_p ), m_size( size ) {}
+            
+            T& operator[]( int32_t x ) const
+            {
+                return m_data_p[x];
+            }
+            
+            T* data() const
+            {
+                return m_data_p;
+            }
+            
+            int32_t size() const
+            {
+                return m_size;
+            }
+            
+            T* begin() const
+            {
+                return m_data_p;
+            }
+            
+            T* end() const
+            {
+                return m_data_p + m_size;
+            }
+        };
+        
+        /********************************************************************************/
+        
+        /**
+         * Tag of construction without initialization: elements are default-initialized,
+         * so elements of trivial types (int, float, POD structs) are indeterminate and
+         * memory of storage is not touched until written.
+         */
+        struct default_init_t
+        {
+            explicit default_init_t() = default;
+        };
+        
+        inline constexpr default_init_t default_init{};
+        
+        /**
+         * Allocator of vector2d storage: construction without arguments default-initializes,
+         * so resize() of storage doesn't zero elements of trivial types.
+         * Value-initialization is asked by value_init argument.
+         */
+        template <typename T>
+        class default_init_allocator : public std::allocator<T>
+        {
+        public:
+            struct value_init_t {};
+            
+            template <typename U>
+            struct rebind
+            {
+                using other = default_init_allocator<U>;
+            };
+            
+            default_init_allocator() = default;
+            
+            template <typename U>
+            default_init_allocator( const default_init_allocator<U>& ) noexcept {}
+            
+            template <typename U>
+            void construct( U *p ) noexcept( std::is_nothrow_default_constructible<U>::value )
+            {
+                ::new( (void*)p ) U;
+                return;
+            }
+            
+            template <typename U>
+            void construct( U *p, value_init_t )
+            {
+                ::new( (void*)p ) U();
+                return;
+            }
+            
+            template <typename U, typename... Targs>
+            void construct( U *p, Targs&&... args )
+            {
+                ::new( (void*)p ) U( std::forward<Targs>( args )... );
+                return;
+            }
+        };
+        
+        /********************************************************************************/
+        
+        /**
+         * Layouts of vector2d storage.
+         * Layout maps position to index of element in storage for current size.
+         * Storage of layout can be padded, then some indices are not positions
+         * (contains() is false for them) and keep value-initialized elements.
+         * Layout has:
+         *      dense                       - true if storage has no padding;
+         *      reset( size )               - prepares layout for size;
+         *      storage_size()              - number of elements in storage;
+         *      index( pos )                - index of position inside size;
+         *      position( index )           - position of index, is outside size for padding;
+         *      contains( index )           - index is not padding.
+         */
+        
+        /**
+         * Row by row: index is y * size.x + x. Rows are contiguous.
+         */
+        struct row_major
+        {
+            static constexpr bool dense = true;
+            
+            point2d size = point2d( 0, 0 );
+            
+            void reset( const point2d& new_size )
+            {
+                size = new_size;
+                return;
+            }
+            
+            size_t storage_size() const
+            {
+                return (size_t)size.x * (size_t)size.y;
+            }
+            
+            size_t index( const point2d& pos ) const
+            {
+                return (size_t)pos.y * (size_t)size.x + (size_t)pos.x;
+            }
+            
+            point2d position( size_t index ) const
+            {
+                return point2d( (int32_t)( index % (size_t)size.x ), (int32_t)( index / (size_t)size.x ) );
+            }
+            
+            bool contains( size_t index ) const
+            {
+                return ( index < storage_size() );
+            }
+        };
+        
+        /**
+         * Column by column: index is x * size.y + y. Columns are contiguous.
+         */
+        struct column_major
+        {
+            static constexpr bool dense = true;
+            
+            point2d size = point2d( 0, 0 );
+            
+            void reset( const point2d& new_size )
+            {
+                size = new_size;
+                return;
+            }
+            
+            size_t storage_size() const
+            {
+                return (size_t)size.x * (size_t)size.y;
+            }
+            
+            size_t index( const point2d& pos ) const
+            {
+                return (size_t)pos.x * (size_t)size.y + (size_t)pos.y;
+            }
+            
+            point2d position( size_t index ) const
+            {
+                return point2d( (int32_t)( index / (size_t)size.y ), (int32_t)( index % (size_t)size.y ) );
+            }
+            
+            bool contains( size_t index ) const
+            {
+                return ( index < storage_size() );
+            }
+        };
+        
+        /**
+         * Tiles of TileX x TileY elements, tiles go row by row, elements inside tile too.
+         * So 2d neighbourhood of element is mostly in the same tile and the same cache lines.
+         * Tile sizes are powers of 2; edge tiles are padded to full tiles.
+         */
+        template <int32_t TileX, int32_t TileY = TileX>
+        struct tiled
+        {
+            static_assert( TileX > 0 && 0 == ( TileX & ( TileX - 1 ) ), "tile width should be power of 2" );
+            static_assert( TileY > 0 && 0 == ( TileY & ( TileY - 1 ) ), "tile height should be power of 2" );
+            
+            static constexpr bool dense = false;
+            static constexpr size_t tile_x = TileX;
+            static constexpr size_t tile_y = TileY;
+            static constexpr size_t tile_elements = tile_x * tile_y;
+            
+            point2d size = point2d( 0, 0 );
+            size_t  tiles_x = 0;
+            size_t  tiles_y = 0;
+            
+            void reset( const point2d& new_size )
+            {
+                size    = new_size;
+                tiles_x = ( (size_t)size.x + tile_x - 1 ) / tile_x;
+                tiles_y = ( (size_t)size.y + tile_y - 1 ) / tile_y;
+                return;
+            }
+            
+            size_t storage_size() const
+            {
+                return tiles_x * tiles_y * tile_elements;
+            }
+            
+            size_t index( const point2d& pos ) const
+            {
+                const size_t x = (size_t)pos.x;
+                const size_t y = (size_t)pos.y;
+                const size_t tile = ( y / tile_y ) * tiles_x + x / tile_x;
+                return tile * tile_elements + ( y % tile_y ) * tile_x + x % tile_x;
+            }
+            
+            point2d position( size_t index ) const
+            {
+                const size_t tile = index / tile_elements;
+                const size_t inner = index % tile_elements;
+                return point2d( (int32_t)( ( tile % tiles_x ) * tile_x + inner % tile_x ),
+                                (int32_t)( ( tile / tiles_x ) * tile_y + inner / tile_x ) );
+            }
+            
+            bool contains( size_t index ) const
+            {
+                const point2d pos = position( index );
+                return ( index < storage_size() && pos.x < size.x && pos.y < size.y );
+            }
+        };
+        
+        /**
+         * Z-order: index interleaves bits of x and y, so every aligned square of
+         * 2^k x 2^k elements is contiguous at every scale. Sides are padded to powers of 2;
+         * higher bits of the longer side go above interleaved bits, so padding is
+         * less than 4 times of size for any proportions.
+         */
+        struct morton
+        {
+            static constexpr bool dense = false;
+            
+            point2d size = point2d( 0, 0 );
+            int32_t bits_x = 0;
+            int32_t bits_y = 0;
+            int32_t bits_common = 0; // number of interleaved bits of each coordinate
+            
+        private:
+            static int32_t BitsFor( int32_t n )
+            {
+                int32_t bits = 0;
+                while ( ( (int64_t)1 << bits ) < n )
+                {
+                    bits++;
+                }
+                return bits;
+            }
+            
+            static uint64_t SpreadBits( uint32_t v )
+            {
+                uint64_t out = v;
+                out = ( out | ( out << 16 ) ) & 0x0000FFFF0000FFFFull;
+                out = ( out | ( out << 8 ) )  & 0x00FF00FF00FF00FFull;
+                out = ( out | ( out << 4 ) )  & 0x0F0F0F0F0F0F0F0Full;
+                out = ( out | ( out << 2 ) )  & 0x3333333333333333ull;
+                out = ( out | ( out << 1 ) )  & 0x5555555555555555ull;
+                return out;
+            }
+            
+            static uint32_t CompactBits( uint64_t v )
+            {
+                v &= 0x5555555555555555ull;
+                v = ( v | ( v >> 1 ) )  & 0x3333333333333333ull;
+                v = ( v | ( v >> 2 ) )  & 0x0F0F0F0F0F0F0F0Full;
+                v = ( v | ( v >> 4 ) )  & 0x00FF00FF00FF00FFull;
+                v = ( v | ( v >> 8 ) )  & 0x0000FFFF0000FFFFull;
+                v = ( v | ( v >> 16 ) ) & 0x00000000FFFFFFFFull;
+                return (uint32_t)v;
+            }
+            
+        public:
+            void reset( const point2d& new_size )
+            {
+                size        = new_size;
+                bits_x      = BitsFor( size.x );
+                bits_y      = BitsFor( size.y );
+                bits_common = std::min( bits_x, bits_y );
+                return;
+            }
+            
+            size_t storage_size() const
+            {
+                if ( 0 == size.x || 0 == size.y )
+                {
+                    return 0;
+                }
+                return (size_t)1 << ( bits_x + bits_y );
+            }
+            
+            size_t index( const point2d& pos ) const
+            {
+                const uint32_t mask = (uint32_t)( ( (uint64_t)1 << bits_common ) - 1 );
+                const uint32_t high = ( bits_x > bits_y ) ? ( (uint32_t)pos.x >> bits_common ) :
+                                                            ( (uint32_t)pos.y >> bits_common );
+                return (size_t)( ( (uint64_t)high << ( 2 * bits_common ) ) |
+                                 SpreadBits( (uint32_t)pos.x & mask ) | ( SpreadBits( (uint32_t)pos.y & mask ) << 1 ) );
+            }
+            
+            point2d position( size_t index ) const
+            {
+                const uint64_t low_mask = ( (uint64_t)1 << ( 2 * bits_common ) ) - 1;
+                uint32_t x = CompactBits( index & low_mask );
+                uint32_t y = CompactBits( ( index & low_mask ) >> 1 );
+                const uint32_t high = (uint32_t)( (uint64_t)index >> ( 2 * bits_common ) );
+                if ( bits_x > bits_y )
+                {
+                    x |= high << bits_common;
+                } else
+                {
+                    y |= high << bits_common;
+                }
+                return point2d( (int32_t)x, (int32_t)y );
+            }
+            
+            bool contains( size_t index ) const
+            {
+                const point2d pos = position( index );
+                return ( index < storage_size() && pos.x < size.x && pos.y < size.y );
+            }
+        };
+        
+        /********************************************************************************/
+        
+        /**
+         * Iterator of padded storage: goes in storage order and skips padding.
+         */
+        template <typename Tvalue, typename Tlayout>
+        class layout_iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using difference_type   = std::ptrdiff_t;
+            using value_type        = typename std::remove_const<Tvalue>::type;
+            using pointer           = Tvalue*;
+            using reference         = Tvalue&;
+            
+        private:
+            Tvalue        *m_data_p   = nullptr;
+            const Tlayout *m_layout_p = nullptr;
+            size_t         m_index    = 0;
+            size_t         m_end      = 0;
+            
+            void SkipPadding()
+            {
+                while ( m_index < m_end && !m_layout_p->contains( m_index ) )
+                {
+                    m_index++;
+                }
+                return;
+            }
+            
+        public:
+            layout_iterator() = default;
+            layout_iterator( Tvalue *data_p, const Tlayout *layout_p, size_t index, size_t end )
+                : m_data_p( data_p ), m_layout_p( layout_p ), m_index( index ), m_end( end )
+            {
+                SkipPadding();
+            }
+            
+            reference operator*() const
+            {
+                return m_data_p[m_index];
+            }
+            
+            pointer operator->() const
+            {
+                return m_data_p + m_index;
+            }
+            
+            /**
+             * Position of current element.
+             */
+            point2d position() const
+            {
+                return m_layout_p->position( m_index );
+            }
+            
+            layout_iterator& operator++()
+            {
+                m_index++;
+                SkipPadding();
+                return *this;
+            }
+            
+            layout_iterator operator++( int )
+            {
+                layout_iterator out = *this;
+                ++( *this );
+                return out;
+            }
+            
+            bool operator==( const layout_iterator& other ) const
+            {
+                return ( m_index == other.m_index );
+            }
+            
+            bool operator!=( const layout_iterator& other ) const
+            {
+                return ( m_index != other.m_index );
+            }
+        };
+        
+        template <typename T> class vector2d_view;
+        
+        /**
+         * 2d vector.
+         * Elements are stored in order of Tlayout: by default row by row, element ( x, y )
+         * is data()[ y * stride() + x ]. Indexing by positions is the same for any layout,
+         * iterators go in storage order (skipping padding), rows are given only by row_major.
+         * operator() checks index and throws std::out_of_range, at_unchecked() and row
+         * spans don't check (only asserts with DEBUG_DS_VECTOR2D) for hot loops.
+         */
+        template <typename T, typename Tlayout = row_major>
         class vector2d
         {
+        public:
+            using layout_type    = Tlayout;
+            using storage_type   = std::vector<T, default_init_allocator<T>>;
+            using iterator       = typename std::conditional<Tlayout::dense, typename storage_type::iterator,
+                                                              layout_iterator<T,Tlayout>>::type;
+            using const_iterator = typename std::conditional<Tlayout::dense, typename storage_type::const_iterator,
+                                                              layout_iterator<const T,Tlayout>>::type;
+            
         private:
             point2d m_size;
+            Tlayout m_layout;
             
-            std::vector<T> data;
+            storage_type m_data;
             
         private:
-            bool CheckIndex( const point2d& pos )
+            bool CheckIndex( const point2d& pos ) const
+            {
+                if ( pos.x >= m_size.x || pos.y >= m_size.y || pos.x < 0 || pos.y < 0 )
+                {
+                    return false;
+                }
+                return true;
+            }
+            
+            size_t CountIndexWithoutCheck( const point2d& pos ) const
+            {
+                return m_layout.index( pos );
+            }
+            
+            size_t CountIndex( const point2d& pos ) const
+            {
+                if ( !CheckIndex( pos ) )
+                {
+                    throw std::out_of_range( "index " + (std::string)pos + " is out of size " + (std::string)m_size );
+                }
+                
+                return CountIndexWithoutCheck( pos );
+            }
+            
+            /**
+             * Appends count value-initialized elements to storage.
+             */
+            static void AppendValueInitialized( storage_type& storage, size_t count )
+            {
+                if constexpr ( std::is_trivial<T>::value )
+                {
+                    // value-initialized trivial element is copy of T()
+                    const size_t old_size = storage.size();
+                    storage.resize( old_size + count );
+                    std::fill( storage.begin() + old_size, storage.end(), T() );
+                } else
+                {
+                    storage.reserve( storage.size() + count );
+                    for ( size_t i = 0; i < count; i++ )
+                    {
+                        storage.emplace_back( typename default_init_allocator<T>::value_init_t() );
+                    }
+                }
+                return;
+            }
+            
+            void InitLayout()
+            {
+                if ( m_size.x < 0 || m_size.y < 0 )
+                {
+                    throw std::out_of_range( "size " + (std::string)m_size + " has parts < 0" );
+                }
+                m_layout.reset( m_size );
+                return;
+            }
+            
+            void SetSize( const point2d& new_size )
+            {
+                m_size = new_size;
+                m_layout.reset( new_size );
+                return;
+            }
+            
+            /**
+             * Resize of layouts other than row_major: moves kept elements to new storage.
+             */
+            void ResizeByPositions( const point2d& new_size )
+            {
+                Tlayout new_layout;
+                new_layout.reset( new_size );
+                storage_type new_data;
+                AppendValueInitialized( new_data, new_layout.storage_size() );
+                const int32_t num_rows = std::min( m_size.y, new_size.y );
+                const int32_t row_x    = std::min( m_size.x, new_size.x );
+                for ( int32_t y = 0; y < num_rows; y++ )
+                {
+                    for ( int32_t x = 0; x < row_x; x++ )
+                    {
+                        const point2d pos( x, y );
+                        new_data[ new_layout.index( pos ) ] = std::move( m_data[ m_layout.index( pos ) ] );
+                    }
+                }
+                m_data = std::move( new_data );
+                SetSize( new_size );
+                return;
+            }
+            
+            void CheckRow( int32_t y ) const
             {
-                if ( pos.x >= m_size.x || pos.y >= m_size.y || pos.x < 0 || pos.y < 0 )
+                if ( y < 0 || y >= m_size.y )
                 {
-                    return false;
+                    throw std::out_of_range( "row " + std::to_string( y ) + " is out of size " + (std::string)m_size );
                 }
-                return true;
+                return;
             }
             
-            int32_t CountIndexWithoutCheck( const point2d& pos )
+        public:
+            /**
+             * Elements are value-initialized.
+             */
+            vector2d( const point2d& new_size ) : m_size( new_size )
             {
-                return ( pos.y * m_size.x + pos.x );
+                InitLayout();
+                AppendValueInitialized( m_data, m_layout.storage_size() );
             }
+            vector2d( int32_t x, int32_t y ) : vector2d( point2d( x, y ) ) {}
             
-            int32_t CountIndex( const point2d& pos )
+            /**
+             * Elements are default-initialized, see default_init_t.
+             */
+            vector2d( const point2d& new_size, default_init_t ) : m_size( new_size )
             {
-                if ( !CheckIndex( pos ) )
-                {
-                    throw std::out_of_range( "index " + (std::string)pos + " is out of size " + (std::string)m_size );
-                }
-                
-                return CountIndexWithoutCheck( pos );
+                InitLayout();
+                m_data.resize( m_layout.storage_size() );
             }
+            vector2d( int32_t x, int32_t y, default_init_t tag ) : vector2d( point2d( x, y ), tag ) {}
             
-            int32_t SizeInt()
+            /**
+             * Elements are copies of value.
+             */
+            vector2d( const point2d& new_size, const T& value ) : m_size( new_size )
             {
-                return ( m_size.x * m_size.y );
+                InitLayout();
+                m_data.assign( m_layout.storage_size(), value );
             }
+            vector2d( int32_t x, int32_t y, const T& value ) : vector2d( point2d( x, y ), value ) {}
             
-        public:
-            vector2d( const point2d& new_size ) : m_size( new_size )
+            /**
+             * Takes buffer as storage without copying, element ( x, y ) is
+             * buffer[ layout().index( point2d( x, y ) ) ], for row_major it is buffer[ y * x_size + x ].
+             * Throws std::invalid_argument if buffer size is not storage size of new_size.
+             */
+            vector2d( const point2d& new_size, storage_type&& buffer ) : m_size( new_size )
             {
-                if ( new_size.x < 0 || new_size.y < 0 )
+                InitLayout();
+                if ( buffer.size() != m_layout.storage_size() )
                 {
-                    throw std::out_of_range( "size " + (std::string)new_size + " has parts < 0" );
+                    throw std::invalid_argument( "buffer of " + std::to_string( buffer.size() ) +
+                                                 " elements doesn't fit size " + (std::string)m_size );
                 }
-                data.reserve( new_size.x * new_size.y );
-                data.resize(  new_size.x * new_size.y );
+                m_data = std::move( buffer );
             }
-            vector2d( int32_t x, int32_t y ) : m_size( point2d( x, y ) )
+            
+            /**
+             * Gives storage away without copying, vector2d becomes of size ( 0, 0 ).
+             */
+            storage_type release()
             {
-                if ( m_size.x < 0 || m_size.y < 0 )
-                {
-                    throw std::out_of_range( "size " + (std::string)m_size + " has parts < 0" );
-                }
-                data.reserve( m_size.x * m_size.y );
-                data.resize(  m_size.x * m_size.y );
+                storage_type out = std::move( m_data );
+                m_data.clear();
+                SetSize( point2d( 0, 0 ) );
+                return out;
             }
             
             point2d size() const
@@ -148,77 +728,541 @@ namespace ds
                 return m_size;
             }
             
+            const Tlayout& layout() const
+            {
+                return m_layout;
+            }
+            
+            /**
+             * Changes size keeping elements with indices inside both sizes,
+             * new elements are value-initialized.
+             * In row_major layout rows are moved inside storage when it has capacity
+             * for new size (see reserve), otherwise they are moved to new storage once.
+             * Other layouts always move elements to new storage.
+             */
             void resize( const point2d& new_size )
             {
                 if ( new_size.x < 0 || new_size.y < 0 )
                 {
                     throw std::out_of_range( "size " + (std::string)new_size + " has parts < 0" );
                 }
+                if ( new_size == m_size )
+                {
+                    return;
+                }
+                if constexpr ( !std::is_same<Tlayout,row_major>::value )
+                {
+                    ResizeByPositions( new_size );
+                    return;
+                }
+                
+                const size_t old_x     = (size_t)m_size.x;
+                const size_t new_x     = (size_t)new_size.x;
+                const size_t num_rows  = (size_t)std::min( m_size.y, new_size.y );
+                const size_t row_x     = std::min( old_x, new_x );
+                const size_t old_count = m_data.size();
+                const size_t new_count = new_x * (size_t)new_size.y;
+                
+                if ( new_x > old_x && new_count > m_data.capacity() )
+                {
+                    storage_type new_data;
+                    AppendValueInitialized( new_data, new_count );
+                    for ( size_t y = 0; y < num_rows; y++ )
+                    {
+                        std::move( m_data.begin() + y * old_x, m_data.begin() + y * old_x + row_x,
+                                   new_data.begin() + y * new_x );
+                    }
+                    m_data = std::move( new_data );
+                    SetSize( new_size );
+                    return;
+                }
                 
-                std::vector<T> new_data;
-                new_data.reserve( new_size.x * new_size.y );
+                if ( new_count > old_count )
+                {
+                    AppendValueInitialized( m_data, new_count - old_count );
+                }
                 
-                for ( int32_t y = 0 ; y < new_size.y; y++ )
+                if ( new_x < old_x )
+                {
+                    // rows go to lower positions, so they are moved from the first one
+                    for ( size_t y = 1; y < num_rows; y++ )
+                    {
+                        std::move( m_data.begin() + y * old_x, m_data.begin() + y * old_x + row_x,
+                                   m_data.begin() + y * new_x );
+                    }
+                } else if ( new_x > old_x )
                 {
-                    for ( int32_t x = 0 ; x < new_size.x; x++ )
+                    // rows go to higher positions, so they are moved from the last one,
+                    // first row stays in place, tails of rows get new elements
+                    for ( size_t y = num_rows; y-- > 0; )
                     {
-                        if ( x < m_size.x && y < m_size.y )
+                        if ( y > 0 )
                         {
-                            new_data[ new_size.x * y + x ] = data[ m_size.x * y + x ];
+                            std::move_backward( m_data.begin() + y * old_x, m_data.begin() + y * old_x + row_x,
+                                                m_data.begin() + y * new_x + row_x );
                         }
+                        std::fill( m_data.begin() + y * new_x + row_x, m_data.begin() + ( y + 1 ) * new_x, T() );
                     }
                 }
                 
-                data = new_data;
+                // elements after kept rows which were not appended by resize are left from old rows
+                const size_t kept_end = std::min( old_count, new_count );
+                if ( num_rows * new_x < kept_end )
+                {
+                    std::fill( m_data.begin() + num_rows * new_x, m_data.begin() + kept_end, T() );
+                }
                 
+                if ( new_count < old_count )
+                {
+                    m_data.erase( m_data.begin() + new_count, m_data.end() );
+                }
+                SetSize( new_size );
                 return;
             }
             
-            T& operator() ( const point2d& pos )
+            void resize( int32_t x, int32_t y )
             {
-                if ( !CheckIndex( pos ) )
+                resize( point2d( x, y ) );
+                return;
+            }
+            
+            /**
+             * Prepares storage for size new_capacity, so resizes up to it
+             * don't allocate and move rows inside storage.
+             */
+            void reserve( const point2d& new_capacity )
+            {
+                if ( new_capacity.x < 0 || new_capacity.y < 0 )
                 {
-                    throw std::out_of_range ( "index " + (std::string)pos + " is out of size " + (std::string)m_size );
+                    throw std::out_of_range( "capacity " + (std::string)new_capacity + " has parts < 0" );
                 }
-                return data.at( CountIndex( pos ) );
+                Tlayout capacity_layout;
+                capacity_layout.reset( new_capacity );
+                m_data.reserve( capacity_layout.storage_size() );
+                return;
+            }
+            
+            T& operator() ( const point2d& pos )
+            {
+                return m_data[ CountIndex( pos ) ];
             }
             
             T  operator() ( const point2d& pos ) const
             {
-                if ( !CheckIndex( pos ) )
+                return m_data[ CountIndex( pos ) ];
+            }
+            
+            T& operator() ( int32_t x, int32_t y )
+            {
+                return m_data[ CountIndex( point2d( x, y ) ) ];
+            }
+            
+            T  operator() ( int32_t x, int32_t y ) const
+            {
+                return m_data[ CountIndex( point2d( x, y ) ) ];
+            }
+            
+            /**
+             * Access without bounds check.
+             */
+            T& at_unchecked( const point2d& pos )
+            {
+#ifdef DEBUG_DS_VECTOR2D
+                assert( CheckIndex( pos ) );
+#endif /* DEBUG_DS_VECTOR2D */
+                return m_data[ CountIndexWithoutCheck( pos ) ];
+            }
+            
+            const T& at_unchecked( const point2d& pos ) const
+            {
+#ifdef DEBUG_DS_VECTOR2D
+                assert( CheckIndex( pos ) );
+#endif /* DEBUG_DS_VECTOR2D */
+                return m_data[ CountIndexWithoutCheck( pos ) ];
+            }
+            
+            T& at_unchecked( int32_t x, int32_t y )
+            {
+                return at_unchecked( point2d( x, y ) );
+            }
+            
+            const T& at_unchecked( int32_t x, int32_t y ) const
+            {
+                return at_unchecked( point2d( x, y ) );
+            }
+            
+            /**
+             * Gives span of row y, throws std::out_of_range if there is no such row.
+             */
+            row_span<T> row( int32_t y )
+            {
+                CheckRow( y );
+                return row_unchecked( y );
+            }
+            
+            row_span<const T> row( int32_t y ) const
+            {
+                CheckRow( y );
+                return row_unchecked( y );
+            }
+            
+            row_span<T> row_unchecked( int32_t y )
+            {
+                static_assert( std::is_same<Tlayout,row_major>::value, "rows are contiguous only in row_major layout" );
+#ifdef DEBUG_DS_VECTOR2D
+                assert( y >= 0 && y < m_size.y );
+#endif /* DEBUG_DS_VECTOR2D */
+                return row_span<T>( m_data.data() + (size_t)y * (size_t)m_size.x, m_size.x );
+            }
+            
+            row_span<const T> row_unchecked( int32_t y ) const
+            {
+                static_assert( std::is_same<Tlayout,row_major>::value, "rows are contiguous only in row_major layout" );
+#ifdef DEBUG_DS_VECTOR2D
+                assert( y >= 0 && y < m_size.y );
+#endif /* DEBUG_DS_VECTOR2D */
+                return row_span<const T>( m_data.data() + (size_t)y * (size_t)m_size.x, m_size.x );
+            }
+            
+            /**
+             * Raw storage: element ( x, y ) is data()[ layout().index( point2d( x, y ) ) ],
+             * for row_major it is data()[ y * stride() + x ].
+             */
+            T* data()
+            {
+                return m_data.data();
+            }
+            
+            const T* data() const
+            {
+                return m_data.data();
+            }
+            
+            /**
+             * Number of elements between starts of neighbour rows.
+             */
+            int32_t stride() const
+            {
+                static_assert( std::is_same<Tlayout,row_major>::value, "stride is defined only for row_major layout" );
+                return m_size.x;
+            }
+            
+            /**
+             * View of whole vector2d or of rectangle of it, see vector2d_view.
+             */
+            vector2d_view<T> view()
+            {
+                return vector2d_view<T>( data(), m_size, stride() );
+            }
+            
+            vector2d_view<const T> view() const
+            {
+                return vector2d_view<const T>( data(), m_size, stride() );
+            }
+            
+            vector2d_view<T> view( const rect2d& rect )
+            {
+                return view().subview( rect );
+            }
+            
+            vector2d_view<const T> view( const rect2d& rect ) const
+            {
+                return view().subview( rect );
+            }
+            
+            /**
+             * Iterators go in storage order of layout.
+             */
+            iterator begin()
+            {
+                if constexpr ( Tlayout::dense )
                 {
-                    throw std::out_of_range ( "index " + (std::string)pos + " is out of size " + (std::string)m_size );
+                    return m_data.begin();
+                } else
+                {
+                    return iterator( m_data.data(), &m_layout, 0, m_data.size() );
+                }
+            }
+            iterator end()
+            {
+                if constexpr ( Tlayout::dense )
+                {
+                    return m_data.end();
+                } else
+                {
+                    return iterator( m_data.data(), &m_layout, m_data.size(), m_data.size() );
                 }
-                return data.at( CountIndex( pos ) );
             }
             
-            T& operator() ( int32_t x, int32_t y )
+            const_iterator begin() const
             {
-                point2d pos = { x, y };
-                if ( !CheckIndex( pos ) )
+                if constexpr ( Tlayout::dense )
                 {
-                    throw std::out_of_range ( "index " + (std::string)pos + " is out of size " + (std::string)m_size );
+                    return m_data.begin();
+                } else
+                {
+                    return const_iterator( m_data.data(), &m_layout, 0, m_data.size() );
+                }
+            }
+            const_iterator end() const
+            {
+                if constexpr ( Tlayout::dense )
+                {
+                    return m_data.end();
+                } else
+                {
+                    return const_iterator( m_data.data(), &m_layout, m_data.size(), m_data.size() );
                 }
-                return data.at( CountIndex( pos ) );
             }
+        };
+        
+        /********************************************************************************/
+        
+        /**
+         * Iterator of vector2d_view: goes row by row, jumps over stride at row ends.
+         * Row pointer stays at last row after it, so end is counted by row number
+         * and no pointer goes out of storage.
+         */
+        template <typename T>
+        class view_iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using difference_type   = std::ptrdiff_t;
+            using value_type        = typename std::remove_const<T>::type;
+            using pointer           = T*;
+            using reference         = T&;
             
-            T  operator() ( int32_t x, int32_t y ) const
+        private:
+            T       *m_row_p  = nullptr;
+            int32_t  m_x      = 0;
+            int32_t  m_y      = 0;
+            int32_t  m_width  = 0;
+            int32_t  m_height = 0;
+            int32_t  m_stride = 0;
+            
+        public:
+            view_iterator() = default;
+            view_iterator( T *row_p, int32_t x, int32_t y, int32_t width, int32_t height, int32_t stride )
+                : m_row_p( row_p ), m_x( x ), m_y( y ), m_width( width ), m_height( height ), m_stride( stride ) {}
+            
+            reference operator*() const
+            {
+                return m_row_p[m_x];
+            }
+            
+            pointer operator->() const
+            {
+                return m_row_p + m_x;
+            }
+            
+            view_iterator& operator++()
+            {
+                if ( ++m_x == m_width )
+                {
+                    m_x = 0;
+                    if ( ++m_y < m_height )
+                    {
+                        m_row_p += m_stride;
+                    }
+                }
+                return *this;
+            }
+            
+            view_iterator operator++( int )
+            {
+                view_iterator out = *this;
+                ++( *this );
+                return out;
+            }
+            
+            bool operator==( const view_iterator& other ) const
+            {
+                return ( m_row_p == other.m_row_p && m_y == other.m_y && m_x == other.m_x );
+            }
+            
+            bool operator!=( const view_iterator& other ) const
+            {
+                return !( *this == other );
+            }
+        };
+        
+        /**
+         * View of rectangle of vector2d (or of other view), doesn't own memory.
+         * Element ( x, y ) of view is data()[ y * stride() + x ], so view of
+         * rectangle is made without copying and views of views are views of the same storage.
+         * Is valid while vector2d is not resized. View of const T is read-only;
+         * view<T> converts to view<const T>, vector2d<T> converts to both.
+         * Indexing is the same as of vector2d: operator() checks and throws
+         * std::out_of_range, at_unchecked() and row_unchecked() don't check.
+         */
+        template <typename T>
+        class vector2d_view
+        {
+        public:
+            using value_type = typename std::remove_const<T>::type;
+            using iterator   = view_iterator<T>;
+            
+        private:
+            T       *m_data_p = nullptr;
+            point2d  m_size   = point2d( 0, 0 );
+            int32_t  m_stride = 0;
+            
+        private:
+            bool CheckIndex( const point2d& pos ) const
+            {
+                if ( pos.x >= m_size.x || pos.y >= m_size.y || pos.x < 0 || pos.y < 0 )
+                {
+                    return false;
+                }
+                return true;
+            }
+            
+            std::ptrdiff_t CountIndexWithoutCheck( const point2d& pos ) const
+            {
+                return ( (std::ptrdiff_t)pos.y * m_stride + pos.x );
+            }
+            
+            std::ptrdiff_t CountIndex( const point2d& pos ) const
             {
-                point2d pos = { x, y };
                 if ( !CheckIndex( pos ) )
                 {
-                    throw std::out_of_range ( "index " + (std::string)pos + " is out of size " + (std::string)m_size );
+                    throw std::out_of_range( "index " + (std::string)pos + " is out of size " + (std::string)m_size );
+                }
+                
+                return CountIndexWithoutCheck( pos );
+            }
+            
+        public:
+            vector2d_view() = default;
+            
+            /**
+             * View of size elements of rows going with stride from data_p.
+             */
+            vector2d_view( T *data_p, const point2d& size, int32_t stride )
+                : m_data_p( data_p ), m_size( size ), m_stride( stride )
+            {
+                if ( size.x < 0 || size.y < 0 )
+                {
+                    throw std::out_of_range( "size " + (std::string)size + " has parts < 0" );
+                }
+                if ( stride < size.x )
+                {
+                    throw std::out_of_range( "stride " + std::to_string( stride ) + " is less than width of size " +
+                                             (std::string)size );
+                }
+            }
+            
+            vector2d_view( vector2d<value_type>& v )
+                : m_data_p( v.data() ), m_size( v.size() ), m_stride( v.stride() ) {}
+            
+            template <typename Tother = T, typename = typename std::enable_if<std::is_const<Tother>::value>::type>
+            vector2d_view( const vector2d<value_type>& v )
+                : m_data_p( v.data() ), m_size( v.size() ), m_stride( v.stride() ) {}
+            
+            template <typename Tother = T, typename = typename std::enable_if<std::is_const<Tother>::value>::type>
+            vector2d_view( const vector2d_view<value_type>& other )
+                : m_data_p( other.data() ), m_size( other.size() ), m_stride( other.stride() ) {}
+            
+            point2d size() const
+            {
+                return m_size;
+            }
+            
+            bool empty() const
+            {
+                return ( 0 == m_size.x || 0 == m_size.y );
+            }
+            
+            /**
+             * Number of elements between starts of neighbour rows.
+             */
+            int32_t stride() const
+            {
+                return m_stride;
+            }
+            
+            T* data() const
+            {
+                return m_data_p;
+            }
+            
+            T& operator() ( const point2d& pos ) const
+            {
+                return m_data_p[ CountIndex( pos ) ];
+            }
+            
+            T& operator() ( int32_t x, int32_t y ) const
+            {
+                return m_data_p[ CountIndex( point2d( x, y ) ) ];
+            }
+            
+            T& at_unchecked( const point2d& pos ) const
+            {
+#ifdef DEBUG_DS_VECTOR2D
+                assert( CheckIndex( pos ) );
+#endif /* DEBUG_DS_VECTOR2D */
+                return m_data_p[ CountIndexWithoutCheck( pos ) ];
+            }
+            
+            T& at_unchecked( int32_t x, int32_t y ) const
+            {
+                return at_unchecked( point2d( x, y ) );
+            }
+            
+            /**
+             * Gives span of row y, throws std::out_of_range if there is no such row.
+             */
+            row_span<T> row( int32_t y ) const
+            {
+                if ( y < 0 || y >= m_size.y )
+                {
+                    throw std::out_of_range( "row " + std::to_string( y ) + " is out of size " + (std::string)m_size );
                 }
-                return data.at( CountIndex( pos ) );
+                return row_unchecked( y );
             }
             
-            typename std::vector<T>::iterator begin()
+            row_span<T> row_unchecked( int32_t y ) const
             {
-                return data.begin();
+#ifdef DEBUG_DS_VECTOR2D
+                assert( y >= 0 && y < m_size.y );
+#endif /* DEBUG_DS_VECTOR2D */
+                return row_span<T>( m_data_p + (std::ptrdiff_t)y * m_stride, m_size.x );
+            }
+            
+            /**
+             * View of rectangle of this view, throws std::out_of_range if rect is not inside it.
+             */
+            vector2d_view subview( const rect2d& rect ) const
+            {
+                if ( !rect.inside( m_size ) )
+                {
+                    throw std::out_of_range( "rect " + (std::string)rect + " is out of size " + (std::string)m_size );
+                }
+                return vector2d_view( m_data_p + CountIndexWithoutCheck( rect.origin ), rect.size, m_stride );
+            }
+            
+            vector2d_view subview( const point2d& origin, const point2d& size ) const
+            {
+                return subview( rect2d( origin, size ) );
+            }
+            
+            /**
+             * Iterators go row by row.
+             */
+            iterator begin() const
+            {
+                return empty() ? end() : iterator( m_data_p, 0, 0, m_size.x, m_size.y, m_stride );
             }
-            typename std::vector<T>::iterator end()
+            
+            iterator end() const
             {
-                return data.end();
+                if ( empty() )
+                {
+                    return iterator( m_data_p, 0, 0, m_size.x, m_size.y, m_stride );
+                }
+                return iterator( m_data_p + (std::ptrdiff_t)( m_size.y - 1 ) * m_stride, 0, m_size.y,
+                                 m_size.x, m_size.y, m_stride );
             }
         };
     }
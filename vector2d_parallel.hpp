@@ -0,0 +1,252 @@
+/**
+ * Parallel passes over vector2d.
+ */
+#pragma once
+
+/****************************************************************************************/
+
+/**
+ * parallel_for( pool_p, v, rect, f ) calls f( pos, value ) for every element of
+ * rectangle rect of v, transform( pool_p, in, rect, out, f ) sets
+ * out( pos ) = f( in( pos ) ). Without rect whole vector2d is processed.
+ *
+ * Storage range of rect is split into chunks, which are taken by workers of
+ * pool dynamically, so uneven work is balanced. Chunks go in storage order
+ * of layout: bands of rows for row_major, groups of tiles for tiled. Inner
+ * ends of chunks are moved to starts of cache lines, so two workers never
+ * write the same cache line. Sizes of elements, which don't divide cache line
+ * (e.g. 12 bytes), make chunks longer: line starts at element only every
+ * lcm( size, cache line ) bytes. Storage aligned so that no cache line starts
+ * at element can have shared lines. Pool can be nullptr, then everything runs
+ * inline. f is called concurrently and should only touch its element.
+ *
+ * Layout should have index growing with x and y, all layouts of vector2d.hpp do.
+ *
+ * Usage:
+ *      ds::vector2d::parallel_for( &pool, image, [&]( const ds::vector2d::point2d& pos, float& value )
+ *                                                {
+ *                                                    value = gain * value;
+ *                                                } );
+ */
+
+/****************************************************************************************/
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "vector2d.hpp"
+#include "thread_pool.hpp"
+
+/****************************************************************************************/
+
+namespace ds
+{
+    namespace vector2d
+    {
+        /********************************************************************************/
+        
+        namespace parallel_detail
+        {
+            constexpr size_t cache_line = 64;
+            
+            // chunk has at least so many elements, so taking it costs little against work
+            constexpr size_t min_chunk = 1024;
+            
+            // chunks per worker, more chunks balance uneven work better
+            constexpr size_t chunks_per_worker = 8;
+            
+            inline void check_rect( const rect2d& rect, const point2d& size )
+            {
+                if ( !rect.inside( size ) )
+                {
+                    throw std::out_of_range( "rect " + (std::string)rect + " is out of size " + (std::string)size );
+                }
+                return;
+            }
+            
+            /**
+             * Calls f( pos, value ) for elements of rect in storage indices [begin, end).
+             */
+            template <typename Tvalue, typename Tlayout, typename Tfunc>
+            void run_chunk( Tvalue *data_p, const Tlayout& layout, const rect2d& rect,
+                            size_t begin, size_t end, Tfunc& f )
+            {
+                const size_t x_first = (size_t)rect.origin.x;
+                const size_t x_last  = x_first + (size_t)rect.size.x;
+                
+                if constexpr ( std::is_same<Tlayout,row_major>::value )
+                {
+                    // row segments of rect, no positions are counted from indices
+                    const size_t width = (size_t)layout.size.x;
+                    for ( size_t y = begin / width; y * width < end; y++ )
+                    {
+                        const size_t row_start = y * width;
+                        const size_t x_begin = std::max( x_first, ( begin > row_start ) ? begin - row_start : 0 );
+                        const size_t x_end   = std::min( x_last, end - row_start );
+                        Tvalue *row_p = data_p + row_start;
+                        for ( size_t x = x_begin; x < x_end; x++ )
+                        {
+                            f( point2d( (int32_t)x, (int32_t)y ), row_p[x] );
+                        }
+                    }
+                } else
+                {
+                    // padding has positions out of size, so it is out of rect too
+                    const size_t y_first = (size_t)rect.origin.y;
+                    const size_t y_last  = y_first + (size_t)rect.size.y;
+                    for ( size_t index = begin; index < end; index++ )
+                    {
+                        const point2d pos = layout.position( index );
+                        if ( (size_t)pos.x >= x_first && (size_t)pos.x < x_last &&
+                             (size_t)pos.y >= y_first && (size_t)pos.y < y_last )
+                        {
+                            f( pos, data_p[index] );
+                        }
+                    }
+                }
+                return;
+            }
+            
+            template <typename Tvalue, typename Tlayout, typename Tfunc>
+            void run( ds::thread_pool::thread_pool *pool_p, Tvalue *data_p, const Tlayout& layout,
+                      const rect2d& rect, Tfunc& f )
+            {
+                if ( rect.empty() )
+                {
+                    return;
+                }
+                
+                // index grows with x and y, so rect is inside this storage range
+                const size_t first = layout.index( rect.origin );
+                const size_t last  = layout.index( rect.origin + rect.size - point2d( 1, 1 ) ) + 1;
+                
+                // ends of chunks are aligned to cache lines of storage: line starts at element
+                // every lcm( elem, cache_line ) bytes, so its period is line elements
+                const size_t elem = sizeof( Tvalue );
+                size_t line = cache_line / std::gcd( elem, cache_line );
+                size_t offset = 0;
+                size_t first_aligned = 0;
+                while ( first_aligned < line &&
+                        0 != ( reinterpret_cast<uintptr_t>( data_p ) + first_aligned * elem ) % cache_line )
+                {
+                    first_aligned++;
+                }
+                if ( first_aligned < line )
+                {
+                    offset = ( line - first_aligned ) % line;
+                } else
+                {
+                    // no line starts at element, so chunks end anywhere
+                    line = 1;
+                }
+                
+                const size_t num_workers = ds::thread_pool::workers_count( pool_p );
+                size_t chunk = std::max( min_chunk, ( last - first ) / ( num_workers * chunks_per_worker ) );
+                chunk = ( chunk + line - 1 ) / line * line;
+                const size_t num_chunks = ( last - first + chunk - 1 ) / chunk;
+                
+                auto bound = [&]( size_t k )
+                             {
+                                 if ( 0 == k )
+                                 {
+                                     return first;
+                                 }
+                                 size_t out = first + k * chunk;
+                                 out += ( line - ( out + offset ) % line ) % line;
+                                 return std::min( out, last );
+                             };
+                
+                ds::thread_pool::parallel_for( pool_p, 0, (int64_t)num_chunks, 1,
+                                               [&]( int64_t chunk_begin, int64_t chunk_end, size_t )
+                                               {
+                                                   for ( int64_t k = chunk_begin; k < chunk_end; k++ )
+                                                   {
+                                                       run_chunk( data_p, layout, rect, bound( (size_t)k ),
+                                                                  bound( (size_t)k + 1 ), f );
+                                                   }
+                                               } );
+                return;
+            }
+        }
+        
+        /********************************************************************************/
+        
+        /**
+         * Calls f( const point2d& pos, T& value ) for every element of rect,
+         * throws std::out_of_range if rect is not inside v.
+         */
+        template <typename T, typename Tlayout, typename Tfunc>
+        void parallel_for( ds::thread_pool::thread_pool *pool_p, vector2d<T,Tlayout>& v, const rect2d& rect, Tfunc f )
+        {
+            parallel_detail::check_rect( rect, v.size() );
+            parallel_detail::run( pool_p, v.data(), v.layout(), rect, f );
+            return;
+        }
+        
+        template <typename T, typename Tlayout, typename Tfunc>
+        void parallel_for( ds::thread_pool::thread_pool *pool_p, vector2d<T,Tlayout>& v, Tfunc f )
+        {
+            parallel_for( pool_p, v, rect2d( point2d( 0, 0 ), v.size() ), f );
+            return;
+        }
+        
+        /**
+         * Read-only pass: calls f( const point2d& pos, const T& value ).
+         */
+        template <typename T, typename Tlayout, typename Tfunc>
+        void parallel_for( ds::thread_pool::thread_pool *pool_p, const vector2d<T,Tlayout>& v, const rect2d& rect,
+                           Tfunc f )
+        {
+            parallel_detail::check_rect( rect, v.size() );
+            parallel_detail::run( pool_p, v.data(), v.layout(), rect, f );
+            return;
+        }
+        
+        template <typename T, typename Tlayout, typename Tfunc>
+        void parallel_for( ds::thread_pool::thread_pool *pool_p, const vector2d<T,Tlayout>& v, Tfunc f )
+        {
+            parallel_for( pool_p, v, rect2d( point2d( 0, 0 ), v.size() ), f );
+            return;
+        }
+        
+        /**
+         * Sets out( pos ) = f( in( pos ) ) for every pos of rect. in and out should have
+         * the same size (else std::invalid_argument is thrown), they can be one vector2d.
+         * Work is split by storage of out.
+         */
+        template <typename Tin, typename Tin_layout, typename Tout, typename Tout_layout, typename Tfunc>
+        void transform( ds::thread_pool::thread_pool *pool_p, const vector2d<Tin,Tin_layout>& in, const rect2d& rect,
+                        vector2d<Tout,Tout_layout>& out, Tfunc f )
+        {
+            if ( in.size() != out.size() )
+            {
+                throw std::invalid_argument( "size " + (std::string)out.size() + " differs from size " +
+                                             (std::string)in.size() );
+            }
+            parallel_for( pool_p, out, rect,
+                          [&]( const point2d& pos, Tout& value )
+                          {
+                              value = f( in.at_unchecked( pos ) );
+                          } );
+            return;
+        }
+        
+        template <typename Tin, typename Tin_layout, typename Tout, typename Tout_layout, typename Tfunc>
+        void transform( ds::thread_pool::thread_pool *pool_p, const vector2d<Tin,Tin_layout>& in,
+                        vector2d<Tout,Tout_layout>& out, Tfunc f )
+        {
+            transform( pool_p, in, rect2d( point2d( 0, 0 ), in.size() ), out, f );
+            return;
+        }
+        
+        /********************************************************************************/
+    }
+}
+
+/****************************************************************************************/
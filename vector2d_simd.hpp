@@ -0,0 +1,910 @@
+/**
+ * SIMD element-wise operations and reductions of vector2d.
+ */
+#pragma once
+
+/****************************************************************************************/
+
+/**
+ * Operations work on vector2d<float> and vector2d<int32_t> over whole storage,
+ * so they don't go through operator() and are run by vector registers:
+ *      element-wise:   add, subtract, multiply, elementwise_min, elementwise_max,
+ *                      scale, fma( a, b, c ) = a * b + c, threshold;
+ *      reductions:     sum, min_value, max_value;
+ *      by rows:        row_sums, row_min, row_max      - one value per row;
+ *      by columns:     column_sums, column_min, column_max - one value per column.
+ * Operands of element-wise operations should have the same size, output can be
+ * one of operands. Sums are counted in double for float and int64_t for int32_t,
+ * other int32_t arithmetic wraps around.
+ *
+ * Instruction set is chosen at runtime by CPU: AVX2 with FMA or SSE4.1 on x86,
+ * NEON on AArch64, plain scalar code otherwise. Kernels are compiled for all sets
+ * of target architecture regardless of compiler flags. set_simd_isa() forces set,
+ * e.g. to compare results. Float results can differ between sets in last bits:
+ * sums are added in different order and fma is fused only by AVX2 and NEON.
+ * Note: clang ignores #pragma GCC target, so for it x86 kernels get the same
+ * targets by #pragma clang attribute.
+ *
+ * Usage:
+ *      ds::vector2d::fma( weights, image, bias, image );
+ *      double total = ds::vector2d::sum( image );
+ */
+
+/****************************************************************************************/
+
+#include <vector>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "vector2d.hpp"
+
+#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#define DS_VECTOR2D_SIMD_X86
+#include <immintrin.h>
+#elif defined( __aarch64__ )
+#define DS_VECTOR2D_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+/****************************************************************************************/
+
+namespace ds
+{
+    namespace vector2d
+    {
+        /********************************************************************************/
+        
+        enum class simd_isa
+        {
+            scalar,
+            sse41,
+            avx2,
+            neon
+        };
+        
+        inline const char* simd_isa_name( simd_isa isa )
+        {
+            switch ( isa )
+            {
+            case simd_isa::sse41:
+                return "sse4.1";
+            case simd_isa::avx2:
+                return "avx2";
+            case simd_isa::neon:
+                return "neon";
+            default:
+                return "scalar";
+            }
+        }
+        
+        /********************************************************************************/
+        
+        namespace simd_detail
+        {
+            enum class binary_op
+            {
+                add,
+                sub,
+                mul,
+                min,
+                max
+            };
+            
+            /**
+             * Scalar traits: register of one element.
+             */
+            namespace scalar
+            {
+                struct f32
+                {
+                    using reg      = float;
+                    using wide     = double;
+                    using sum_type = double;
+                    
+                    static constexpr size_t width = 1;
+                    
+                    static reg load( const float *p ) { return *p; }
+                    static void store( float *p, reg v ) { *p = v; }
+                    static reg set1( float v ) { return v; }
+                    static reg add( reg a, reg b ) { return a + b; }
+                    static reg sub( reg a, reg b ) { return a - b; }
+                    static reg mul( reg a, reg b ) { return a * b; }
+                    static reg min( reg a, reg b ) { return ( a < b ) ? a : b; }
+                    static reg max( reg a, reg b ) { return ( a > b ) ? a : b; }
+                    static reg fma( reg a, reg b, reg c ) { return a * b + c; }
+                    static reg select_gt( reg a, reg t, reg low, reg high ) { return ( a > t ) ? high : low; }
+                    static float reduce_min( reg v ) { return v; }
+                    static float reduce_max( reg v ) { return v; }
+                    
+                    static wide wide_zero() { return 0.0; }
+                    static wide wide_add( wide acc, reg v ) { return acc + (double)v; }
+                    static wide wide_load( const double *p ) { return *p; }
+                    static void wide_store( double *p, wide v ) { *p = v; }
+                    static sum_type wide_total( wide v ) { return v; }
+                };
+                
+                struct i32
+                {
+                    using reg      = int32_t;
+                    using wide     = int64_t;
+                    using sum_type = int64_t;
+                    
+                    static constexpr size_t width = 1;
+                    
+                    static reg load( const int32_t *p ) { return *p; }
+                    static void store( int32_t *p, reg v ) { *p = v; }
+                    static reg set1( int32_t v ) { return v; }
+                    static reg add( reg a, reg b ) { return (int32_t)( (uint32_t)a + (uint32_t)b ); }
+                    static reg sub( reg a, reg b ) { return (int32_t)( (uint32_t)a - (uint32_t)b ); }
+                    static reg mul( reg a, reg b ) { return (int32_t)( (uint32_t)a * (uint32_t)b ); }
+                    static reg min( reg a, reg b ) { return ( a < b ) ? a : b; }
+                    static reg max( reg a, reg b ) { return ( a > b ) ? a : b; }
+                    static reg fma( reg a, reg b, reg c ) { return add( mul( a, b ), c ); }
+                    static reg select_gt( reg a, reg t, reg low, reg high ) { return ( a > t ) ? high : low; }
+                    static int32_t reduce_min( reg v ) { return v; }
+                    static int32_t reduce_max( reg v ) { return v; }
+                    
+                    static wide wide_zero() { return 0; }
+                    static wide wide_add( wide acc, reg v ) { return acc + v; }
+                    static wide wide_load( const int64_t *p ) { return *p; }
+                    static void wide_store( int64_t *p, wide v ) { *p = v; }
+                    static sum_type wide_total( wide v ) { return v; }
+                };
+
+#include "vector2d_simd_kernels.hpp"
+            }
+            
+            /**
+             * Horizontal reductions of registers through memory, they are rare.
+             */
+            template <typename T, size_t N, typename Tfunc>
+            inline T reduce_lanes( const T ( &lanes )[N], Tfunc f )
+            {
+                T out = lanes[0];
+                for ( size_t i = 1; i < N; i++ )
+                {
+                    out = f( out, lanes[i] );
+                }
+                return out;
+            }
+            
+            template <typename T>
+            inline T min_of( T a, T b )
+            {
+                return ( a < b ) ? a : b;
+            }
+            
+            template <typename T>
+            inline T max_of( T a, T b )
+            {
+                return ( a > b ) ? a : b;
+            }
+
+#ifdef DS_VECTOR2D_SIMD_X86
+#ifdef __clang__
+#pragma clang attribute push( __attribute__(( target( "sse4.1" ) )), apply_to = function )
+#else
+#pragma GCC push_options
+#pragma GCC target( "sse4.1" )
+#endif /* __clang__ */
+            namespace sse41
+            {
+                struct f32
+                {
+                    using reg      = __m128;
+                    using sum_type = double;
+                    struct wide
+                    {
+                        __m128d lo;
+                        __m128d hi;
+                    };
+                    
+                    static constexpr size_t width = 4;
+                    
+                    static reg load( const float *p ) { return _mm_loadu_ps( p ); }
+                    static void store( float *p, reg v ) { _mm_storeu_ps( p, v ); }
+                    static reg set1( float v ) { return _mm_set1_ps( v ); }
+                    static reg add( reg a, reg b ) { return _mm_add_ps( a, b ); }
+                    static reg sub( reg a, reg b ) { return _mm_sub_ps( a, b ); }
+                    static reg mul( reg a, reg b ) { return _mm_mul_ps( a, b ); }
+                    static reg min( reg a, reg b ) { return _mm_min_ps( a, b ); }
+                    static reg max( reg a, reg b ) { return _mm_max_ps( a, b ); }
+                    static reg fma( reg a, reg b, reg c ) { return _mm_add_ps( _mm_mul_ps( a, b ), c ); }
+                    static reg select_gt( reg a, reg t, reg low, reg high )
+                    {
+                        return _mm_blendv_ps( low, high, _mm_cmpgt_ps( a, t ) );
+                    }
+                    static float reduce_min( reg v )
+                    {
+                        float lanes[4];
+                        _mm_storeu_ps( lanes, v );
+                        return reduce_lanes( lanes, min_of<float> );
+                    }
+                    static float reduce_max( reg v )
+                    {
+                        float lanes[4];
+                        _mm_storeu_ps( lanes, v );
+                        return reduce_lanes( lanes, max_of<float> );
+                    }
+                    
+                    static wide wide_zero() { return wide{ _mm_setzero_pd(), _mm_setzero_pd() }; }
+                    static wide wide_add( wide acc, reg v )
+                    {
+                        return wide{ _mm_add_pd( acc.lo, _mm_cvtps_pd( v ) ),
+                                     _mm_add_pd( acc.hi, _mm_cvtps_pd( _mm_movehl_ps( v, v ) ) ) };
+                    }
+                    static wide wide_load( const double *p ) { return wide{ _mm_loadu_pd( p ), _mm_loadu_pd( p + 2 ) }; }
+                    static void wide_store( double *p, wide v )
+                    {
+                        _mm_storeu_pd( p, v.lo );
+                        _mm_storeu_pd( p + 2, v.hi );
+                        return;
+                    }
+                    static sum_type wide_total( wide v )
+                    {
+                        double lanes[4];
+                        wide_store( lanes, v );
+                        return ( lanes[0] + lanes[1] ) + ( lanes[2] + lanes[3] );
+                    }
+                };
+                
+                struct i32
+                {
+                    using reg      = __m128i;
+                    using sum_type = int64_t;
+                    struct wide
+                    {
+                        __m128i lo;
+                        __m128i hi;
+                    };
+                    
+                    static constexpr size_t width = 4;
+                    
+                    static reg load( const int32_t *p ) { return _mm_loadu_si128( (const __m128i*)p ); }
+                    static void store( int32_t *p, reg v ) { _mm_storeu_si128( (__m128i*)p, v ); }
+                    static reg set1( int32_t v ) { return _mm_set1_epi32( v ); }
+                    static reg add( reg a, reg b ) { return _mm_add_epi32( a, b ); }
+                    static reg sub( reg a, reg b ) { return _mm_sub_epi32( a, b ); }
+                    static reg mul( reg a, reg b ) { return _mm_mullo_epi32( a, b ); }
+                    static reg min( reg a, reg b ) { return _mm_min_epi32( a, b ); }
+                    static reg max( reg a, reg b ) { return _mm_max_epi32( a, b ); }
+                    static reg fma( reg a, reg b, reg c ) { return _mm_add_epi32( _mm_mullo_epi32( a, b ), c ); }
+                    static reg select_gt( reg a, reg t, reg low, reg high )
+                    {
+                        return _mm_blendv_epi8( low, high, _mm_cmpgt_epi32( a, t ) );
+                    }
+                    static int32_t reduce_min( reg v )
+                    {
+                        int32_t lanes[4];
+                        store( lanes, v );
+                        return reduce_lanes( lanes, min_of<int32_t> );
+                    }
+                    static int32_t reduce_max( reg v )
+                    {
+                        int32_t lanes[4];
+                        store( lanes, v );
+                        return reduce_lanes( lanes, max_of<int32_t> );
+                    }
+                    
+                    static wide wide_zero() { return wide{ _mm_setzero_si128(), _mm_setzero_si128() }; }
+                    static wide wide_add( wide acc, reg v )
+                    {
+                        return wide{ _mm_add_epi64( acc.lo, _mm_cvtepi32_epi64( v ) ),
+                                     _mm_add_epi64( acc.hi, _mm_cvtepi32_epi64( _mm_srli_si128( v, 8 ) ) ) };
+                    }
+                    static wide wide_load( const int64_t *p )
+                    {
+                        return wide{ _mm_loadu_si128( (const __m128i*)p ), _mm_loadu_si128( (const __m128i*)( p + 2 ) ) };
+                    }
+                    static void wide_store( int64_t *p, wide v )
+                    {
+                        _mm_storeu_si128( (__m128i*)p, v.lo );
+                        _mm_storeu_si128( (__m128i*)( p + 2 ), v.hi );
+                        return;
+                    }
+                    static sum_type wide_total( wide v )
+                    {
+                        int64_t lanes[4];
+                        wide_store( lanes, v );
+                        return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+                    }
+                };
+
+#include "vector2d_simd_kernels.hpp"
+            }
+#ifdef __clang__
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif /* __clang__ */
+
+#ifdef __clang__
+#pragma clang attribute push( __attribute__(( target( "avx2,fma" ) )), apply_to = function )
+#else
+#pragma GCC push_options
+#pragma GCC target( "avx2,fma" )
+#endif /* __clang__ */
+            namespace avx2
+            {
+                struct f32
+                {
+                    using reg      = __m256;
+                    using sum_type = double;
+                    struct wide
+                    {
+                        __m256d lo;
+                        __m256d hi;
+                    };
+                    
+                    static constexpr size_t width = 8;
+                    
+                    static reg load( const float *p ) { return _mm256_loadu_ps( p ); }
+                    static void store( float *p, reg v ) { _mm256_storeu_ps( p, v ); }
+                    static reg set1( float v ) { return _mm256_set1_ps( v ); }
+                    static reg add( reg a, reg b ) { return _mm256_add_ps( a, b ); }
+                    static reg sub( reg a, reg b ) { return _mm256_sub_ps( a, b ); }
+                    static reg mul( reg a, reg b ) { return _mm256_mul_ps( a, b ); }
+                    static reg min( reg a, reg b ) { return _mm256_min_ps( a, b ); }
+                    static reg max( reg a, reg b ) { return _mm256_max_ps( a, b ); }
+                    static reg fma( reg a, reg b, reg c ) { return _mm256_fmadd_ps( a, b, c ); }
+                    static reg select_gt( reg a, reg t, reg low, reg high )
+                    {
+                        return _mm256_blendv_ps( low, high, _mm256_cmp_ps( a, t, _CMP_GT_OQ ) );
+                    }
+                    static float reduce_min( reg v )
+                    {
+                        float lanes[8];
+                        _mm256_storeu_ps( lanes, v );
+                        return reduce_lanes( lanes, min_of<float> );
+                    }
+                    static float reduce_max( reg v )
+                    {
+                        float lanes[8];
+                        _mm256_storeu_ps( lanes, v );
+                        return reduce_lanes( lanes, max_of<float> );
+                    }
+                    
+                    static wide wide_zero() { return wide{ _mm256_setzero_pd(), _mm256_setzero_pd() }; }
+                    static wide wide_add( wide acc, reg v )
+                    {
+                        return wide{ _mm256_add_pd( acc.lo, _mm256_cvtps_pd( _mm256_castps256_ps128( v ) ) ),
+                                     _mm256_add_pd( acc.hi, _mm256_cvtps_pd( _mm256_extractf128_ps( v, 1 ) ) ) };
+                    }
+                    static wide wide_load( const double *p ) { return wide{ _mm256_loadu_pd( p ), _mm256_loadu_pd( p + 4 ) }; }
+                    static void wide_store( double *p, wide v )
+                    {
+                        _mm256_storeu_pd( p, v.lo );
+                        _mm256_storeu_pd( p + 4, v.hi );
+                        return;
+                    }
+                    static sum_type wide_total( wide v )
+                    {
+                        double lanes[8];
+                        wide_store( lanes, v );
+                        return ( ( lanes[0] + lanes[1] ) + ( lanes[2] + lanes[3] ) ) +
+                               ( ( lanes[4] + lanes[5] ) + ( lanes[6] + lanes[7] ) );
+                    }
+                };
+                
+                struct i32
+                {
+                    using reg      = __m256i;
+                    using sum_type = int64_t;
+                    struct wide
+                    {
+                        __m256i lo;
+                        __m256i hi;
+                    };
+                    
+                    static constexpr size_t width = 8;
+                    
+                    static reg load( const int32_t *p ) { return _mm256_loadu_si256( (const __m256i*)p ); }
+                    static void store( int32_t *p, reg v ) { _mm256_storeu_si256( (__m256i*)p, v ); }
+                    static reg set1( int32_t v ) { return _mm256_set1_epi32( v ); }
+                    static reg add( reg a, reg b ) { return _mm256_add_epi32( a, b ); }
+                    static reg sub( reg a, reg b ) { return _mm256_sub_epi32( a, b ); }
+                    static reg mul( reg a, reg b ) { return _mm256_mullo_epi32( a, b ); }
+                    static reg min( reg a, reg b ) { return _mm256_min_epi32( a, b ); }
+                    static reg max( reg a, reg b ) { return _mm256_max_epi32( a, b ); }
+                    static reg fma( reg a, reg b, reg c ) { return _mm256_add_epi32( _mm256_mullo_epi32( a, b ), c ); }
+                    static reg select_gt( reg a, reg t, reg low, reg high )
+                    {
+                        return _mm256_blendv_epi8( low, high, _mm256_cmpgt_epi32( a, t ) );
+                    }
+                    static int32_t reduce_min( reg v )
+                    {
+                        int32_t lanes[8];
+                        store( lanes, v );
+                        return reduce_lanes( lanes, min_of<int32_t> );
+                    }
+                    static int32_t reduce_max( reg v )
+                    {
+                        int32_t lanes[8];
+                        store( lanes, v );
+                        return reduce_lanes( lanes, max_of<int32_t> );
+                    }
+                    
+                    static wide wide_zero() { return wide{ _mm256_setzero_si256(), _mm256_setzero_si256() }; }
+                    static wide wide_add( wide acc, reg v )
+                    {
+                        return wide{ _mm256_add_epi64( acc.lo, _mm256_cvtepi32_epi64( _mm256_castsi256_si128( v ) ) ),
+                                     _mm256_add_epi64( acc.hi, _mm256_cvtepi32_epi64( _mm256_extracti128_si256( v, 1 ) ) ) };
+                    }
+                    static wide wide_load( const int64_t *p )
+                    {
+                        return wide{ _mm256_loadu_si256( (const __m256i*)p ), _mm256_loadu_si256( (const __m256i*)( p + 4 ) ) };
+                    }
+                    static void wide_store( int64_t *p, wide v )
+                    {
+                        _mm256_storeu_si256( (__m256i*)p, v.lo );
+                        _mm256_storeu_si256( (__m256i*)( p + 4 ), v.hi );
+                        return;
+                    }
+                    static sum_type wide_total( wide v )
+                    {
+                        int64_t lanes[8];
+                        wide_store( lanes, v );
+                        return lanes[0] + lanes[1] + lanes[2] + lanes[3] + lanes[4] + lanes[5] + lanes[6] + lanes[7];
+                    }
+                };
+
+#include "vector2d_simd_kernels.hpp"
+            }
+#ifdef __clang__
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif /* __clang__ */
+#endif /* DS_VECTOR2D_SIMD_X86 */
+
+#ifdef DS_VECTOR2D_SIMD_NEON
+            namespace neon
+            {
+                struct f32
+                {
+                    using reg      = float32x4_t;
+                    using sum_type = double;
+                    struct wide
+                    {
+                        float64x2_t lo;
+                        float64x2_t hi;
+                    };
+                    
+                    static constexpr size_t width = 4;
+                    
+                    static reg load( const float *p ) { return vld1q_f32( p ); }
+                    static void store( float *p, reg v ) { vst1q_f32( p, v ); }
+                    static reg set1( float v ) { return vdupq_n_f32( v ); }
+                    static reg add( reg a, reg b ) { return vaddq_f32( a, b ); }
+                    static reg sub( reg a, reg b ) { return vsubq_f32( a, b ); }
+                    static reg mul( reg a, reg b ) { return vmulq_f32( a, b ); }
+                    static reg min( reg a, reg b ) { return vminq_f32( a, b ); }
+                    static reg max( reg a, reg b ) { return vmaxq_f32( a, b ); }
+                    static reg fma( reg a, reg b, reg c ) { return vfmaq_f32( c, a, b ); }
+                    static reg select_gt( reg a, reg t, reg low, reg high ) { return vbslq_f32( vcgtq_f32( a, t ), high, low ); }
+                    static float reduce_min( reg v ) { return vminvq_f32( v ); }
+                    static float reduce_max( reg v ) { return vmaxvq_f32( v ); }
+                    
+                    static wide wide_zero() { return wide{ vdupq_n_f64( 0.0 ), vdupq_n_f64( 0.0 ) }; }
+                    static wide wide_add( wide acc, reg v )
+                    {
+                        return wide{ vaddq_f64( acc.lo, vcvt_f64_f32( vget_low_f32( v ) ) ),
+                                     vaddq_f64( acc.hi, vcvt_high_f64_f32( v ) ) };
+                    }
+                    static wide wide_load( const double *p ) { return wide{ vld1q_f64( p ), vld1q_f64( p + 2 ) }; }
+                    static void wide_store( double *p, wide v )
+                    {
+                        vst1q_f64( p, v.lo );
+                        vst1q_f64( p + 2, v.hi );
+                        return;
+                    }
+                    static sum_type wide_total( wide v ) { return vaddvq_f64( v.lo ) + vaddvq_f64( v.hi ); }
+                };
+                
+                struct i32
+                {
+                    using reg      = int32x4_t;
+                    using sum_type = int64_t;
+                    struct wide
+                    {
+                        int64x2_t lo;
+                        int64x2_t hi;
+                    };
+                    
+                    static constexpr size_t width = 4;
+                    
+                    static reg load( const int32_t *p ) { return vld1q_s32( p ); }
+                    static void store( int32_t *p, reg v ) { vst1q_s32( p, v ); }
+                    static reg set1( int32_t v ) { return vdupq_n_s32( v ); }
+                    static reg add( reg a, reg b ) { return vaddq_s32( a, b ); }
+                    static reg sub( reg a, reg b ) { return vsubq_s32( a, b ); }
+                    static reg mul( reg a, reg b ) { return vmulq_s32( a, b ); }
+                    static reg min( reg a, reg b ) { return vminq_s32( a, b ); }
+                    static reg max( reg a, reg b ) { return vmaxq_s32( a, b ); }
+                    static reg fma( reg a, reg b, reg c ) { return vmlaq_s32( c, a, b ); }
+                    static reg select_gt( reg a, reg t, reg low, reg high ) { return vbslq_s32( vcgtq_s32( a, t ), high, low ); }
+                    static int32_t reduce_min( reg v ) { return vminvq_s32( v ); }
+                    static int32_t reduce_max( reg v ) { return vmaxvq_s32( v ); }
+                    
+                    static wide wide_zero() { return wide{ vdupq_n_s64( 0 ), vdupq_n_s64( 0 ) }; }
+                    static wide wide_add( wide acc, reg v )
+                    {
+                        return wide{ vaddq_s64( acc.lo, vmovl_s32( vget_low_s32( v ) ) ),
+                                     vaddq_s64( acc.hi, vmovl_high_s32( v ) ) };
+                    }
+                    static wide wide_load( const int64_t *p ) { return wide{ vld1q_s64( p ), vld1q_s64( p + 2 ) }; }
+                    static void wide_store( int64_t *p, wide v )
+                    {
+                        vst1q_s64( p, v.lo );
+                        vst1q_s64( p + 2, v.hi );
+                        return;
+                    }
+                    static sum_type wide_total( wide v ) { return vaddvq_s64( v.lo ) + vaddvq_s64( v.hi ); }
+                };
+
+#include "vector2d_simd_kernels.hpp"
+            }
+#endif /* DS_VECTOR2D_SIMD_NEON */
+            
+            inline bool is_supported( simd_isa isa )
+            {
+                switch ( isa )
+                {
+                case simd_isa::scalar:
+                    return true;
+#ifdef DS_VECTOR2D_SIMD_X86
+                case simd_isa::sse41:
+                    return __builtin_cpu_supports( "sse4.1" );
+                case simd_isa::avx2:
+                    return ( __builtin_cpu_supports( "avx2" ) && __builtin_cpu_supports( "fma" ) );
+#endif /* DS_VECTOR2D_SIMD_X86 */
+#ifdef DS_VECTOR2D_SIMD_NEON
+                case simd_isa::neon:
+                    return true;
+#endif /* DS_VECTOR2D_SIMD_NEON */
+                default:
+                    return false;
+                }
+            }
+            
+            inline simd_isa detect()
+            {
+#ifdef DS_VECTOR2D_SIMD_X86
+                // can be called by static initializer before CPU model is filled in
+                __builtin_cpu_init();
+#endif /* DS_VECTOR2D_SIMD_X86 */
+                const simd_isa by_preference[] = { simd_isa::avx2, simd_isa::neon, simd_isa::sse41 };
+                for ( auto isa : by_preference )
+                {
+                    if ( is_supported( isa ) )
+                    {
+                        return isa;
+                    }
+                }
+                return simd_isa::scalar;
+            }
+            
+            inline std::atomic<simd_isa>& active()
+            {
+                static std::atomic<simd_isa> isa( detect() );
+                return isa;
+            }
+            
+            /**
+             * Calls f( kernels of T ) for active instruction set.
+             */
+            template <typename T, typename Tfunc>
+            inline auto dispatch( Tfunc f )
+            {
+                static_assert( std::is_same<T,float>::value || std::is_same<T,int32_t>::value,
+                               "SIMD operations are defined for float and int32_t" );
+                switch ( active().load( std::memory_order_relaxed ) )
+                {
+#ifdef DS_VECTOR2D_SIMD_X86
+                case simd_isa::avx2:
+                    return f( avx2::kernels<T>() );
+                case simd_isa::sse41:
+                    return f( sse41::kernels<T>() );
+#endif /* DS_VECTOR2D_SIMD_X86 */
+#ifdef DS_VECTOR2D_SIMD_NEON
+                case simd_isa::neon:
+                    return f( neon::kernels<T>() );
+#endif /* DS_VECTOR2D_SIMD_NEON */
+                default:
+                    return f( scalar::kernels<T>() );
+                }
+            }
+            
+            template <typename T>
+            inline void check_same_size( const vector2d<T>& a, const vector2d<T>& b )
+            {
+                if ( a.size() != b.size() )
+                {
+                    throw std::invalid_argument( "size " + (std::string)b.size() + " differs from size " +
+                                                 (std::string)a.size() );
+                }
+                return;
+            }
+            
+            template <typename T>
+            inline void check_not_empty( const vector2d<T>& a )
+            {
+                if ( 0 == a.size().x || 0 == a.size().y )
+                {
+                    throw std::invalid_argument( "vector2d of size " + (std::string)a.size() + " is empty" );
+                }
+                return;
+            }
+            
+            template <typename T>
+            inline size_t count( const vector2d<T>& a )
+            {
+                return (size_t)a.size().x * (size_t)a.size().y;
+            }
+            
+            template <binary_op Op, typename T>
+            inline void binary( const vector2d<T>& a, const vector2d<T>& b, vector2d<T>& out )
+            {
+                check_same_size( a, b );
+                check_same_size( a, out );
+                dispatch<T>( [&]( auto k )
+                             {
+                                 k.template binary<Op>( a.data(), b.data(), out.data(), count( a ) );
+                             } );
+                return;
+            }
+            
+            template <binary_op Op, typename T>
+            inline std::vector<T> by_rows( const vector2d<T>& a )
+            {
+                check_not_empty( a );
+                std::vector<T> out( a.size().y );
+                dispatch<T>( [&]( auto k )
+                             {
+                                 for ( int32_t y = 0; y < a.size().y; y++ )
+                                 {
+                                     out[y] = k.template extremum<Op>( a.row_unchecked( y ).data(), a.size().x );
+                                 }
+                             } );
+                return out;
+            }
+            
+            template <binary_op Op, typename T>
+            inline std::vector<T> by_columns( const vector2d<T>& a )
+            {
+                check_not_empty( a );
+                const auto first_row = a.row_unchecked( 0 );
+                std::vector<T> out( first_row.begin(), first_row.end() );
+                dispatch<T>( [&]( auto k )
+                             {
+                                 for ( int32_t y = 1; y < a.size().y; y++ )
+                                 {
+                                     k.template binary<Op>( out.data(), a.row_unchecked( y ).data(), out.data(),
+                                                            out.size() );
+                                 }
+                             } );
+                return out;
+            }
+        }
+        
+        /********************************************************************************/
+        
+        /**
+         * Best instruction set of this CPU.
+         */
+        inline simd_isa detect_simd_isa()
+        {
+            return simd_detail::detect();
+        }
+        
+        /**
+         * Instruction set used by operations.
+         */
+        inline simd_isa active_simd_isa()
+        {
+            return simd_detail::active().load( std::memory_order_relaxed );
+        }
+        
+        /**
+         * Makes operations use isa, throws std::invalid_argument if CPU doesn't support it.
+         */
+        inline void set_simd_isa( simd_isa isa )
+        {
+            if ( !simd_detail::is_supported( isa ) )
+            {
+                throw std::invalid_argument( std::string( "instruction set " ) + simd_isa_name( isa ) +
+                                             " is not supported" );
+            }
+            simd_detail::active().store( isa, std::memory_order_relaxed );
+            return;
+        }
+        
+        /********************************************************************************/
+        
+        template <typename T>
+        void add( const vector2d<T>& a, const vector2d<T>& b, vector2d<T>& out )
+        {
+            simd_detail::binary<simd_detail::binary_op::add>( a, b, out );
+            return;
+        }
+        
+        template <typename T>
+        void subtract( const vector2d<T>& a, const vector2d<T>& b, vector2d<T>& out )
+        {
+            simd_detail::binary<simd_detail::binary_op::sub>( a, b, out );
+            return;
+        }
+        
+        template <typename T>
+        void multiply( const vector2d<T>& a, const vector2d<T>& b, vector2d<T>& out )
+        {
+            simd_detail::binary<simd_detail::binary_op::mul>( a, b, out );
+            return;
+        }
+        
+        template <typename T>
+        void elementwise_min( const vector2d<T>& a, const vector2d<T>& b, vector2d<T>& out )
+        {
+            simd_detail::binary<simd_detail::binary_op::min>( a, b, out );
+            return;
+        }
+        
+        template <typename T>
+        void elementwise_max( const vector2d<T>& a, const vector2d<T>& b, vector2d<T>& out )
+        {
+            simd_detail::binary<simd_detail::binary_op::max>( a, b, out );
+            return;
+        }
+        
+        /**
+         * out = a * s.
+         */
+        template <typename T>
+        void scale( const vector2d<T>& a, T s, vector2d<T>& out )
+        {
+            simd_detail::check_same_size( a, out );
+            simd_detail::dispatch<T>( [&]( auto k )
+                                      {
+                                          k.scale( a.data(), s, out.data(), simd_detail::count( a ) );
+                                      } );
+            return;
+        }
+        
+        /**
+         * out = a * b + c.
+         */
+        template <typename T>
+        void fma( const vector2d<T>& a, const vector2d<T>& b, const vector2d<T>& c, vector2d<T>& out )
+        {
+            simd_detail::check_same_size( a, b );
+            simd_detail::check_same_size( a, c );
+            simd_detail::check_same_size( a, out );
+            simd_detail::dispatch<T>( [&]( auto k )
+                                      {
+                                          k.fma( a.data(), b.data(), c.data(), out.data(), simd_detail::count( a ) );
+                                      } );
+            return;
+        }
+        
+        /**
+         * out = ( a > t ) ? high : low.
+         */
+        template <typename T>
+        void threshold( const vector2d<T>& a, T t, T low, T high, vector2d<T>& out )
+        {
+            simd_detail::check_same_size( a, out );
+            simd_detail::dispatch<T>( [&]( auto k )
+                                      {
+                                          k.threshold( a.data(), t, low, high, out.data(), simd_detail::count( a ) );
+                                      } );
+            return;
+        }
+        
+        /********************************************************************************/
+        
+        /**
+         * Sum of all elements, double for float and int64_t for int32_t.
+         */
+        template <typename T>
+        auto sum( const vector2d<T>& a )
+        {
+            return simd_detail::dispatch<T>( [&]( auto k )
+                                             {
+                                                 return k.sum( a.data(), simd_detail::count( a ) );
+                                             } );
+        }
+        
+        /**
+         * Minimum of all elements, throws std::invalid_argument if a is empty.
+         */
+        template <typename T>
+        T min_value( const vector2d<T>& a )
+        {
+            simd_detail::check_not_empty( a );
+            return simd_detail::dispatch<T>( [&]( auto k )
+                                             {
+                                                 return k.template extremum<simd_detail::binary_op::min>(
+                                                     a.data(), simd_detail::count( a ) );
+                                             } );
+        }
+        
+        template <typename T>
+        T max_value( const vector2d<T>& a )
+        {
+            simd_detail::check_not_empty( a );
+            return simd_detail::dispatch<T>( [&]( auto k )
+                                             {
+                                                 return k.template extremum<simd_detail::binary_op::max>(
+                                                     a.data(), simd_detail::count( a ) );
+                                             } );
+        }
+        
+        /**
+         * Sums of rows, element y is sum of row y.
+         */
+        template <typename T>
+        auto row_sums( const vector2d<T>& a )
+        {
+            return simd_detail::dispatch<T>( [&]( auto k )
+                                             {
+                                                 std::vector<typename decltype( k )::sum_type> out( a.size().y );
+                                                 for ( int32_t y = 0; y < a.size().y; y++ )
+                                                 {
+                                                     out[y] = k.sum( a.row_unchecked( y ).data(), a.size().x );
+                                                 }
+                                                 return out;
+                                             } );
+        }
+        
+        /**
+         * Sums of columns, element x is sum of column x. Rows are added to sums
+         * one by one, so columns are summed by registers too.
+         */
+        template <typename T>
+        auto column_sums( const vector2d<T>& a )
+        {
+            return simd_detail::dispatch<T>( [&]( auto k )
+                                             {
+                                                 std::vector<typename decltype( k )::sum_type> out( a.size().x );
+                                                 for ( int32_t y = 0; y < a.size().y; y++ )
+                                                 {
+                                                     k.accumulate( a.row_unchecked( y ).data(), out.data(), out.size() );
+                                                 }
+                                                 return out;
+                                             } );
+        }
+        
+        template <typename T>
+        std::vector<T> row_min( const vector2d<T>& a )
+        {
+            return simd_detail::by_rows<simd_detail::binary_op::min>( a );
+        }
+        
+        template <typename T>
+        std::vector<T> row_max( const vector2d<T>& a )
+        {
+            return simd_detail::by_rows<simd_detail::binary_op::max>( a );
+        }
+        
+        template <typename T>
+        std::vector<T> column_min( const vector2d<T>& a )
+        {
+            return simd_detail::by_columns<simd_detail::binary_op::min>( a );
+        }
+        
+        template <typename T>
+        std::vector<T> column_max( const vector2d<T>& a )
+        {
+            return simd_detail::by_columns<simd_detail::binary_op::max>( a );
+        }
+        
+        /********************************************************************************/
+    }
+}
+
+/****************************************************************************************/
@@ -0,0 +1,185 @@
+/**
+ * Generic kernels of vector2d_simd.hpp.
+ */
+
+/****************************************************************************************/
+
+/**
+ * Is included by vector2d_simd.hpp once per instruction set, inside namespace of
+ * the set and under its target options, so kernels are compiled for every set.
+ * Namespace of inclusion should have traits f32 and i32 of vector registers,
+ * tails shorter than register are counted by scalar traits.
+ * So this file has no include guard and no includes.
+ */
+
+/****************************************************************************************/
+
+template <typename T> struct traits_of;
+
+template <>
+struct traits_of<float>
+{
+    using type = f32;
+};
+
+template <>
+struct traits_of<int32_t>
+{
+    using type = i32;
+};
+
+/**
+ * Kernels over contiguous arrays of n elements.
+ * Output can be the same array as any input.
+ */
+template <typename T>
+struct kernels
+{
+    using tr       = typename traits_of<T>::type;
+    using sc       = typename ::ds::vector2d::simd_detail::scalar::traits_of<T>::type;
+    using reg      = typename tr::reg;
+    using sum_type = typename tr::sum_type;
+    
+    static constexpr size_t W = tr::width;
+    
+    template <typename Ttraits, binary_op Op>
+    static typename Ttraits::reg apply( typename Ttraits::reg a, typename Ttraits::reg b )
+    {
+        if constexpr ( binary_op::add == Op )
+        {
+            return Ttraits::add( a, b );
+        } else if constexpr ( binary_op::sub == Op )
+        {
+            return Ttraits::sub( a, b );
+        } else if constexpr ( binary_op::mul == Op )
+        {
+            return Ttraits::mul( a, b );
+        } else if constexpr ( binary_op::min == Op )
+        {
+            return Ttraits::min( a, b );
+        } else
+        {
+            return Ttraits::max( a, b );
+        }
+    }
+    
+    template <binary_op Op>
+    static void binary( const T *a_p, const T *b_p, T *out_p, size_t n )
+    {
+        size_t i = 0;
+        for ( ; i + W <= n; i += W )
+        {
+            tr::store( out_p + i, apply<tr,Op>( tr::load( a_p + i ), tr::load( b_p + i ) ) );
+        }
+        for ( ; i < n; i++ )
+        {
+            out_p[i] = apply<sc,Op>( a_p[i], b_p[i] );
+        }
+        return;
+    }
+    
+    static void scale( const T *a_p, T s, T *out_p, size_t n )
+    {
+        const reg vs = tr::set1( s );
+        size_t i = 0;
+        for ( ; i + W <= n; i += W )
+        {
+            tr::store( out_p + i, tr::mul( tr::load( a_p + i ), vs ) );
+        }
+        for ( ; i < n; i++ )
+        {
+            out_p[i] = sc::mul( a_p[i], s );
+        }
+        return;
+    }
+    
+    static void fma( const T *a_p, const T *b_p, const T *c_p, T *out_p, size_t n )
+    {
+        size_t i = 0;
+        for ( ; i + W <= n; i += W )
+        {
+            tr::store( out_p + i, tr::fma( tr::load( a_p + i ), tr::load( b_p + i ), tr::load( c_p + i ) ) );
+        }
+        for ( ; i < n; i++ )
+        {
+            out_p[i] = sc::fma( a_p[i], b_p[i], c_p[i] );
+        }
+        return;
+    }
+    
+    static void threshold( const T *a_p, T t, T low, T high, T *out_p, size_t n )
+    {
+        const reg vt    = tr::set1( t );
+        const reg vlow  = tr::set1( low );
+        const reg vhigh = tr::set1( high );
+        size_t i = 0;
+        for ( ; i + W <= n; i += W )
+        {
+            tr::store( out_p + i, tr::select_gt( tr::load( a_p + i ), vt, vlow, vhigh ) );
+        }
+        for ( ; i < n; i++ )
+        {
+            out_p[i] = sc::select_gt( a_p[i], t, low, high );
+        }
+        return;
+    }
+    
+    static sum_type sum( const T *a_p, size_t n )
+    {
+        typename tr::wide acc = tr::wide_zero();
+        size_t i = 0;
+        for ( ; i + W <= n; i += W )
+        {
+            acc = tr::wide_add( acc, tr::load( a_p + i ) );
+        }
+        sum_type out = tr::wide_total( acc );
+        for ( ; i < n; i++ )
+        {
+            out = sc::wide_add( out, a_p[i] );
+        }
+        return out;
+    }
+    
+    /**
+     * acc[i] += a[i] for n elements, acc is array of sums.
+     */
+    static void accumulate( const T *a_p, sum_type *acc_p, size_t n )
+    {
+        size_t i = 0;
+        for ( ; i + W <= n; i += W )
+        {
+            tr::wide_store( acc_p + i, tr::wide_add( tr::wide_load( acc_p + i ), tr::load( a_p + i ) ) );
+        }
+        for ( ; i < n; i++ )
+        {
+            acc_p[i] = sc::wide_add( acc_p[i], a_p[i] );
+        }
+        return;
+    }
+    
+    /**
+     * Minimum or maximum of n > 0 elements.
+     */
+    template <binary_op Op>
+    static T extremum( const T *a_p, size_t n )
+    {
+        size_t i = 0;
+        T out = a_p[0];
+        if ( n >= W )
+        {
+            reg acc = tr::load( a_p );
+            for ( i = W; i + W <= n; i += W )
+            {
+                acc = apply<tr,Op>( acc, tr::load( a_p + i ) );
+            }
+            out = ( binary_op::min == Op ) ? tr::reduce_min( acc ) : tr::reduce_max( acc );
+        }
+        for ( ; i < n; i++ )
+        {
+            out = apply<sc,Op>( out, a_p[i] );
+        }
+        return out;
+    }
+};
+
+/****************************************************************************************/
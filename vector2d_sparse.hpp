@@ -0,0 +1,327 @@
+/**
+ * Sparse 2d vector.
+ */
+#pragma once
+
+/****************************************************************************************/
+
+/**
+ * sparse_vector2d is grid of size up to 2^31 x 2^31 cells, which keeps only
+ * tiles of TileX x TileY cells that were written. Tile is allocated on first
+ * write to any of its cells and is filled with default value, reads of cells
+ * of other tiles give default value without allocation. So memory is
+ * proportional to number of touched tiles, not to size of grid.
+ *
+ * Indexing is by point2d as of vector2d: operator() checks index and throws
+ * std::out_of_range. Non-const operator() and set() are writes and allocate
+ * tile, get() and const operator() are reads and don't. Indices of tiles
+ * and cells are 64-bit, so there is no overflow for any size.
+ *
+ * Usage:
+ *      ds::vector2d::sparse_vector2d<float> world( 1000000, 1000000 );
+ *      world( 123456, 654321 ) = 1.0f;
+ *      float height = world.get( ds::vector2d::point2d( 5, 5 ) ); // 0.0f, no tile
+ */
+
+/****************************************************************************************/
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <string>
+#include <stdexcept>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "vector2d.hpp"
+
+/****************************************************************************************/
+
+namespace ds
+{
+    namespace vector2d
+    {
+        /********************************************************************************/
+        
+        template <typename T, int32_t TileX = 64, int32_t TileY = TileX>
+        class sparse_vector2d
+        {
+            static_assert( TileX > 0 && 0 == ( TileX & ( TileX - 1 ) ), "tile width should be power of 2" );
+            static_assert( TileY > 0 && 0 == ( TileY & ( TileY - 1 ) ), "tile height should be power of 2" );
+        
+        public:
+            static constexpr int32_t tile_x = TileX;
+            static constexpr int32_t tile_y = TileY;
+            static constexpr size_t  tile_elements = (size_t)TileX * (size_t)TileY;
+            
+            /*****************************************************************************
+                                                Data
+            *****************************************************************************/
+        private:
+            using tile_type = std::unique_ptr<T[]>;
+            
+            point2d m_size;
+            T       m_default;
+            
+            std::unordered_map<uint64_t, tile_type> m_tiles;
+            
+            // last written tile, writes mostly go to the same tile
+            uint64_t  m_last_key    = 0;
+            T        *m_last_tile_p = nullptr;
+            
+            /*****************************************************************************
+                                             Inner methods
+            *****************************************************************************/
+        private:
+            bool CheckIndex( const point2d& pos ) const
+            {
+                if ( pos.x >= m_size.x || pos.y >= m_size.y || pos.x < 0 || pos.y < 0 )
+                {
+                    return false;
+                }
+                return true;
+            }
+            
+            void CheckIndexThrow( const point2d& pos ) const
+            {
+                if ( !CheckIndex( pos ) )
+                {
+                    throw std::out_of_range( "index " + (std::string)pos + " is out of size " + (std::string)m_size );
+                }
+                return;
+            }
+            
+            static uint64_t TileKey( const point2d& pos )
+            {
+                return ( (uint64_t)( (uint32_t)pos.y / TileY ) << 32 ) | ( (uint32_t)pos.x / TileX );
+            }
+            
+            static size_t CellIndex( const point2d& pos )
+            {
+                return (size_t)( (uint32_t)pos.y % TileY ) * TileX + (uint32_t)pos.x % TileX;
+            }
+            
+            static point2d TileOrigin( uint64_t key )
+            {
+                return point2d( (int32_t)( ( key & 0xFFFFFFFFull ) * TileX ), (int32_t)( ( key >> 32 ) * TileY ) );
+            }
+            
+            T* FindTile( uint64_t key ) const
+            {
+                auto found = m_tiles.find( key );
+                return ( found == m_tiles.end() ) ? nullptr : found->second.get();
+            }
+            
+            T* TileForWrite( uint64_t key )
+            {
+                if ( nullptr != m_last_tile_p && key == m_last_key )
+                {
+                    return m_last_tile_p;
+                }
+                tile_type &slot = m_tiles[key];
+                if ( !slot )
+                {
+                    slot.reset( new T[tile_elements] );
+                    std::fill( slot.get(), slot.get() + tile_elements, m_default );
+                }
+                m_last_key    = key;
+                m_last_tile_p = slot.get();
+                return m_last_tile_p;
+            }
+            
+            template <typename Tself, typename Tfunc>
+            static void ForEach( Tself& self, Tfunc& f )
+            {
+                for ( auto& cur_tile : self.m_tiles )
+                {
+                    const point2d origin = TileOrigin( cur_tile.first );
+                    const int32_t y_end = (int32_t)std::min<int64_t>( (int64_t)origin.y + TileY, self.m_size.y );
+                    const int32_t x_end = (int32_t)std::min<int64_t>( (int64_t)origin.x + TileX, self.m_size.x );
+                    for ( int32_t y = origin.y; y < y_end; y++ )
+                    {
+                        using value_type = typename std::conditional<std::is_const<Tself>::value, const T, T>::type;
+                        value_type *row_p = cur_tile.second.get() + (size_t)( y - origin.y ) * TileX;
+                        for ( int32_t x = origin.x; x < x_end; x++ )
+                        {
+                            f( point2d( x, y ), row_p[x - origin.x] );
+                        }
+                    }
+                }
+                return;
+            }
+            
+            /*****************************************************************************
+                                          Public interface
+            *****************************************************************************/
+        public:
+            explicit sparse_vector2d( const point2d& new_size, const T& default_value = T() )
+                : m_size( new_size ), m_default( default_value )
+            {
+                if ( new_size.x < 0 || new_size.y < 0 )
+                {
+                    throw std::out_of_range( "size " + (std::string)new_size + " has parts < 0" );
+                }
+            }
+            sparse_vector2d( int32_t x, int32_t y, const T& default_value = T() )
+                : sparse_vector2d( point2d( x, y ), default_value ) {}
+            
+            sparse_vector2d( const sparse_vector2d& other )
+                : m_size( other.m_size ), m_default( other.m_default )
+            {
+                m_tiles.reserve( other.m_tiles.size() );
+                for ( const auto& cur_tile : other.m_tiles )
+                {
+                    tile_type copy( new T[tile_elements] );
+                    std::copy( cur_tile.second.get(), cur_tile.second.get() + tile_elements, copy.get() );
+                    m_tiles.emplace( cur_tile.first, std::move( copy ) );
+                }
+            }
+            
+            sparse_vector2d( sparse_vector2d&& other )
+                : m_size( other.m_size ), m_default( std::move( other.m_default ) ), m_tiles( std::move( other.m_tiles ) )
+            {
+                other.m_tiles.clear();
+                other.m_last_tile_p = nullptr;
+            }
+            
+            sparse_vector2d& operator=( sparse_vector2d other )
+            {
+                std::swap( m_size, other.m_size );
+                std::swap( m_default, other.m_default );
+                m_tiles.swap( other.m_tiles );
+                m_last_tile_p = nullptr;
+                return *this;
+            }
+            
+            point2d size() const
+            {
+                return m_size;
+            }
+            
+            const T& default_value() const
+            {
+                return m_default;
+            }
+            
+            /**
+             * Read: value of cell or default value if its tile was not written.
+             */
+            const T& get( const point2d& pos ) const
+            {
+                CheckIndexThrow( pos );
+                const T *tile_p = FindTile( TileKey( pos ) );
+                return ( nullptr == tile_p ) ? m_default : tile_p[ CellIndex( pos ) ];
+            }
+            
+            T operator() ( const point2d& pos ) const
+            {
+                return get( pos );
+            }
+            
+            T operator() ( int32_t x, int32_t y ) const
+            {
+                return get( point2d( x, y ) );
+            }
+            
+            /**
+             * Write access: allocates tile of pos if it is not allocated.
+             */
+            T& operator() ( const point2d& pos )
+            {
+                CheckIndexThrow( pos );
+                return TileForWrite( TileKey( pos ) )[ CellIndex( pos ) ];
+            }
+            
+            T& operator() ( int32_t x, int32_t y )
+            {
+                return ( *this )( point2d( x, y ) );
+            }
+            
+            void set( const point2d& pos, const T& value )
+            {
+                ( *this )( pos ) = value;
+                return;
+            }
+            
+            /**
+             * Tile of pos is allocated.
+             */
+            bool contains( const point2d& pos ) const
+            {
+                return ( CheckIndex( pos ) && nullptr != FindTile( TileKey( pos ) ) );
+            }
+            
+            /**
+             * Number of allocated tiles.
+             */
+            size_t tile_count() const
+            {
+                return m_tiles.size();
+            }
+            
+            /**
+             * Calls f( const point2d& pos, T& value ) for every cell of allocated
+             * tiles inside size, tiles go in no particular order.
+             */
+            template <typename Tfunc>
+            void for_each( Tfunc f )
+            {
+                ForEach( *this, f );
+                return;
+            }
+            
+            template <typename Tfunc>
+            void for_each( Tfunc f ) const
+            {
+                ForEach( *this, f );
+                return;
+            }
+            
+            /**
+             * Frees tiles which have only default values.
+             * Returns: number of freed tiles.
+             */
+            size_t compact()
+            {
+                size_t num_freed = 0;
+                for ( auto cur = m_tiles.begin(); cur != m_tiles.end(); )
+                {
+                    const T *tile_p = cur->second.get();
+                    bool is_default = true;
+                    for ( size_t i = 0; i < tile_elements && is_default; i++ )
+                    {
+                        is_default = ( tile_p[i] == m_default );
+                    }
+                    if ( is_default )
+                    {
+                        cur = m_tiles.erase( cur );
+                        num_freed++;
+                    } else
+                    {
+                        ++cur;
+                    }
+                }
+                m_last_tile_p = nullptr;
+                return num_freed;
+            }
+            
+            /**
+             * Frees all tiles, so every cell has default value.
+             */
+            void clear()
+            {
+                m_tiles.clear();
+                m_last_tile_p = nullptr;
+                return;
+            }
+        };
+        
+        /********************************************************************************/
+    }
+}
+
+/****************************************************************************************/